@@ -21,6 +21,10 @@ class AbstractIO : private NoHeap {
     
         T stream;
 
+        /// Leaves the stream closed.
+        /// For derived classes that can operate without a file.
+        AbstractIO() = default;
+
         AbstractIO(const PGE::FilePath& file, std::ios::openmode mode = std::ios::binary) {
             PGE_ASSERT(file.isValid(), INVALID_FILEPATH);
             stream.open(file.str().cstr(), mode);
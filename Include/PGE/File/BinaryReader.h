@@ -1,16 +1,18 @@
 #ifndef PGE_BINARY_READER_H_INCLUDED
 #define PGE_BINARY_READER_H_INCLUDED
 
+#include <cstring>
+
 #include <PGE/File/AbstractIO.h>
 
 namespace PGE {
 
-/// Utility to read binary data from a file.
+/// Utility to read binary data from a file or a block of memory.
 /// 
 /// In order to expand the capabilities of BinaryReader the generic tryRead method can be partially specialized
 /// with the type(s) you wish to support. It's recommended to closely adhere to the specification and do things
-/// as they're done in the library. You have access to a `stream` member, from which all your data is to be read.\n
-/// If the stream turns bad at any point during the reading process (`stream.good()` returns false), the method should return false.
+/// as they're done in the library. You have access to a `readRaw` method, from which all your data is to be read.\n
+/// If reading fails at any point during the reading process (`readRaw` returns false), the method should return false.
 /// Specializations for other types can utilize preexisting specializations (e.g. a Vector2f is read by calling `read<float>` twice).\n
 /// It is recommended to also provide a specialization for writing, if one is provided for reading.\n
 /// Variation of functionality of existing types can be achieved by providing a thin wrapper around the object you wish to handle differently.
@@ -19,14 +21,47 @@ namespace PGE {
 /// @see #PGE::BinaryWriter
 /// @see #PGE::TextWriter
 class BinaryReader : private AbstractIO<std::ifstream> {
-    public:
-        using AbstractIO::earlyClose;
+    private:
+        bool inMemory = false;
+        const byte* memoryPosition = nullptr;
+        const byte* memoryEnd = nullptr;
+        bool memoryEndReached = false;
 
+    protected:
+        /// Reads raw bytes, either from the file or from memory.
+        /// Reading from memory never touches the stream.
+        /// @returns Whether all bytes could be read.
+        bool readRaw(void* out, size_t size) {
+            if (inMemory) {
+                if (size > (size_t)(memoryEnd - memoryPosition)) {
+                    memoryPosition = memoryEnd;
+                    memoryEndReached = true;
+                    return false;
+                }
+                memcpy(out, memoryPosition, size);
+                memoryPosition += size;
+                return true;
+            }
+            stream.read((char*)out, size);
+            return stream.good();
+        }
+
+    public:
         /// Opens the file handle.
         /// @throws #PGE::Exception if the path is invalid or the file could not be opened.
         BinaryReader(const FilePath& file);
 
-        /// Whether a previous operation has attempted to read past the end of the file.
+        /// Reads from a block of memory.
+        /// The memory is not copied, it has to outlive the reader.
+        BinaryReader(const byte* data, size_t size);
+
+        /// @see #PGE::AbstractIO::earlyClose
+        void earlyClose();
+
+        /// Whether the reader operates on memory, as opposed to a file.
+        bool isInMemory() const;
+
+        /// Whether a previous operation has attempted to read past the end of the file or memory block.
         /// @see https://en.cppreference.com/w/cpp/io/basic_ios/eof
         bool endOfFile() const;
 
@@ -71,6 +106,10 @@ class BinaryReader : private AbstractIO<std::ifstream> {
         /// The vector is cleared, but not shrunken.
         /// @see #tryRead
         bool tryReadBytes(size_t count, std::vector<byte>& out);
+        /// Tries to read a specified amount of bytes into memory owned by the caller.
+        /// Adheres to the #tryRead specification.
+        /// @see #tryRead
+        bool tryReadBytes(size_t count, byte* out);
         /// Reads a specified amount of bytes.
         /// Adheres to the #read specification.
         /// @see #read
@@ -5,12 +5,12 @@
 
 namespace PGE {
 
-/// Utility to write binary data to a file.
+/// Utility to write binary data to a file or a growable block of memory.
 /// 
 /// In order to expand the capabilities of BinaryWriter the generic write method can be partially specialized
 /// with the type(s) you wish to support. It's recommended to closely adhere to the specification and do things
-/// as they're done in the library. You have access to a `stream` member, to which all your data is to be written. After
-/// writing has concluded it is recommended to call the protected `validate` method in order to do proper error handling.
+/// as they're done in the library. You have access to a `writeRaw` method, to which all your data is to be written.
+/// It takes care of error handling.
 /// Specializations for other types can utilize preexisting specializations (e.g. a Vector2f is written by calling `write<float>` twice).\n
 /// It is recommended to also provide a specialization for reading, if one is provided for writing.\n
 /// Variation of functionality of existing types can be achieved by providing a thin wrapper around the object you wish to handle differently.
@@ -20,8 +20,7 @@ namespace PGE {
 /// struct FixedLengthString { const String& str; };
 /// template<> void BinaryWriter::write<FixedLengthString>(const FixedLengthString& val) {
 ///     // Regular String writer uses byteLength() + 1 to include the terminating null byte.
-///     stream.write(val.str.cstr(), val.str.byteLength());
-///     validate();
+///     writeRaw(val.str.cstr(), val.str.byteLength());
 /// }
 /// // ...
 /// myBinaryWriter.write<FixedLengthString>({ "asd" });
@@ -30,16 +29,53 @@ namespace PGE {
 /// @see #PGE::TextWriter
 class BinaryWriter : private AbstractIO<std::ofstream> {
     private:
+        bool inMemory = false;
+        std::vector<byte> memory;
 
-    public:
-        using AbstractIO::earlyClose;
+    protected:
+        /// Writes raw bytes, either to the file or to memory.
+        /// Writing to memory never touches the stream.
+        /// @throws #PGE::Exception If writing to the file failed.
+        void writeRaw(const void* data, size_t size) {
+            if (inMemory) {
+                memory.insert(memory.end(), (const byte*)data, (const byte*)data + size);
+                return;
+            }
+            stream.write((const char*)data, size);
+            validate();
+        }
 
+    public:
         /// Opens the stream.
         /// @param[in] file The file to write to.
         /// @param[in] append Whether data should be appended to the file or it should be overwritten.
         /// @throws #PGE::Exception if the path is invalid or the file could not be opened.
         BinaryWriter(const FilePath& file, bool append = false);
 
+        /// Writes to a growable block of memory.
+        /// @see #release
+        BinaryWriter();
+
+        /// @see #PGE::AbstractIO::earlyClose
+        void earlyClose();
+
+        /// Whether the writer operates on memory, as opposed to a file.
+        bool isInMemory() const;
+
+        /// Reserves space for at least the given amount of bytes in total, avoiding reallocations while writing.
+        /// Only has an effect when writing to memory.
+        void reserve(size_t size);
+
+        /// The bytes written so far, when writing to memory.
+        /// Invalidated by any further write.
+        const byte* getData() const;
+        size_t getSize() const;
+
+        /// Takes the written bytes, without copying them.
+        /// The writer is empty afterwards and can be reused.
+        /// @throws #PGE::Exception If the writer doesn't write to memory.
+        const std::vector<byte> release();
+
         /// Writes a type T to file.
         /// By default the following types are supported:
         /// - Self explanatory: u8, u16, u32, u64, i8, i16, i32, i64, float, double, long double
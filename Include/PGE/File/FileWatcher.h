@@ -0,0 +1,85 @@
+#ifndef PGE_FILEWATCHER_H_INCLUDED
+#define PGE_FILEWATCHER_H_INCLUDED
+
+#include <unordered_map>
+#include <unordered_set>
+#include <chrono>
+
+#include <PGE/File/FilePath.h>
+#include <PGE/String/Key.h>
+#include <PGE/ResourceManagement/NoHeap.h>
+
+namespace PGE {
+
+/// Detects modifications of files on disk.
+///
+/// On Linux changes are reported by inotify, so an idle watcher costs a single non-blocking read per #update.
+/// Everywhere else, or if inotify is unavailable, the modification times of all watched files are polled,
+/// at most once per polling interval.
+///
+/// Changes are batched: everything that happened since the last call to #update is reported at once,
+/// with repeated changes to the same file coalesced into a single entry.
+/// @see #PGE::FilePath::getLastModifyTime
+class FileWatcher : private NoHeap {
+    public:
+        /// Uses inotify if available, polling otherwise.
+        FileWatcher();
+        ~FileWatcher();
+
+        FileWatcher(const FileWatcher&) = delete;
+        void operator=(const FileWatcher&) = delete;
+
+        /// Starts watching a file, or all files directly inside of a directory.
+        /// Watches are reference counted, each call must be matched by a call to #unwatch.
+        ///
+        /// Files are watched via their parent directory, so replacing a file (as many editors do when saving) is detected as well.
+        /// @throws #PGE::Exception If the path is invalid, or the operating system refused to watch it.
+        void watch(const FilePath& path);
+        /// Stops watching a path once it has been unwatched as often as it has been watched.
+        void unwatch(const FilePath& path);
+
+        /// Whether the operating system reports changes, as opposed to them being polled.
+        bool isNative() const;
+
+        /// The minimum time between two polls in milliseconds.
+        /// Has no effect if #isNative.
+        /// Default is 500.
+        void setPollingInterval(int ms);
+
+        /// Collects all changes that occured since the previous call.
+        /// Changes inside of a watched directory are reported with the path of the file that changed.
+        /// @returns The changed files, each reported once. Valid until the next call.
+        const std::vector<FilePath>& update();
+
+    private:
+        struct WatchedDirectory {
+            FilePath path;
+            int wholeDirectoryRefs = 0;
+            std::unordered_map<String::Key, int> fileRefs;
+            int nativeHandle = -1;
+            // Only used when polling.
+            std::unordered_map<String::Key, u64> modifyTimes;
+        };
+
+        std::unordered_map<String::Key, WatchedDirectory> directories;
+        std::unordered_map<int, String::Key> nativeHandles;
+
+        int nativeInstance = -1;
+
+        std::chrono::steady_clock::duration pollingInterval;
+        std::chrono::steady_clock::time_point lastPoll;
+
+        std::vector<FilePath> changes;
+        std::unordered_set<String::Key> changeSet;
+
+        void reportChange(const WatchedDirectory& dir, const String& fileName);
+        bool isWatched(const WatchedDirectory& dir, const String& fileName) const;
+
+        void readNativeEvents();
+        void poll();
+        void snapshot(WatchedDirectory& dir, bool report);
+};
+
+}
+
+#endif // PGE_FILEWATCHER_H_INCLUDED
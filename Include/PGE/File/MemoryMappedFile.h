@@ -0,0 +1,49 @@
+#ifndef PGE_MEMORYMAPPEDFILE_H_INCLUDED
+#define PGE_MEMORYMAPPEDFILE_H_INCLUDED
+
+#include <PGE/File/FilePath.h>
+#include <PGE/ResourceManagement/NoHeap.h>
+
+namespace PGE {
+
+/// Maps the entirety of a file into memory.
+/// Pages are only read from disk when they're first accessed, so mapping a file is cheap regardless of its size.
+///
+/// The file must not be modified by anyone else while it is mapped.
+/// @see #PGE::BinaryReader
+class MemoryMappedFile : private NoHeap {
+    public:
+        enum class Access {
+            /// Writing to the mapped memory is not allowed.
+            READ_ONLY,
+            /// The mapped memory may be written to, but changes never reach the file.
+            /// Only the pages that are written to are copied.
+            COPY_ON_WRITE,
+        };
+
+        /// @throws #PGE::Exception If the path is invalid or the file could not be mapped.
+        MemoryMappedFile(const FilePath& file, Access access = Access::READ_ONLY);
+        ~MemoryMappedFile();
+
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+        void operator=(const MemoryMappedFile&) = delete;
+
+        const byte* getData() const;
+        /// @throws #PGE::Exception If the file was not mapped with #Access::COPY_ON_WRITE.
+        byte* getWritableData();
+        size_t getSize() const;
+
+    private:
+        const Access access;
+        byte* data;
+        size_t size;
+
+#ifdef _WIN32
+        void* fileHandle;
+        void* mappingHandle;
+#endif
+};
+
+}
+
+#endif // PGE_MEMORYMAPPEDFILE_H_INCLUDED
@@ -1,32 +1,139 @@
 #ifndef PGE_TEXTWRITER_H_DEFINED
 #define PGE_TEXTWRITER_H_DEFINED
 
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <string.h>
+
 #include <PGE/File/AbstractIO.h>
+#include <PGE/Math/Vector.h>
 
 namespace PGE {
 
 // TODO: More encodings?
 /// Utility to write text to a file.
-/// 
+///
 /// Normalizes line endings.
-/// 
+///
+/// All output is collected in a buffer owned by the writer, the file is only written to according to the #FlushPolicy.
+/// Numbers and vectors are formatted directly into that buffer, so they don't need to be converted to a #PGE::String first.
+///
 /// After any call raises an exception the stream will be closed, any further operations will raise an exception again.
-/// 
+///
 /// @throws #PGE::Exception Any write operation can raise an exception if writing failed or the writer is in an invalid state.
 /// @see #PGE::TextReader
 /// @see #PGE::BinaryWriter
 class TextWriter : private AbstractIO<std::ofstream> {
 	public:
-		using AbstractIO::earlyClose;
+		/// When the buffer is written to the file.
+		/// In any case it is written once it's full, when calling #flush and on destruction.
+		enum class FlushPolicy {
+			/// Only when required.
+			/// Fastest, suitable for generated files.
+			WHEN_FULL,
+			/// Additionally after every #writeLine.
+			/// Suitable for logs that must survive a crash.
+			EVERY_LINE,
+			/// Writing happens on a dedicated thread, using a second buffer.
+			/// Completed lines are handed over whenever that thread is idle, so writes never wait on the file system
+			/// unless the thread falls behind by a whole buffer.
+			BACKGROUND,
+		};
+
+		static constexpr int DEFAULT_BUFFER_SIZE = 64 * 1024;
 
         /// Opens the stream.
+        /// @param[in] bufferSize The size of the buffer in bytes, with #FlushPolicy::BACKGROUND two buffers of this size are used.
         /// @throws #PGE::Exception if the path is invalid or the file could not be opened.
-		TextWriter(const FilePath& file);
+		TextWriter(const FilePath& file, FlushPolicy policy = FlushPolicy::WHEN_FULL, int bufferSize = DEFAULT_BUFFER_SIZE);
+		/// Flushes remaining content, failure to do so is swallowed.
+		~TextWriter();
+
+		TextWriter(const TextWriter&) = delete;
+		void operator=(const TextWriter&) = delete;
+
+		/// Writes all buffered content to the file.
+		/// With #FlushPolicy::BACKGROUND this waits for the flushing thread to finish.
+		void flush();
+
+		/// Flushes and closes the stream prematurely.
+		/// @see #PGE::AbstractIO::earlyClose
+		void earlyClose();
 
         /// Writes a string to stream.
 		void write(const String& content);
-        /// Writes a string to stream and appends `\n`.
-		void writeLine(const String& content = String());
+		/// Writes a string literal or a null-terminated char array to stream, without constructing a #PGE::String.
+		/// Stops at the first null character, so only the filled part of a larger buffer is written.
+		template <size_t S>
+		void write(const char(&content)[S]) {
+			append(content, (int)strnlen(content, S));
+		}
+		void write(char ch);
+
+		void write(int value);
+		void write(long value);
+		void write(long long value);
+		void write(unsigned value);
+		void write(unsigned long value);
+		void write(unsigned long long value);
+		/// Floating point numbers are written like #PGE::String::from does.
+		void write(float value);
+		void write(double value);
+
+		/// Vectors are written as `(x, y, ...)`.
+		void write(const Vector2f& value);
+		void write(const Vector3f& value);
+		void write(const Vector4f& value);
+		void write(const Vector2i& value);
+
+		/// Writes all arguments in order.
+		/// Example: `writer.write("Loaded ", count, " meshes in ", seconds, "s");`
+		template <typename T, typename U, typename... Args>
+		void write(const T& first, const U& second, const Args&... rest) {
+			write(first);
+			write(second, rest...);
+		}
+
+        /// Writes all arguments in order and appends `\n`.
+		/// @see #write
+		template <typename... Args>
+		void writeLine(const Args&... args) {
+			(write(args), ...);
+			endLine();
+		}
+
+	private:
+		const FlushPolicy policy;
+		bool open;
+
+		std::unique_ptr<char[]> buffer;
+		int bufferSize;
+		int bufferUsed;
+
+		void append(const char* data, int size);
+		template <typename... Args>
+		void appendFormatted(const char* format, const Args&... args);
+		void endLine();
+		void writeBuffer();
+		void ensureOpen();
+
+		// Background flushing.
+		std::unique_ptr<char[]> backBuffer;
+		int backBufferUsed;
+		std::atomic<bool> backBufferPending;
+		bool stopFlushThread;
+		bool flushFailed;
+		std::mutex flushMutex;
+		std::condition_variable flushCondition;
+		std::thread flushThread;
+
+		void handOff();
+		void waitForFlushThread();
+		void stopBackgroundFlushing();
+		void runFlushThread();
 };
 
 }
@@ -3,15 +3,18 @@
 
 #include <vector>
 #include <optional>
+#include <functional>
 
 #include <PGE/ResourceManagement/ResourceManager.h>
 #include <PGE/ResourceManagement/PolymorphicHeap.h>
 #include <PGE/SysEvents/SysEvents.h>
 #include <PGE/Math/Rectangle.h>
 #include <PGE/Color/Color.h>
+#include <PGE/File/FilePath.h>
 
 namespace PGE {
 
+class Shader;
 class Texture;
 
 /// Main class for managing everything graphics related.
@@ -41,7 +44,10 @@ class Graphics : private PolymorphicHeap {
         /// Updates native window functionality.
         /// E.g. minimyzing, closing.
         /// 
+        /// Also applies pending hot reloads, so this should be called at the start of a frame.
+        /// 
         /// **Requires** a call to #PGE::SysEvents::update to function at all.
+        /// @see #enableHotReload
         virtual void update();
 
         /// Presents previously rendered image to the screen.
@@ -96,9 +102,34 @@ class Graphics : private PolymorphicHeap {
         virtual void setCulling(Culling mode);
         virtual Culling getCulling() const;
 
+        /// How many bytes of texture data #update uploads at most, for textures loaded with #PGE::Texture::loadAsync.
+        /// At least one level is uploaded per update, even if it exceeds the budget.
+        /// Default is 8 MiB.
+        void setTextureUploadBudget(int bytesPerUpdate);
+        int getTextureUploadBudget() const;
+
         /// Gets implementation defined debug information about a graphics object.
         virtual String getInfo() const = 0;
 
+        /// Reloads a shader whenever any file in its directory changes.
+        /// Reloads are applied during #update, never in the middle of a frame.
+        /// If the new sources fail to compile or change the shader's interface the old version stays in use.
+        /// 
+        /// Must be disabled before the shader is deleted.
+        void enableHotReload(Shader& shader);
+        void disableHotReload(const Shader& shader);
+
+        /// Produces the raw pixel data of a texture from its source file.
+        using TextureDecoder = std::function<const std::vector<byte>(const FilePath&)>;
+        /// Reloads a texture whenever its source file changes.
+        /// The decoded data must match the texture's dimensions and format, otherwise the old contents are kept.
+        /// Only supported for loaded, uncompressed textures.
+        /// 
+        /// Must be disabled before the texture is deleted.
+        /// @see #enableHotReload(Shader&)
+        void enableHotReload(Texture& texture, const FilePath& source, const TextureDecoder& decoder);
+        void disableHotReload(const Texture& texture);
+
         static const int DEFAULT_SCREEN_POSITION;
 
     protected:
@@ -116,6 +147,8 @@ class Graphics : private PolymorphicHeap {
         bool vsync;
         Culling cullingMode;
 
+        int textureUploadBudget = 8 * 1024 * 1024;
+
         Graphics(const String& name, int w, int h, WindowMode wm);
 
     protected:
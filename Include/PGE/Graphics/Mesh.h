@@ -9,12 +9,18 @@
 #include <PGE/Color/Color.h>
 #include <PGE/Math/Vector.h>
 #include <PGE/Math/Matrix.h>
+#include <PGE/Math/AABBox.h>
+#include <PGE/Math/Sphere.h>
 #include <PGE/StructuredData/StructuredData.h>
 #include <PGE/ResourceManagement/PolymorphicHeap.h>
+#include <PGE/Graphics/RenderQueue.h>
 
 namespace PGE {
 
 class Material;
+class Shader;
+class Texture;
+namespace MeshOptimizer { struct Options; struct Report; }
 
 class Mesh : private PolymorphicHeap {
     public:
@@ -23,6 +29,46 @@ class Mesh : private PolymorphicHeap {
             TRIANGLE,
         };
 
+        /// How often the geometry is expected to change.
+        enum class Usage {
+            /// Set once, or rarely.
+            STATIC,
+            /// Updated every few frames or more often.
+            /// The GPU copy is kept in several regions used in turn, so an update never waits for draws still using the previous one.
+            DYNAMIC,
+        };
+
+        /// What happens to the CPU copy of the geometry once it's uploaded.
+        /// Only applies to #Usage::STATIC meshes, dynamic ones always keep their copy.
+        enum class Retention {
+            /// Keeps the copy as it is.
+            KEEP,
+            /// Frees the copy, the geometry can't be updated or uploaded again until it's set anew.
+            DISCARD,
+            /// Keeps a compressed copy, which is decompressed whenever the geometry needs uploading again.
+            COMPRESSED,
+        };
+
+        /// Meshes with at most this many vertices are drawn with 16-bit indices.
+        static constexpr int MAX_SHORT_INDEX_VERTICES = 65536;
+
+        struct MemoryUsage {
+            u64 cpuBytes = 0;
+            u64 gpuBytes = 0;
+        };
+
+        /// A coarser version of the geometry, drawn with the same vertices.
+        /// @see #PGE::MeshOptimizer::generateLods
+        struct Lod {
+            std::vector<u32> indices;
+            /// How far the surface deviates from the full detail geometry, relative to the radius of #getBoundingSphere.
+            float error = 0.f;
+        };
+
+        /// The factor by which the error of the next coarser level must fall below the limit before #selectLod switches to it.
+        /// Keeps meshes close to a threshold from switching back and forth every frame.
+        static constexpr float LOD_HYSTERESIS = 0.75f;
+
         struct Line {
             Line(u32 a, u32 b);
 
@@ -36,30 +82,173 @@ class Mesh : private PolymorphicHeap {
         };
 
         static Mesh* create(class Graphics& gfx);
+        ~Mesh();
 
         void setGeometry(StructuredData&& verts, const std::vector<Line>& lines);
         void setGeometry(StructuredData&& verts, const std::vector<Triangle>& triangles);
         void setGeometry(StructuredData&& verts, PrimitiveType type, std::vector<u32>&& inds);
+        /// Runs #PGE::MeshOptimizer::optimize on the geometry before setting it, for geometry that wasn't optimized offline.
+        /// The vertices may be reordered and merged, so indices into the original vertices no longer apply.
+        /// @throws #PGE::Exception As #PGE::MeshOptimizer::optimize does.
+        const MeshOptimizer::Report setOptimizedGeometry(StructuredData&& verts, PrimitiveType type, std::vector<u32>&& inds, const MeshOptimizer::Options& options);
         void clearGeometry();
 
+        /// Overwrites the vertices starting at firstElem with all elements of verts.
+        /// Only the modified range is uploaded on the next draw, unless the vertex count grows.
+        /// @throws #PGE::Exception If the layout of verts differs from the mesh's, firstElem is out of bounds,
+        /// or the CPU copy was discarded.
+        void updateVertices(int firstElem, const StructuredData& verts);
+        /// Overwrites the indices starting at firstIndex with inds, including those of the levels of detail, which follow the full detail ones.
+        /// Only the modified range is uploaded on the next draw.
+        /// @throws #PGE::Exception If the range exceeds the indices, an index is out of range, or the CPU copy was discarded.
+        void updateIndices(int firstIndex, const std::vector<u32>& inds);
+
+        /// Default is #Usage::STATIC.
+        /// @throws #PGE::Exception If switching to #Usage::DYNAMIC while the retention isn't #Retention::KEEP.
+        void setUsage(Usage u);
+        Usage getUsage() const;
+
+        /// Default is #Retention::KEEP.
+        /// Takes effect on the next upload, or right away when switching back to #Retention::KEEP from a compressed copy.
+        /// @throws #PGE::Exception If the mesh is dynamic, or switching away from #Retention::DISCARD after the copy was discarded.
+        void setRetention(Retention r);
+        Retention getRetention() const;
+
+        /// Uploads the geometry again before the next draw, e.g. after the GPU copy was lost.
+        /// @throws #PGE::Exception If the CPU copy was discarded.
+        void invalidateGpuData();
+
+        /// The bounds of the vertices' "position" entry, in model space.
+        /// Recomputed whenever the geometry is set or updated, and kept after the CPU copy is released.
+        /// Empty at the origin if there is no such Vector3f or Vector4f entry.
+        /// @see #PGE::Frustum
+        const AABBox getBounds() const;
+        /// Contains #getBounds.
+        const Sphere getBoundingSphere() const;
+
+        /// Sets the levels of detail after the full detail geometry, ordered from finest to coarsest.
+        /// They are uploaded along with the geometry and discarded whenever it is set anew.
+        /// @throws #PGE::Exception If there is no geometry or its CPU copy was discarded, an index is out of range, the index count doesn't fit
+        /// the primitive type, or the errors aren't ascending.
+        void setLods(std::vector<Lod>&& lods);
+        /// Including the full detail geometry, which is level 0.
+        int getLodCount() const;
+
+        /// Picks the coarsest level whose error, projected to the screen, stays within maxPixelError.
+        /// @param[in] screenRadius The radius of the bounding sphere on screen, in pixels.
+        /// @see #computeScreenRadius
+        void selectLod(float screenRadius, float maxPixelError = 1.f);
+        /// @throws #PGE::Exception If the level doesn't exist.
+        void setLod(int lod);
+        int getLod() const;
+
+        /// The radius in pixels of a sphere seen through a perspective camera.
+        /// @returns Infinity if the camera is inside the sphere.
+        static float computeScreenRadius(const Sphere& sphere, const Vector3f& cameraPosition, float verticalFovRad, int screenHeight);
+
+        /// The memory held by this mesh's geometry.
+        const MemoryUsage getMemoryUsage() const;
+        /// The memory held by the geometry of all meshes.
+        static const MemoryUsage getTotalMemoryUsage();
+
         void setMaterial(Material* m);
 
         bool isOpaque() const;
 
+        /// Draws immediately, binding all state.
+        /// @see #PGE::RenderQueue
         void render();
+        /// Draws count instances of the mesh in a single draw call.
+        /// Each instance reads its own element of perInstance, which is streamed to the GPU on every call.
+        /// @throws #PGE::Exception If the layout of perInstance differs from the shader's instance layout,
+        /// if it has fewer than count elements, or if the renderer doesn't support instancing.
+        /// @see #PGE::Shader::getInstanceLayout
+        void renderInstanced(int count, const StructuredData& perInstance);
 
     protected:
+        /// What the previous draw left bound, so that consecutive draws can skip redundant state changes.
+        /// A default constructed state has nothing bound, so everything is bound.
+        struct RenderState {
+            static constexpr int MAX_TEXTURES = 8;
+
+            const Shader* shader = nullptr;
+            const Texture* textures[MAX_TEXTURES] = { };
+            // Depth writes enabled, unknown before the first draw.
+            std::optional<bool> opaque;
+
+            RenderQueue::Stats stats;
+        };
+
+        // These record the change and return whether it is required.
+        static bool changeShader(RenderState& state, const Shader& shader);
+        static bool changeTexture(RenderState& state, int index, const Texture& texture);
+        static bool changeDepthState(RenderState& state, bool opaque);
+
+        struct IndexRange {
+            int first = 0;
+            int count = 0;
+        };
+
         virtual void uploadInternalData() = 0;
-        virtual void renderInternal() = 0;
+        /// Uploads the modified ranges of the vertices and indices, which have kept their size since the last #uploadInternalData.
+        /// At least one of the ranges is set.
+        virtual void updateInternalData(const std::optional<StructuredData::ByteRange>& vertexRange, const std::optional<IndexRange>& indexRange) = 0;
+        virtual void renderInternal(RenderState& state) = 0;
+        virtual void renderInstancedInternal(RenderState& state, int count, const StructuredData& perInstance) = 0;
+        /// Called once after the last draw of a batch, to release state that shouldn't outlive it.
+        virtual void finishRendering(RenderState& /*state*/) { }
+
+        /// To be called by implementations whenever the size of their buffers changes.
+        void setGpuBytes(u64 bytes);
+
+        /// The indices to draw for the current level of detail, within the uploaded ones.
+        const IndexRange getDrawRange() const;
 
         Material* material = nullptr;
 
         std::optional<PrimitiveType> primitiveType;
         StructuredData vertices;
         std::vector<u32> indices;
+        // Of the uploaded geometry, as the CPU copy may be gone.
+        int indexCount = 0;
+        bool shortIndices = false;
+        Usage usage = Usage::STATIC;
 
     private:
+        friend class RenderQueue;
+        void render(RenderState& state);
+        void uploadModifiedData();
+
         bool mustReuploadInternalData = true;
+        // Modified by #updateIndices since the last upload.
+        std::optional<IndexRange> dirtyIndices;
+
+        Retention retention = Retention::KEEP;
+        bool cpuDataReleased = false;
+        int compressedVertexCount = 0;
+        std::vector<byte> compressedVertices;
+        std::vector<byte> compressedIndices;
+        void geometryChanged();
+        void releaseCpuData();
+        void restoreCpuData();
+        void discardCompressedData();
+
+        MemoryUsage memoryUsage;
+        void updateCpuBytes();
+
+        AABBox bounds;
+        Sphere boundingSphere;
+        // Whether the vertices have a "position" entry to compute the bounds from.
+        bool hasBoundsEntry() const;
+        void updateBounds();
+
+        struct LodRange {
+            IndexRange indices;
+            float error;
+        };
+        // Level 0 is the full detail geometry, the indices of all others follow it.
+        std::vector<LodRange> lodRanges;
+        int currentLod = 0;
 };
 
 }
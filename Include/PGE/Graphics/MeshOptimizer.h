@@ -0,0 +1,80 @@
+#ifndef PGE_MESHOPTIMIZER_H_INCLUDED
+#define PGE_MESHOPTIMIZER_H_INCLUDED
+
+#include <vector>
+
+#include <PGE/Types/Types.h>
+#include <PGE/StructuredData/StructuredData.h>
+#include <PGE/Graphics/Mesh.h>
+
+namespace PGE {
+
+/// Reorders and deduplicates geometry so the GPU processes it faster, without changing what is drawn,
+/// and simplifies it into levels of detail.
+/// Meant to be run before #PGE::Mesh::setGeometry when loading, or offline with the result saved via #PGE::StructuredData::save.
+namespace MeshOptimizer {
+    struct Options {
+        /// Merges vertices whose data is identical byte for byte.
+        bool weld = true;
+        /// Reorders triangles so that vertices are reused while they're still in the post-transform cache.
+        /// Does nothing for lines.
+        bool optimizeVertexCache = true;
+        /// Reorders vertices into the order they're first used in, and drops unused ones.
+        bool optimizeVertexFetch = true;
+    };
+
+    struct Report {
+        int verticesBefore = 0;
+        int verticesAfter = 0;
+        /// Average cache miss ratio, the amount of vertices transformed per triangle.
+        /// 0.5 is the ideal for large regular grids, 3 means no reuse at all.
+        float acmrBefore = 0.f;
+        float acmrAfter = 0.f;
+        /// Of the vertices and indices, with the index width #PGE::Mesh picks when uploading.
+        u64 bytesBefore = 0;
+        u64 bytesAfter = 0;
+    };
+
+    struct SimplifyOptions {
+        /// Entries made of floats, e.g. texture coordinates or normals, whose difference across a collapsed edge adds to its error.
+        std::vector<String::Key> attributes;
+        /// Scales the squared difference of the attributes against the squared distance the surface moves.
+        float attributeWeight = 1.f;
+        /// No edge is collapsed if that would move the surface further than this, relative to the radius of the bounds.
+        float maxError = 1.f;
+    };
+
+    /// The size of the simulated post-transform cache.
+    constexpr int CACHE_SIZE = 16;
+
+    /// Optimizes the geometry in place.
+    /// @throws #PGE::Exception If an index is out of range or the index count doesn't fit the primitive type.
+    const Report optimize(StructuredData& vertices, std::vector<u32>& indices, Mesh::PrimitiveType type, const Options& options = Options());
+
+    /// Removes triangles until at most targetIndexCount indices are left, by collapsing edges into one of their vertices,
+    /// cheapest first as measured by quadric error metrics.
+    /// The vertices aren't modified, so the result can be drawn with them, e.g. as a #PGE::Mesh::Lod.
+    /// Vertices on open borders only move along them, vertices sharing their position with another one, e.g. along a texture seam, don't move.
+    /// If remap isn't null, it receives the vertex each vertex was collapsed into, or the vertex itself if it's still used,
+    /// e.g. to morph between levels.
+    /// @returns How far the surface moved at most, relative to the radius of the bounds of the "position" entry.
+    /// @throws #PGE::Exception If the vertices have no Vector3f or Vector4f "position" entry, an attribute isn't made of floats,
+    /// or an index is out of range.
+    float simplify(const StructuredData& vertices, std::vector<u32>& indices, int targetIndexCount, const SimplifyOptions& options = SimplifyOptions(),
+        std::vector<u32>* remap = nullptr);
+
+    /// Simplifies a triangle list into at most count levels of detail, each with about reduction times the indices of the previous one.
+    /// Stops early once simplification stalls or the maximum error is reached. Each level is optimized for the vertex cache.
+    /// @throws #PGE::Exception As #simplify does.
+    /// @see #PGE::Mesh::setLods
+    const std::vector<Mesh::Lod> generateLods(const StructuredData& vertices, const std::vector<u32>& indices, int count, float reduction = 0.5f,
+        const SimplifyOptions& options = SimplifyOptions());
+
+    /// Simulates a FIFO post-transform cache of #CACHE_SIZE entries.
+    /// @returns The average cache miss ratio of a triangle list, 0 if there are no triangles.
+    float computeACMR(const std::vector<u32>& indices);
+}
+
+}
+
+#endif // PGE_MESHOPTIMIZER_H_INCLUDED
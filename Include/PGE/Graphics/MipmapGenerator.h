@@ -0,0 +1,73 @@
+#ifndef PGE_MIPMAPGENERATOR_H_INCLUDED
+#define PGE_MIPMAPGENERATOR_H_INCLUDED
+
+#include <optional>
+#include <vector>
+
+#include <PGE/Types/Types.h>
+#include <PGE/Graphics/Texture.h>
+
+namespace PGE {
+
+/// Generates the smaller levels of a texture on the CPU, with better filters than the GPU's,
+/// for #PGE::Texture::load, #PGE::Texture::loadAsync or #PGE::TextureCompressor::compress.
+/// Doesn't touch the renderer, so it may run on any thread.
+namespace MipmapGenerator {
+    enum class Filter {
+        /// Averages 2x2 pixels, blurs and aliases the most.
+        BOX,
+        /// Kaiser windowed sinc, sharp with little ringing.
+        KAISER,
+        /// Three lobed Lanczos windowed sinc, the sharpest, may ring around high contrast edges.
+        LANCZOS,
+    };
+
+    struct Options {
+        Filter filter = Filter::KAISER;
+        /// Whether the color channels of RGBA textures are sRGB encoded, in which case they're filtered in linear space.
+        bool srgb = false;
+        /// Whether the texture repeats, so the filter wraps around the edges instead of clamping to them.
+        bool wrap = true;
+        /// Scales the alpha of every level so the same share of pixels has an alpha above this, from 0 to 1, as in the largest level.
+        /// Keeps alpha tested textures, e.g. foliage, from thinning out in the distance. Only applies to RGBA textures.
+        std::optional<float> alphaCoverageReference;
+        /// The amount of levels including the largest one, 0 for all down to 1x1.
+        int maxLevels = 0;
+        /// Spreads the rows of each level across multiple threads.
+        /// Turn off when already generating on a worker thread.
+        bool allowParallel = true;
+    };
+
+    class MipmapChain;
+
+    /// @param[in] buffer The largest level, which must outlive the result.
+    /// @throws #PGE::Exception If the buffer is nullptr or the dimensions aren't positive.
+    const MipmapChain generate(const byte* buffer, int w, int h, Texture::Format fmt, const Options& options = Options());
+
+    /// The levels produced by #generate.
+    class MipmapChain {
+        public:
+            MipmapChain(MipmapChain&& other) = default;
+            MipmapChain(const MipmapChain&) = delete;
+            void operator=(const MipmapChain&) = delete;
+
+            Texture::Format getFormat() const;
+            /// Largest first. The first level is the buffer passed to #generate, the others point into memory owned by this object.
+            const std::vector<Texture::Mipmap>& getMipmaps() const;
+
+            /// Shorthand for #PGE::Texture::load with #getMipmaps and #getFormat.
+            Texture* load(Graphics& gfx) const;
+
+        private:
+            MipmapChain(Texture::Format fmt);
+            friend const MipmapChain generate(const byte* buffer, int w, int h, Texture::Format fmt, const Options& options);
+
+            Texture::Format format;
+            std::vector<byte> data;
+            std::vector<Texture::Mipmap> mipmaps;
+    };
+}
+
+}
+
+#endif // PGE_MIPMAPGENERATOR_H_INCLUDED
@@ -0,0 +1,98 @@
+#ifndef PGE_OCCLUSIONCULLER_H_INCLUDED
+#define PGE_OCCLUSIONCULLER_H_INCLUDED
+
+#include <vector>
+
+#include <PGE/Types/Types.h>
+#include <PGE/Math/Matrix.h>
+#include <PGE/Math/AABBox.h>
+#include <PGE/ResourceManagement/NoHeap.h>
+
+namespace PGE {
+
+/// Culls objects hidden behind others, entirely on the CPU.
+///
+/// Occluders, e.g. the walls of a room, are rasterized into a low resolution depth buffer.
+/// Boxes are then tested against it, those behind the occluders everywhere they cover are reported as hidden.
+/// The buffer is split into tiles of #TILE_SIZE pixels, which are rasterized on multiple threads,
+/// and whose farthest depth lets most boxes be rejected without looking at single pixels.
+///
+/// Occluders should be simplified stand-ins that lie within the actual geometry, as anything rasterized is taken to be solid.
+/// Triangles reaching in front of the near plane are skipped rather than clipped, so they occlude nothing.
+/// Use after frustum culling, as boxes outside the screen are reported as hidden.
+/// @see #PGE::Frustum
+class OcclusionCuller : private NoHeap {
+    public:
+        static constexpr int TILE_SIZE = 16;
+
+        /// @throws #PGE::Exception If the width or height isn't a positive multiple of #TILE_SIZE.
+        OcclusionCuller(int w = 256, int h = 128);
+        OcclusionCuller(const OcclusionCuller&) = delete;
+        void operator=(const OcclusionCuller&) = delete;
+
+        /// Removes all occluders and clears the depth buffer.
+        /// @param[in] viewProjection The camera used by all following calls, i.e. projection * view.
+        /// Clip space depth must range from 0 to 1, as with #PGE::Matrix4x4f::constructPerspectiveMat.
+        void beginFrame(const Matrix4x4f& viewProjection);
+
+        /// Queues a triangle list for the next #rasterize.
+        /// @param[in] world Transforms the positions into world space.
+        /// @throws #PGE::Exception If the index count isn't a multiple of 3 or an index is out of range.
+        void addOccluder(const std::vector<Vector3f>& positions, const std::vector<u32>& indices, const Matrix4x4f& world);
+
+        /// Rasterizes the occluders queued since #beginFrame.
+        void rasterize(bool allowParallel = true);
+
+        /// Whether any part of a world space box may be in front of the occluders.
+        bool isVisible(const AABBox& box) const;
+        /// Tests many boxes at once, with the same output as #PGE::Frustum::cull.
+        /// @see #PGE::Frustum::isVisible
+        void test(const std::vector<AABBox>& boxes, std::vector<u64>& visible, bool allowParallel = true) const;
+
+        int getWidth() const;
+        int getHeight() const;
+        /// The depth of the nearest occluder covering a pixel, 1 if there is none.
+        /// Row 0 is at the bottom of the screen.
+        float getDepth(int x, int y) const;
+
+        int getTriangleCount() const;
+
+    private:
+        // Screen space triangle, with edge functions and depth in the form a * x + b * y + c.
+        struct Triangle {
+            float edgeA[3];
+            float edgeB[3];
+            float edgeC[3];
+            float depthA;
+            float depthB;
+            float depthC;
+            int minX;
+            int minY;
+            int maxX;
+            int maxY;
+        };
+
+        int width;
+        int height;
+        int tilesX;
+        int tilesY;
+
+        Matrix4x4f viewProjection;
+
+        std::vector<float> depth;
+        // The farthest depth within each tile.
+        std::vector<float> tileMaxDepth;
+
+        std::vector<Triangle> triangles;
+        // The triangles overlapping each tile.
+        std::vector<std::vector<int>> tileBins;
+
+        void rasterizeTile(int tile);
+        // Returns false if the box is outside the screen, otherwise its pixel rectangle and nearest depth.
+        bool project(const AABBox& box, int& minX, int& minY, int& maxX, int& maxY, float& minDepth) const;
+        bool isRectVisible(int minX, int minY, int maxX, int maxY, float minDepth) const;
+};
+
+}
+
+#endif // PGE_OCCLUSIONCULLER_H_INCLUDED
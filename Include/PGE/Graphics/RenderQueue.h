@@ -0,0 +1,87 @@
+#ifndef PGE_RENDERQUEUE_H_INCLUDED
+#define PGE_RENDERQUEUE_H_INCLUDED
+
+#include <vector>
+#include <unordered_map>
+#include <functional>
+
+#include <PGE/Types/Types.h>
+#include <PGE/ResourceManagement/NoHeap.h>
+
+namespace PGE {
+
+class Mesh;
+
+/// Collects the draws of a frame and submits them in an order that minimizes state changes.
+///
+/// Every draw is assigned a 64-bit sort key, from most to least significant:
+/// - The pass, passes are drawn in ascending order.
+/// - Whether the material is transparent, opaque draws come first.
+/// - For opaque draws: the shader, the first texture, the material and finally the depth, front to back.
+/// - For transparent draws: the depth, back to front, followed by the shader, the first texture and the material.
+///
+/// The keys are radix sorted on #flush, consecutive draws then skip binding what is already bound.
+/// @see #PGE::Mesh::render
+class RenderQueue : private NoHeap {
+    public:
+        /// How many state changes the last #flush performed, and how many it was able to skip.
+        struct Stats {
+            int draws = 0;
+            int shaderChanges = 0;
+            int shaderChangesSkipped = 0;
+            int textureChanges = 0;
+            int textureChangesSkipped = 0;
+            int depthStateChanges = 0;
+            int depthStateChangesSkipped = 0;
+        };
+
+        static constexpr int MAX_PASS = 15;
+
+        RenderQueue() = default;
+        RenderQueue(const RenderQueue&) = delete;
+        void operator=(const RenderQueue&) = delete;
+
+        /// Queues a mesh to be drawn on the next #flush.
+        /// The mesh must stay alive and keep its material until then.
+        /// Meshes without geometry or material are ignored, as with #PGE::Mesh::render.
+        /// @param[in] depth The distance from the camera, negative values are treated as 0.
+        /// @param[in] prepare Called right before the mesh is drawn, e.g. to set shader constants that differ per draw.
+        /// @throws #PGE::Exception If the pass is outside [0, #MAX_PASS].
+        void submit(Mesh& mesh, float depth, int pass = 0, const std::function<void()>& prepare = nullptr);
+
+        /// Sorts and draws everything submitted since the last flush, then empties the queue.
+        void flush();
+        /// Empties the queue without drawing.
+        void clear();
+
+        int getSize() const;
+        const Stats& getStats() const;
+
+    private:
+        struct Item {
+            Mesh* mesh;
+            std::function<void()> prepare;
+        };
+
+        std::vector<Item> items;
+        std::vector<u64> keys;
+
+        // Small ids make for compact keys, they're handed out in order of first appearance each frame.
+        std::unordered_map<const void*, u64> shaderIds;
+        std::unordered_map<const void*, u64> textureIds;
+        std::unordered_map<const void*, u64> materialIds;
+
+        // Scratch space for sorting.
+        std::vector<u64> sortedKeys;
+        std::vector<int> order;
+        std::vector<int> sortedOrder;
+
+        Stats stats;
+
+        static u64 getId(std::unordered_map<const void*, u64>& ids, const void* object, u64 max);
+        void sort();
+};
+
+}
+
+#endif // PGE_RENDERQUEUE_H_INCLUDED
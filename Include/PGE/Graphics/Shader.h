@@ -16,6 +16,21 @@ class Shader : private PolymorphicHeap {
         virtual ~Shader() = default;
 
         const StructuredData::ElemLayout& getVertexLayout() { return vertexLayout; }
+        /// The layout of per-instance data, as taken by #PGE::Mesh::renderInstanced.
+        /// Consists of the vertex shader inputs prefixed with `instanceInput_`, without the prefix.
+        /// Empty if the shader doesn't support instancing.
+        const StructuredData::ElemLayout& getInstanceLayout() const { return instanceLayout; }
+        /// Checks that a reflected vertex struct matches the vertex inputs of the shader.
+        /// Meant to be called once after loading, instead of failing when setting geometry.
+        /// @throws #PGE::Exception If the names, sizes or order of the fields differ from the inputs.
+        /// @see #PGE::StructuredData::getReflectedLayout
+        template <typename T>
+        void validateVertexType() const {
+            PGE_ASSERT(StructuredData::getReflectedLayout<T>() == vertexLayout,
+                "Vertex struct doesn't match the vertex inputs (filepath: " + filepath.str() + ")");
+        }
+        /// The directory the shader was loaded from.
+        const FilePath& getPath() const { return filepath; }
 
         // This is not heap-only to allow it as a map value.
         class Constant {
@@ -39,6 +54,7 @@ class Shader : private PolymorphicHeap {
         Shader(const FilePath& path) : filepath(path) { }
 
         StructuredData::ElemLayout vertexLayout;
+        StructuredData::ElemLayout instanceLayout;
         const FilePath filepath;
 };
 
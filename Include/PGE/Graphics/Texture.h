@@ -28,9 +28,23 @@ class Texture : private PolymorphicHeap {
             BC6,
             BC7,
         };
+        /// The size of a block of 4x4 pixels.
+        static int getBytesPerBlock(CompressedFormat fmt);
 
         using AnyFormat = std::variant<Format, CompressedFormat>;
 
+        /// How much of a texture loaded with #loadAsync is usable.
+        enum class UploadStatus {
+            /// No level has been uploaded yet, the texture is sampled as black.
+            PENDING,
+            /// The smaller levels have been uploaded, the texture is drawn at reduced detail.
+            PARTIAL,
+            /// All levels have been uploaded and the GPU is done copying them.
+            COMPLETE,
+        };
+        /// Always #UploadStatus::COMPLETE for textures that weren't loaded asynchronously.
+        virtual UploadStatus getUploadStatus() const;
+
         bool isRenderTarget() const;
 
         int getWidth() const; int getHeight() const;
@@ -47,7 +61,23 @@ class Texture : private PolymorphicHeap {
                 : width(width), height(height), buffer(buffer), size(size) { }
             Mipmap() = default;
         };
+        /// Loads a texture with all levels provided, instead of generating the smaller ones on the GPU.
+        /// @param[in] mipmaps All levels, largest first.
+        /// @throws #PGE::Exception If there are no levels, a level isn't half the size of the previous one,
+        /// or the buffer size of a level doesn't match its dimensions.
+        /// @see #PGE::MipmapGenerator
+        static Texture* load(Graphics& gfx, const std::vector<Mipmap>& mipmaps, Format fmt);
         static Texture* loadCompressed(Graphics& gfx, const std::vector<Mipmap>& mipmaps, CompressedFormat fmt);
+        /// Loads a texture over the following frames, instead of stalling the current one.
+        /// The data is copied to staging memory right away, so the buffers may be freed once this returns.
+        /// Every #PGE::Graphics::update uploads levels within the budget set by #PGE::Graphics::setTextureUploadBudget,
+        /// smallest first, so the texture can be drawn right away and gets sharper as the larger levels arrive.
+        /// Renderers without asynchronous uploads load the texture immediately.
+        /// @param[in] mipmaps All levels, largest first.
+        /// @throws #PGE::Exception If there are no levels, a level isn't half the size of the previous one,
+        /// or the buffer size of an uncompressed level doesn't match its dimensions.
+        /// @see #getUploadStatus
+        static Texture* loadAsync(Graphics& gfx, const std::vector<Mipmap>& mipmaps, const AnyFormat& fmt);
         virtual ~Texture() = default;
 
     protected:
@@ -0,0 +1,83 @@
+#ifndef PGE_TEXTURECOMPRESSOR_H_INCLUDED
+#define PGE_TEXTURECOMPRESSOR_H_INCLUDED
+
+#include <vector>
+
+#include <PGE/Types/Types.h>
+#include <PGE/Graphics/Texture.h>
+
+namespace PGE {
+
+/// Encodes RGBA32 textures into the block compressed formats of #PGE::Texture::CompressedFormat.
+/// Fast enough to run on textures created at runtime, on worker threads if need be, and meant to be run when cooking textures otherwise.
+/// @see #PGE::TextureFile
+namespace TextureCompressor {
+    enum class Quality {
+        /// Takes the endpoints of each block from the bounds of its colors.
+        FAST,
+        /// Takes the endpoints along the principal axis of each block's colors, and refines them once.
+        NORMAL,
+        /// Refines the endpoints repeatedly and tries additional encodings per block.
+        HIGH,
+    };
+
+    struct Options {
+        Quality quality = Quality::NORMAL;
+        /// Spreads the blocks of each level across multiple threads.
+        /// Turn off when already compressing on a worker thread.
+        bool allowParallel = true;
+    };
+
+    struct Report {
+        /// Peak signal-to-noise ratio of all levels against the input in decibels, infinite if lossless.
+        /// Only covers the channels the format keeps.
+        double psnr = 0.0;
+        u64 bytesBefore = 0;
+        u64 bytesAfter = 0;
+        /// Of all levels.
+        u64 blockCount = 0;
+        /// Wall clock time #compress took to encode all levels, not counting measuring #psnr.
+        double seconds = 0.0;
+    };
+
+    class CompressedTexture;
+
+    /// Compresses every level of a texture.
+    /// BC1 keeps alpha as either transparent or opaque, cut off at 128, with transparent pixels turning black.
+    /// BC4 only keeps the red channel and BC5 red and green. BC7 blocks are all encoded in mode 6.
+    /// @param[in] levels RGBA32 levels, largest first.
+    /// @throws #PGE::Exception If there are no levels, a level isn't half the size of the previous one,
+    /// its buffer size doesn't match its dimensions, or the format is BC6, which requires HDR input.
+    const CompressedTexture compress(const std::vector<Texture::Mipmap>& levels, Texture::CompressedFormat fmt, const Options& options = Options());
+
+    /// The levels produced by #compress.
+    class CompressedTexture {
+        public:
+            CompressedTexture(CompressedTexture&& other) = default;
+            CompressedTexture(const CompressedTexture&) = delete;
+            void operator=(const CompressedTexture&) = delete;
+
+            Texture::CompressedFormat getFormat() const;
+            /// Largest first, pointing into #getData.
+            const std::vector<Texture::Mipmap>& getMipmaps() const;
+            /// All levels back to back, as stored in DDS files.
+            const std::vector<byte>& getData() const;
+            const Report& getReport() const;
+
+            /// Shorthand for #PGE::Texture::loadCompressed with #getMipmaps and #getFormat.
+            Texture* load(Graphics& gfx) const;
+
+        private:
+            CompressedTexture(Texture::CompressedFormat fmt);
+            friend const CompressedTexture compress(const std::vector<Texture::Mipmap>& levels, Texture::CompressedFormat fmt, const Options& options);
+
+            Texture::CompressedFormat format;
+            std::vector<byte> data;
+            std::vector<Texture::Mipmap> mipmaps;
+            Report report;
+    };
+}
+
+}
+
+#endif // PGE_TEXTURECOMPRESSOR_H_INCLUDED
@@ -0,0 +1,50 @@
+#ifndef PGE_TEXTUREFILE_H_INCLUDED
+#define PGE_TEXTUREFILE_H_INCLUDED
+
+#include <vector>
+
+#include <PGE/File/MemoryMappedFile.h>
+#include <PGE/Graphics/Texture.h>
+#include <PGE/ResourceManagement/NoHeap.h>
+
+namespace PGE {
+
+/// A block compressed texture read from a DDS or KTX2 file.
+///
+/// The file is memory mapped and the levels point straight into the mapping,
+/// so they reach the GPU without being decoded or copied in between.
+/// Only single 2D images are supported, not arrays, cube maps or volumes.
+/// KTX2 files must not be supercompressed.
+/// sRGB variants are read as their linear counterparts. Signed BC4 and BC5, and unsigned BC6H,
+/// have no counterpart in #PGE::Texture::CompressedFormat and aren't supported.
+class TextureFile : private NoHeap {
+    public:
+        /// @throws #PGE::Exception If the file could not be mapped, isn't a DDS or KTX2 file, is truncated,
+        /// or holds anything but a single 2D image in one of the formats of #PGE::Texture::CompressedFormat.
+        TextureFile(const FilePath& file);
+        TextureFile(const TextureFile&) = delete;
+        void operator=(const TextureFile&) = delete;
+
+        Texture::CompressedFormat getFormat() const;
+        /// Largest first, as expected by #PGE::Texture::loadCompressed.
+        /// The buffers are only valid for as long as this object exists.
+        const std::vector<Texture::Mipmap>& getMipmaps() const;
+
+        int getWidth() const;
+        int getHeight() const;
+
+        /// Shorthand for #PGE::Texture::loadCompressed with #getMipmaps and #getFormat.
+        Texture* load(Graphics& gfx) const;
+
+    private:
+        MemoryMappedFile file;
+        Texture::CompressedFormat format;
+        std::vector<Texture::Mipmap> mipmaps;
+
+        void readDds(const FilePath& path);
+        void readKtx2(const FilePath& path);
+};
+
+}
+
+#endif // PGE_TEXTUREFILE_H_INCLUDED
@@ -0,0 +1,87 @@
+#ifndef PGE_FRUSTUM_H_INCLUDED
+#define PGE_FRUSTUM_H_INCLUDED
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <PGE/Types/Types.h>
+
+#include "Matrix.h"
+#include "Plane.h"
+#include "AABBox.h"
+#include "Sphere.h"
+
+namespace PGE {
+
+/// The volume visible through a camera, bounded by six planes whose normals point inwards.
+class Frustum : private NoHeap {
+    public:
+        static constexpr int PLANE_COUNT = 6;
+
+        /// Contains everything.
+        Frustum() {
+            for (Plane& plane : planes) {
+                plane = Plane(Vector3f(0.f, 1.f, 0.f), -std::numeric_limits<float>::max());
+            }
+        }
+
+        /// Extracts the planes from a view-projection matrix, i.e. projection * view.
+        /// Expects clip space depth to range from 0 to 1, as produced by #PGE::Matrix4x4f::constructPerspectiveMat.
+        Frustum(const Matrix4x4f& viewProjection) {
+            const float (&m)[4][4] = viewProjection.elements;
+            // Left, right, bottom, top, near, far.
+            // A point is inside when -w <= x <= w, -w <= y <= w and 0 <= z <= w in clip space.
+            setPlane(0, m[3][0] + m[0][0], m[3][1] + m[0][1], m[3][2] + m[0][2], m[3][3] + m[0][3]);
+            setPlane(1, m[3][0] - m[0][0], m[3][1] - m[0][1], m[3][2] - m[0][2], m[3][3] - m[0][3]);
+            setPlane(2, m[3][0] + m[1][0], m[3][1] + m[1][1], m[3][2] + m[1][2], m[3][3] + m[1][3]);
+            setPlane(3, m[3][0] - m[1][0], m[3][1] - m[1][1], m[3][2] - m[1][2], m[3][3] - m[1][3]);
+            setPlane(4, m[2][0], m[2][1], m[2][2], m[2][3]);
+            setPlane(5, m[3][0] - m[2][0], m[3][1] - m[2][1], m[3][2] - m[2][2], m[3][3] - m[2][3]);
+        }
+
+        const Plane& getPlane(int index) const { return planes[index]; }
+
+        /// Conservative, a box near a corner of the frustum may be reported as intersecting while being outside.
+        bool intersects(const AABBox& box) const {
+            Vector3f center = box.getCenter();
+            Vector3f halfDims = box.getDims() * 0.5f;
+            for (const Plane& plane : planes) {
+                const Vector3f& n = plane.normal;
+                float extent = halfDims.x * std::abs(n.x) + halfDims.y * std::abs(n.y) + halfDims.z * std::abs(n.z);
+                if (plane.evalAtPoint(center) < -extent) { return false; }
+            }
+            return true;
+        }
+
+        /// Conservative, like the box test.
+        bool intersects(const Sphere& sphere) const {
+            for (const Plane& plane : planes) {
+                if (plane.evalAtPoint(sphere.getCenter()) < -sphere.getRadius()) { return false; }
+            }
+            return true;
+        }
+
+        /// Tests many boxes at once, several at a time with SIMD.
+        /// Box i is visible if bit i % 64 of visible[i / 64] is set, the bits past the last box are cleared.
+        /// @param[out] visible Resized to fit all boxes.
+        /// @param[in] allowParallel Whether large sets of boxes may be split across threads.
+        /// @see #isVisible
+        void cull(const std::vector<AABBox>& boxes, std::vector<u64>& visible, bool allowParallel = true) const;
+
+        static bool isVisible(const std::vector<u64>& visible, int index) {
+            return (visible[index / 64] >> (index % 64)) & 1;
+        }
+
+    private:
+        Plane planes[PLANE_COUNT];
+
+        void setPlane(int index, float a, float b, float c, float d) {
+            float length = Vector3f(a, b, c).length();
+            planes[index] = Plane(Vector3f(a, b, c) / length, -d / length);
+        }
+};
+
+}
+
+#endif // PGE_FRUSTUM_H_INCLUDED
@@ -0,0 +1,42 @@
+#ifndef PGE_SPHERE_H_INCLUDED
+#define PGE_SPHERE_H_INCLUDED
+
+#include <PGE/ResourceManagement/NoHeap.h>
+
+#include "AABBox.h"
+
+namespace PGE {
+
+class Sphere : private NoHeap {
+    private:
+        Vector3f center; float radius;
+
+    public:
+        constexpr Sphere() : radius(0.f) { }
+        constexpr Sphere(const Vector3f& c, float r) : center(c), radius(r) { }
+        /// The smallest sphere containing the box.
+        Sphere(const AABBox& box) : center(box.getCenter()), radius(box.getDims().length() * 0.5f) { }
+
+        constexpr bool operator==(const Sphere& other) const { return center == other.center && radius == other.radius; }
+        constexpr bool operator!=(const Sphere& other) const { return center != other.center || radius != other.radius; }
+
+        constexpr bool equals(const Sphere& other, float epsilon = Math::EPSILON_DEFAULT) const {
+            return center.equals(other.center, epsilon) && Math::equalFloats(radius, other.radius, epsilon);
+        }
+
+        constexpr const Vector3f& getCenter() const { return center; }
+        constexpr float getRadius() const { return radius; }
+
+        constexpr bool contains(const Vector3f& point) const {
+            return point.distanceSquared(center) <= radius * radius;
+        }
+
+        constexpr bool intersects(const Sphere& other) const {
+            float radii = radius + other.radius;
+            return center.distanceSquared(other.center) <= radii * radii;
+        }
+};
+
+}
+
+#endif // PGE_SPHERE_H_INCLUDED
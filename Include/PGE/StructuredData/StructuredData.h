@@ -6,50 +6,201 @@
 #include <PGE/String/Key.h>
 #include <PGE/Math/Vector.h>
 #include <PGE/Math/Matrix.h>
+#include <PGE/Math/AABBox.h>
 #include <PGE/Color/Color.h>
+#include <PGE/File/FilePath.h>
+#include <PGE/Exception/Exception.h>
 #include <PGE/ResourceManagement/PolymorphicHeap.h>
 
 #include <unordered_map>
+#include <memory>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <algorithm>
+#include <limits>
 
 namespace PGE {
 
+class BinaryReader;
+class BinaryWriter;
+class MemoryMappedFile;
+
+/// Specialized by #PGE_REFLECT_LAYOUT_BEGIN.
+template <typename T>
+struct ReflectedLayout;
+
 class StructuredData : NoHeap {
     public:
+        /// Describes the entries of an element and where they are located.
+        ///
+        /// Layouts are interned: constructing a layout that is structurally equal to an existing one yields a handle
+        /// to the same immutable, reference counted instance. Copying a layout therefore only copies a pointer,
+        /// and comparing two layouts is a pointer comparison.
         class ElemLayout {
             public:
+                /// How entries are placed within an element.
+                enum class Packing {
+                    /// Back to back without any padding.
+                    TIGHT,
+                    /// GLSL std140 rules, as used by uniform blocks.
+                    /// Two component vectors are aligned to 8 bytes, larger vectors, matrices and all arrays to 16,
+                    /// array strides and the element size are rounded up to 16.
+                    STD140,
+                    /// GLSL std430 rules, as used by shader storage blocks.
+                    /// Same as #STD140, except that arrays and the element size aren't rounded up to 16.
+                    STD430,
+                    /// Every entry aligned to 4 bytes, as vertex attribute offsets must be.
+                    VERTEX,
+                };
+
                 struct Entry : private NoHeap {
-                    Entry(const String& nm, int sz);
+                    /// @param[in] sz The size of a single value, in case of an array the size of one of its elements.
+                    Entry(const String& nm, int sz, int arrSz = 1);
 
                     String name;
                     int size;
+                    int arraySize;
                 };
 
                 struct LocationAndSize : private NoHeap {
-                    LocationAndSize(int loc, int sz);
+                    LocationAndSize(int loc, int sz, int arrStride = 0, int arrSz = 1);
 
                     // TODO: C++20 default.
                     bool operator==(const LocationAndSize& other) const;
 
                     int location;
+                    /// The size of a single value, not counting padding.
                     int size;
+                    /// The distance between two array elements.
+                    int arrayStride;
+                    int arraySize;
+                };
+
+                /// A field of the layout, resolved ahead of time.
+                /// Allows accessing the field in any element without looking it up again.
+                /// Only valid for StructuredData using the layout it was retrieved from.
+                /// @see #getAccessor
+                template <typename T>
+                class Accessor : private NoHeap {
+                    static_assert(std::is_trivially_copyable<T>::value);
+
+                    public:
+                        /// Invalid accessor.
+                        Accessor() = default;
+
+                        int getOffset() const { return offset; }
+                        int getStride() const { return stride; }
+                        bool isValid() const { return stride > 0; }
+
+                    private:
+                        friend class ElemLayout;
+                        Accessor(int offs, int strd) : offset(offs), stride(strd) { }
+
+                        int offset = 0;
+                        int stride = 0;
                 };
 
-                ElemLayout() = default;
-                ElemLayout(const std::vector<Entry>& entrs);
+                /// The layout without any entries.
+                ElemLayout();
+                /// Lays out the entries in order, inserting padding as required by the packing rules.
+                /// Thread-safe.
+                /// @throws #PGE::Exception If an entry's size isn't a multiple of 4 with any packing other than #Packing::TIGHT.
+                ElemLayout(const std::vector<Entry>& entrs, Packing pck = Packing::TIGHT);
 
+                bool hasEntry(const String::Key& name) const;
                 const LocationAndSize& getLocationAndSize(const String& name) const;
                 const LocationAndSize& getLocationAndSize(const String::Key& name) const;
+                /// Including trailing padding, i.e. the stride between two elements.
                 int getElementSize() const;
+                Packing getPacking() const;
+
+                /// @param[in] arrayIndex For array entries, the array element to access.
+                /// @throws #PGE::Exception If there is no such entry, its size doesn't match T or the array index is out of bounds.
+                template <typename T>
+                const Accessor<T> getAccessor(const String::Key& name, int arrayIndex = 0) const {
+                    const LocationAndSize& locAndSize = getLocationAndSize(name);
+                    PGE_ASSERT(locAndSize.size == sizeof(T),
+                        "Entry \"" + String::hexFromInt(name.hash) + "\" size mismatch (expected " + String::from(locAndSize.size)
+                        + ", got " + String::from((int)sizeof(T)) + ")");
+                    PGE_ASSERT(arrayIndex >= 0 && arrayIndex < locAndSize.arraySize,
+                        "Entry \"" + String::hexFromInt(name.hash) + "\" array index out of bounds (" + String::from(arrayIndex)
+                        + " >= " + String::from(locAndSize.arraySize) + ")");
+                    return Accessor<T>(locAndSize.location + arrayIndex * locAndSize.arrayStride, getElementSize());
+                }
+                /// The entries in the order they are laid out in.
+                const std::vector<Entry>& getEntries() const;
+
+                /// Computed from the entries and packing, equal for structurally equal layouts.
+                size_t getHash() const;
 
                 bool operator==(const StructuredData::ElemLayout& other) const;
+                bool operator!=(const StructuredData::ElemLayout& other) const;
             private:
-                std::unordered_map<String::Key, LocationAndSize> entries;
-                int elementSize;
+                struct Interned {
+                    std::unordered_map<String::Key, LocationAndSize> entries;
+                    std::vector<Entry> orderedEntries;
+                    int elementSize = 0;
+                    Packing packing = Packing::TIGHT;
+                    size_t hash = 0;
+
+                    bool isStructurallyEqual(const Interned& other) const;
+                };
+
+                static std::shared_ptr<const Interned> intern(std::unique_ptr<Interned>&& candidate);
+
+                std::shared_ptr<const Interned> interned;
+        };
+
+        /// How #load gets the data into memory.
+        enum class LoadMode {
+            /// The data is read into memory owned by the StructuredData, in a single read.
+            READ,
+            /// The file is mapped into memory copy-on-write, the data is only read from disk once it's accessed.
+            /// The file must not be modified for as long as the data lives.
+            MAP,
+        };
+
+        /// A field of a struct declared with #PGE_REFLECT_LAYOUT_BEGIN.
+        struct ReflectedField {
+            const char* name;
+            int offset;
+            int size;
         };
 
+        /// Derives the layout of a struct declared with #PGE_REFLECT_LAYOUT_BEGIN.
+        /// The fields become entries in declaration order, with #ElemLayout::Packing::TIGHT.
+        /// @throws #PGE::Exception If the struct contains padding, which a tight layout can't represent.
+        template <typename T>
+        static const ElemLayout getReflectedLayout() {
+            static const ElemLayout layout = reflectLayout(ReflectedLayout<T>::getFields(), sizeof(T));
+            return layout;
+        }
+
         StructuredData() = default;
         StructuredData(const ElemLayout& ly, int elemCount);
 
+        /// Copies an array of a reflected struct in a single memcpy.
+        /// @see #getReflectedLayout
+        template <typename T>
+        StructuredData(const std::vector<T>& elements) : StructuredData(getReflectedLayout<T>(), (int)elements.size()) {
+            static_assert(std::is_trivially_copyable<T>::value);
+            if (size > 0) { memcpy(data, elements.data(), size); }
+        }
+        /// Takes over the memory of an array of a reflected struct, without copying.
+        /// @see #getReflectedLayout
+        template <typename T>
+        StructuredData(std::vector<T>&& elements) {
+            static_assert(std::is_trivially_copyable<T>::value);
+            std::shared_ptr<std::vector<T>> storage = std::make_shared<std::vector<T>>(std::move(elements));
+            layout = getReflectedLayout<T>();
+            size = (int)(storage->size() * sizeof(T));
+            capacity = size;
+            data = (byte*)storage->data();
+            externalStorage = std::move(storage);
+            markDirty(0, size);
+        }
+
         StructuredData(const StructuredData&) = delete;
         void operator=(const StructuredData&) = delete;
 
@@ -58,11 +209,76 @@ class StructuredData : NoHeap {
 
         StructuredData copy() const;
 
+        /// Writes the layout (packing, entry names, sizes and array sizes) followed by the raw data.
+        /// The data is written with native endianness, it's meant to be baked for and loaded on the same platform.
+        void save(BinaryWriter& writer) const;
+        /// @throws #PGE::Exception If the file could not be written.
+        void save(const FilePath& file) const;
+
+        /// Loads data previously written by #save.
+        /// @throws #PGE::Exception If the data is malformed.
+        static StructuredData load(BinaryReader& reader);
+        /// Loads data previously written by #save, and checks that it can be used with the expected layout.
+        /// Typically used with #PGE::Shader::getVertexLayout.
+        /// @throws #PGE::Exception If the data is malformed or its layout differs from the expected one.
+        static StructuredData load(BinaryReader& reader, const ElemLayout& expectedLayout);
+        /// @see #load(BinaryReader&)
+        static StructuredData load(const FilePath& file, LoadMode mode = LoadMode::READ);
+        /// @see #load(BinaryReader&, const ElemLayout&)
+        static StructuredData load(const FilePath& file, const ElemLayout& expectedLayout, LoadMode mode = LoadMode::READ);
+
         const byte* getData() const;
         int getDataSize() const;
         int getElementCount() const;
         const ElemLayout& getLayout() const;
 
+        // Growing and shrinking.
+        // Storage grows geometrically, shrinking never frees memory.
+        // Data loaded with LoadMode::MAP is copied into owned memory once it has to grow.
+
+        /// The number of elements that fit without reallocating.
+        int getCapacity() const;
+        /// Ensures that elemCount elements fit without reallocating.
+        void reserve(int elemCount);
+        /// Changes the element count, new elements are zeroed.
+        void resize(int elemCount);
+        /// Appends zeroed elements.
+        /// @returns The index of the first new element.
+        int append(int count = 1);
+        /// Appends copies of all elements of other.
+        /// @throws #PGE::Exception If the layouts differ.
+        void append(const StructuredData& other);
+        /// Overwrites the elements starting at firstElem with copies of all elements of other.
+        /// Grows if other extends past the end.
+        /// @throws #PGE::Exception If the layouts differ or firstElem is out of bounds.
+        void replace(int firstElem, const StructuredData& other);
+        /// Removes all elements, keeping the memory.
+        void clear();
+        /// Creates new data holding copies of the given elements, in the given order.
+        /// Elements may be repeated or left out.
+        /// @throws #PGE::Exception If an index is out of bounds.
+        StructuredData gather(const std::vector<int>& elemIndices) const;
+        /// Removes count elements starting at firstElem, later elements move forward.
+        /// @throws #PGE::Exception If the range exceeds the data.
+        void erase(int firstElem, int count);
+
+        // Dirty tracking.
+        // Every write through StructuredData's methods extends the dirty range,
+        // so that a consumer that keeps a copy of the data (e.g. a GPU buffer) only needs to update what changed.
+
+        struct ByteRange : private NoHeap {
+            ByteRange(int offs, int sz) : offset(offs), size(sz) { }
+
+            int offset;
+            int size;
+        };
+
+        /// The smallest range covering all bytes modified since the last call to #clearDirtyRange, clamped to the data size.
+        /// Newly constructed or loaded data is entirely dirty.
+        const ByteRange getDirtyRange() const;
+        bool isDirty() const;
+        void clearDirtyRange();
+
         template <typename T>
         void setValue(int elemIndex, const String& entryName, const T& value) {
             setValue(elemIndex, String::Key(entryName), value);
@@ -75,14 +291,215 @@ class StructuredData : NoHeap {
         void setValue(int elemIndex, const String::Key& entry, const Matrix4x4f& m);
         void setValue(int elemIndex, const String::Key& entry, const Color& c);
 
+        // Accessor based access.
+        // Unlike the key based methods these don't verify the element index, it is the caller's responsibility.
+        // Bulk operations verify the whole range once.
+
+        template <typename T>
+        const T getValue(int elemIndex, const ElemLayout::Accessor<T>& accessor) const {
+            T ret;
+            memcpy(&ret, data + (size_t)elemIndex * accessor.getStride() + accessor.getOffset(), sizeof(T));
+            return ret;
+        }
+
+        // T is only deduced from the accessor, so that e.g. literals convert.
+        template <typename T>
+        void setValue(int elemIndex, const ElemLayout::Accessor<T>& accessor, const typename std::enable_if<true, T>::type& value) {
+            int offset = elemIndex * accessor.getStride() + accessor.getOffset();
+            memcpy(data + offset, &value, sizeof(T));
+            markDirty(offset, offset + (int)sizeof(T));
+        }
+
+        /// Writes count contiguous values, starting at element firstElem.
+        /// @throws #PGE::Exception If the range exceeds the data.
+        template <typename T>
+        void setValues(int firstElem, const ElemLayout::Accessor<T>& accessor, const T* values, int count) {
+            assertRange(firstElem, count, accessor.getStride());
+            if (count == 0) { return; }
+            byte* dst = data + (size_t)firstElem * accessor.getStride() + accessor.getOffset();
+            markDirty((int)(dst - data), (int)(dst - data) + (count - 1) * accessor.getStride() + (int)sizeof(T));
+            if (accessor.getStride() == sizeof(T)) {
+                // The layout only consists of this field.
+                memcpy(dst, values, sizeof(T) * count);
+                return;
+            }
+            for (int i = 0; i < count; i++) {
+                memcpy(dst, &values[i], sizeof(T));
+                dst += accessor.getStride();
+            }
+        }
+
+        /// Reads count values into contiguous memory, starting at element firstElem.
+        /// @throws #PGE::Exception If the range exceeds the data.
+        template <typename T>
+        void getValues(int firstElem, const ElemLayout::Accessor<T>& accessor, T* values, int count) const {
+            assertRange(firstElem, count, accessor.getStride());
+            const byte* src = data + (size_t)firstElem * accessor.getStride() + accessor.getOffset();
+            for (int i = 0; i < count; i++) {
+                memcpy(&values[i], src, sizeof(T));
+                src += accessor.getStride();
+            }
+        }
+
+        /// A single field across all elements, usable in range-based for loops.
+        /// Dereferencing an iterator yields a reference, which can be read from and assigned to.
+        /// Invalidated if the data is moved.
+        template <typename T>
+        class View : private NoHeap {
+            public:
+                class Reference : private NoHeap {
+                    public:
+                        operator T() const { T ret; memcpy(&ret, ptr, sizeof(T)); return ret; }
+                        void operator=(const T& value) { memcpy(ptr, &value, sizeof(T)); }
+                        void operator=(const Reference& other) { memmove(ptr, other.ptr, sizeof(T)); }
+
+                        // Lets algorithms like std::sort exchange values through iterators.
+                        friend void swap(Reference a, Reference b) { T tmp = a; a = b; b = tmp; }
+
+                    private:
+                        friend class View;
+                        Reference(byte* p) : ptr(p) { }
+                        byte* ptr;
+                };
+
+                class Iterator : private NoHeap {
+                    public:
+                        using iterator_category = std::random_access_iterator_tag;
+                        using value_type = T;
+                        using difference_type = std::ptrdiff_t;
+                        using pointer = void;
+                        using reference = Reference;
+
+                        Iterator() : ptr(nullptr), stride(0) { }
+
+                        Reference operator*() const { return Reference(ptr); }
+                        Reference operator[](difference_type i) const { return Reference(ptr + i * stride); }
+
+                        // These return the iterator, unlike other operators in PGE, as standard algorithms rely on it.
+                        Iterator& operator++() { ptr += stride; return *this; }
+                        Iterator& operator--() { ptr -= stride; return *this; }
+                        const Iterator operator++(int) { Iterator ret = *this; ptr += stride; return ret; }
+                        const Iterator operator--(int) { Iterator ret = *this; ptr -= stride; return ret; }
+                        Iterator& operator+=(difference_type steps) { ptr += steps * stride; return *this; }
+                        Iterator& operator-=(difference_type steps) { ptr -= steps * stride; return *this; }
+                        const Iterator operator+(difference_type steps) const { return Iterator(ptr + steps * stride, stride); }
+                        friend const Iterator operator+(difference_type steps, const Iterator& it) { return it + steps; }
+                        const Iterator operator-(difference_type steps) const { return Iterator(ptr - steps * stride, stride); }
+                        difference_type operator-(const Iterator& other) const { return (ptr - other.ptr) / stride; }
+
+                        bool operator==(const Iterator& other) const { return ptr == other.ptr; }
+                        bool operator!=(const Iterator& other) const { return ptr != other.ptr; }
+                        bool operator<(const Iterator& other) const { return ptr < other.ptr; }
+                        bool operator>(const Iterator& other) const { return ptr > other.ptr; }
+                        bool operator<=(const Iterator& other) const { return ptr <= other.ptr; }
+                        bool operator>=(const Iterator& other) const { return ptr >= other.ptr; }
+
+                    private:
+                        friend class View;
+                        Iterator(byte* p, int strd) : ptr(p), stride(strd) { }
+                        byte* ptr;
+                        int stride;
+                };
+
+                const Iterator begin() const { return Iterator(first, stride); }
+                const Iterator end() const { return Iterator(first + (std::ptrdiff_t)count * stride, stride); }
+                int size() const { return count; }
+                Reference operator[](int i) const { return Reference(first + (std::ptrdiff_t)i * stride); }
+
+            private:
+                friend class StructuredData;
+                View(byte* frst, int strd, int cnt) : first(frst), stride(strd), count(cnt) { }
+                byte* first;
+                int stride;
+                int count;
+        };
+
+        /// Marks all data dirty, as writes through the view can't be tracked.
+        template <typename T>
+        const View<T> getView(const ElemLayout::Accessor<T>& accessor) {
+            markDirty(0, size);
+            return View<T>(data + accessor.getOffset(), accessor.getStride(), getElementCount());
+        }
+
+        // Bulk operations on a single field of every element.
+        // The data is processed in place, in blocks that are temporarily transposed into one array per component
+        // so that they can be vectorized. Large element counts are spread across threads.
+
+        /// Transforms every value as #PGE::Matrix4x4f::transform does.
+        /// Vector3f fields are treated as points (w = 1), Vector4f fields are transformed as they are.
+        /// @throws #PGE::Exception If the field is neither a Vector3f nor a Vector4f.
+        void transform(const String::Key& entry, const Matrix4x4f& matrix, bool allowParallel = true);
+        /// Transforms every direction (w = 0) in a Vector3f field and normalizes it.
+        /// For matrices with non-uniform scaling pass the inverse transpose.
+        /// @throws #PGE::Exception If the field is not a Vector3f.
+        void transformNormals(const String::Key& entry, const Matrix4x4f& matrix, bool allowParallel = true);
+        /// Sets every value to value * scale + offset.
+        /// @throws #PGE::Exception If the field is not a Vector2f.
+        void scaleAndOffset(const String::Key& entry, const Vector2f& scale, const Vector2f& offset, bool allowParallel = true);
+        /// Computes the bounds of all values in a Vector3f field, or of the xyz components of a Vector4f field.
+        /// @returns An empty box at the origin if there are no elements.
+        /// @throws #PGE::Exception If the field is neither a Vector3f nor a Vector4f.
+        const AABBox computeBounds(const String::Key& entry, bool allowParallel = true) const;
+        /// Computes the bounds of count values starting at element firstElem.
+        /// @throws #PGE::Exception If the field is neither a Vector3f nor a Vector4f, or the range exceeds the data.
+        const AABBox computeBounds(const String::Key& entry, int firstElem, int count, bool allowParallel = true) const;
+
     private:
-        int getDataIndex(int elemIndex, const String::Key& entry, int expectedSize) const;
+        // Only used for writing, marks the value dirty.
+        int getDataIndex(int elemIndex, const String::Key& entry, int expectedSize);
+        void assertRange(int firstElem, int count, int stride) const;
+        void reallocate(int newCapacity);
+
+        void markDirty(int begin, int end) {
+            dirtyBegin = std::min(dirtyBegin, begin);
+            dirtyEnd = std::max(dirtyEnd, end);
+        }
+
+        static const ElemLayout reflectLayout(const std::vector<ReflectedField>& fields, int structSize);
+
+        static int readHeader(BinaryReader& reader, ElemLayout& layout, int& elemCount);
+        static StructuredData load(BinaryReader& reader, const ElemLayout* expectedLayout);
+        static StructuredData load(const FilePath& file, const ElemLayout* expectedLayout, LoadMode mode);
 
         ElemLayout layout; //don't change this to a pointer, stop preemptively optimizing!!!!!
-        std::unique_ptr<byte[]> data;
-        int size;
+        // Either owned or pointing into a mapped file.
+        byte* data = nullptr;
+        std::unique_ptr<byte[]> ownedData;
+        // A mapped file or an adopted vector.
+        std::shared_ptr<const void> externalStorage;
+        int size = 0;
+        // In bytes, like size.
+        int capacity = 0;
+        // [dirtyBegin, dirtyEnd) in bytes, empty if dirtyBegin >= dirtyEnd.
+        int dirtyBegin = std::numeric_limits<int>::max();
+        int dirtyEnd = 0;
 };
 
 }
 
+/// Declares the fields of a struct, so that arrays of it can be stored in #PGE::StructuredData as they are.
+/// Must be used at global scope, fields must be listed in declaration order.
+/// ```
+/// struct Vertex { Vector3f position; Vector2f uv; Color color; };
+/// PGE_REFLECT_LAYOUT_BEGIN(Vertex)
+///     PGE_REFLECT_FIELD(position)
+///     PGE_REFLECT_FIELD(uv)
+///     PGE_REFLECT_FIELD(color)
+/// PGE_REFLECT_LAYOUT_END()
+///
+/// mesh->setGeometry(StructuredData(std::move(vertices)), triangles);
+/// ```
+/// @see #PGE::StructuredData::getReflectedLayout
+#define PGE_REFLECT_LAYOUT_BEGIN(Type) \
+    template <> struct PGE::ReflectedLayout<Type> { \
+        using ReflectedType = Type; \
+        static const std::vector<PGE::StructuredData::ReflectedField> getFields() { \
+            return {
+#define PGE_REFLECT_FIELD(field) \
+                PGE::StructuredData::ReflectedField{ #field, (int)offsetof(ReflectedType, field), (int)sizeof(ReflectedType::field) },
+#define PGE_REFLECT_LAYOUT_END() \
+            }; \
+        } \
+    };
+
 #endif // PGE_MEMORYLAYOUT_H_INCLUDED
@@ -14,14 +14,37 @@ using namespace PGE;
 BinaryReader::BinaryReader(const FilePath& file)
     : AbstractIO(file) { }
 
+BinaryReader::BinaryReader(const byte* data, size_t size) {
+    PGE_ASSERT(data != nullptr || size == 0, "Tried reading from nullptr");
+    inMemory = true;
+    memoryPosition = data;
+    memoryEnd = data + size;
+}
+
+bool BinaryReader::isInMemory() const {
+    return inMemory;
+}
+
+void BinaryReader::earlyClose() {
+    if (isInMemory()) {
+        // Any further reads fail.
+        memoryPosition = memoryEnd;
+        memoryEndReached = true;
+        return;
+    }
+    AbstractIO::earlyClose();
+}
+
 bool BinaryReader::endOfFile() const {
+    if (isInMemory()) {
+        return memoryEndReached;
+    }
     return stream.eof();
 }
 
 template <typename T>
 bool BinaryReader::tryRead(T& out) {
-    stream.read((char*)&out, sizeof(T));
-    return stream.good();
+    return readRaw(&out, sizeof(T));
 }
 
 #define PGE_IO_DEFAULT_SPEC(T) template bool BinaryReader::tryRead(T& out)
@@ -81,8 +104,7 @@ template<> bool BinaryReader::tryRead(Vector2i& out) {
 }
 
 template<> bool BinaryReader::tryRead(Matrix4x4f& out) {
-    stream.read((char*)out.elements, sizeof(float) * 4 * 4);
-    return stream.good();
+    return readRaw(out.elements, sizeof(float) * 4 * 4);
 }
 
 template<> bool BinaryReader::tryRead(AABBox& out) {
@@ -128,8 +150,11 @@ template<> bool BinaryReader::tryRead(Rectanglei& out) {
 
 bool BinaryReader::tryReadBytes(size_t count, std::vector<byte>& out) {
     out.resize(count);
-    stream.read((char*)out.data(), count);
-    return stream.good();
+    return readRaw(out.data(), count);
+}
+
+bool BinaryReader::tryReadBytes(size_t count, byte* out) {
+    return readRaw(out, count);
 }
 
 const std::vector<byte> BinaryReader::readBytes(size_t count) {
@@ -142,8 +167,16 @@ void BinaryReader::readBytesInto(size_t count, std::vector<byte>& out) {
     PGE_ASSERT(tryReadBytes(count, out), BAD_STREAM);
 }
 
-
 bool BinaryReader::trySkip(size_t length) {
+    if (isInMemory()) {
+        if (length > (size_t)(memoryEnd - memoryPosition)) {
+            memoryPosition = memoryEnd;
+            memoryEndReached = true;
+            return false;
+        }
+        memoryPosition += length;
+        return true;
+    }
     stream.ignore(length);
     return stream.good();
 }
@@ -14,10 +14,41 @@ using namespace PGE;
 BinaryWriter::BinaryWriter(const FilePath& file, bool append)
     : AbstractIO(file, std::ios::binary | (append ? std::ios::app : std::ios::trunc)) { }
 
+BinaryWriter::BinaryWriter() {
+    inMemory = true;
+}
+
+bool BinaryWriter::isInMemory() const {
+    return inMemory;
+}
+
+void BinaryWriter::earlyClose() {
+    if (inMemory) { return; }
+    AbstractIO::earlyClose();
+}
+
+void BinaryWriter::reserve(size_t size) {
+    memory.reserve(size);
+}
+
+const byte* BinaryWriter::getData() const {
+    return memory.data();
+}
+
+size_t BinaryWriter::getSize() const {
+    return memory.size();
+}
+
+const std::vector<byte> BinaryWriter::release() {
+    PGE_ASSERT(inMemory, "Tried releasing the memory of a file writer");
+    std::vector<byte> ret = std::move(memory);
+    memory = std::vector<byte>();
+    return ret;
+}
+
 template <typename T>
 void BinaryWriter::write(const T& t) {
-    stream.write((char*)&t, sizeof(T));
-    validate();
+    writeRaw(&t, sizeof(T));
 }
 
 #define PGE_IO_DEFAULT_SPEC(T) template void BinaryWriter::write(const T& val)
@@ -37,13 +68,11 @@ PGE_IO_DEFAULT_SPEC(long double);
 template<> void BinaryWriter::write(const char16& val) {
     char buf[4];
     byte len = Unicode::wCharToUtf8(val, buf);
-    stream.write(buf, len);
-    validate();
+    writeRaw(buf, len);
 }
 
 template<> void BinaryWriter::write(const String& val) {
-    stream.write(val.cstr(), val.byteLength() + 1);
-    validate();
+    writeRaw(val.cstr(), val.byteLength() + 1);
 }
 
 template<> void BinaryWriter::write(const Vector2f& val) {
@@ -96,6 +125,5 @@ template<> void BinaryWriter::write(const Rectanglei& val) {
 
 // TODO: C++20 range.
 void BinaryWriter::writeBytes(const byte* data, size_t amount) {
-    stream.write((char*)data, amount);
-    validate();
+    writeRaw(data, amount);
 }
@@ -0,0 +1,202 @@
+#include <PGE/File/FileWatcher.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#include <PGE/Exception/Exception.h>
+
+using namespace PGE;
+
+#ifdef __linux__
+static constexpr u32 INOTIFY_MASK = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE;
+#endif
+
+FileWatcher::FileWatcher() {
+#ifdef __linux__
+    nativeInstance = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+    setPollingInterval(500);
+    lastPoll = std::chrono::steady_clock::now();
+}
+
+FileWatcher::~FileWatcher() {
+#ifdef __linux__
+    if (nativeInstance >= 0) {
+        // Closing the instance removes all of its watches.
+        close(nativeInstance);
+    }
+#endif
+}
+
+bool FileWatcher::isNative() const {
+    return nativeInstance >= 0;
+}
+
+void FileWatcher::setPollingInterval(int ms) {
+    pollingInterval = std::chrono::milliseconds(ms);
+}
+
+void FileWatcher::watch(const FilePath& path) {
+    PGE_ASSERT(path.isValid(), "Tried watching an invalid path");
+
+    bool isDir = path.isDirectory();
+    FilePath dirPath = isDir ? path.makeDirectory() : path.getParentDirectory();
+
+    auto it = directories.find(dirPath.str());
+    if (it == directories.end()) {
+        WatchedDirectory dir;
+        dir.path = dirPath;
+#ifdef __linux__
+        if (nativeInstance >= 0) {
+            dir.nativeHandle = inotify_add_watch(nativeInstance, dirPath.str().cstr(), INOTIFY_MASK);
+            PGE_ASSERT(dir.nativeHandle >= 0, "Failed to watch directory (dir: " + dirPath.str() + "; errno: " + String::from(errno) + ")");
+            nativeHandles.emplace(dir.nativeHandle, dirPath.str());
+        }
+#endif
+        it = directories.emplace(dirPath.str(), dir).first;
+    }
+
+    WatchedDirectory& dir = it->second;
+    if (isDir) {
+        dir.wholeDirectoryRefs++;
+    } else {
+        dir.fileRefs[path.str().substr(dirPath.str().length())]++;
+    }
+
+    if (!isNative()) {
+        // Establish a baseline, so that only later modifications are reported.
+        snapshot(dir, false);
+    }
+}
+
+void FileWatcher::unwatch(const FilePath& path) {
+    if (!path.isValid()) { return; }
+
+    // The path might not exist anymore, so we can't ask the file system whether it's a directory.
+    auto it = directories.find(path.makeDirectory().str());
+    bool isDir = it != directories.end();
+    if (!isDir) {
+        it = directories.find(path.getParentDirectory().str());
+        if (it == directories.end()) { return; }
+    }
+
+    WatchedDirectory& dir = it->second;
+    if (isDir) {
+        if (dir.wholeDirectoryRefs <= 0) { return; }
+        dir.wholeDirectoryRefs--;
+    } else {
+        auto fileIt = dir.fileRefs.find(path.str().substr(dir.path.str().length()));
+        if (fileIt == dir.fileRefs.end()) { return; }
+        fileIt->second--;
+        if (fileIt->second <= 0) {
+            dir.fileRefs.erase(fileIt);
+        }
+    }
+
+    if (dir.wholeDirectoryRefs <= 0 && dir.fileRefs.empty()) {
+#ifdef __linux__
+        if (dir.nativeHandle >= 0) {
+            inotify_rm_watch(nativeInstance, dir.nativeHandle);
+            nativeHandles.erase(dir.nativeHandle);
+        }
+#endif
+        directories.erase(it);
+    }
+}
+
+bool FileWatcher::isWatched(const WatchedDirectory& dir, const String& fileName) const {
+    return dir.wholeDirectoryRefs > 0 || dir.fileRefs.find(fileName) != dir.fileRefs.end();
+}
+
+void FileWatcher::reportChange(const WatchedDirectory& dir, const String& fileName) {
+    FilePath file = dir.path + fileName;
+    if (changeSet.emplace(file.str()).second) {
+        changes.emplace_back(file);
+    }
+}
+
+const std::vector<FilePath>& FileWatcher::update() {
+    changes.clear();
+    changeSet.clear();
+
+    if (isNative()) {
+        readNativeEvents();
+    } else {
+        poll();
+    }
+
+    return changes;
+}
+
+void FileWatcher::readNativeEvents() {
+#ifdef __linux__
+    alignas(inotify_event) char buffer[4096];
+    while (true) {
+        ssize_t length = read(nativeInstance, buffer, sizeof(buffer));
+        if (length <= 0) {
+            // EAGAIN, nothing left to read.
+            break;
+        }
+
+        for (ssize_t i = 0; i < length;) {
+            const inotify_event* event = (const inotify_event*)(buffer + i);
+            i += sizeof(inotify_event) + event->len;
+
+            if (event->len == 0 || (event->mask & IN_ISDIR) != 0) { continue; }
+
+            auto handleIt = nativeHandles.find(event->wd);
+            if (handleIt == nativeHandles.end()) { continue; }
+            auto dirIt = directories.find(handleIt->second);
+            if (dirIt == directories.end()) { continue; }
+
+            String fileName = event->name;
+            if (isWatched(dirIt->second, fileName)) {
+                reportChange(dirIt->second, fileName);
+            }
+        }
+    }
+#endif
+}
+
+void FileWatcher::poll() {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now - lastPoll < pollingInterval) { return; }
+    lastPoll = now;
+
+    for (auto& [key, dir] : directories) {
+        snapshot(dir, true);
+    }
+}
+
+void FileWatcher::snapshot(WatchedDirectory& dir, bool report) {
+    if (!dir.path.exists()) { return; }
+
+    int dirLength = dir.path.str().length();
+    auto check = [&](const FilePath& file) {
+        String fileName = file.str().substr(dirLength);
+        u64 modifyTime;
+        try {
+            modifyTime = file.getLastModifyTime();
+        } catch (const Exception&) {
+            // Deleted while we were looking at it.
+            return;
+        }
+        auto [it, inserted] = dir.modifyTimes.emplace(fileName, modifyTime);
+        if (!inserted && it->second != modifyTime) {
+            it->second = modifyTime;
+            if (report) { reportChange(dir, fileName); }
+        } else if (inserted && report) {
+            // Newly created.
+            reportChange(dir, fileName);
+        }
+    };
+
+    for (const FilePath& file : dir.path.enumerateFiles(false)) {
+        if (isWatched(dir, file.str().substr(dirLength))) {
+            check(file);
+        }
+    }
+}
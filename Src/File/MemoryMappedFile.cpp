@@ -0,0 +1,93 @@
+#include <PGE/File/MemoryMappedFile.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#include <PGE/Exception/Exception.h>
+
+using namespace PGE;
+
+MemoryMappedFile::MemoryMappedFile(const FilePath& file, Access access) : access(access) {
+    PGE_ASSERT(file.isValid(), "Tried mapping an invalid path");
+    data = nullptr;
+    size = 0;
+
+#ifdef _WIN32
+    fileHandle = CreateFileW(file.str().wstr().data(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    PGE_ASSERT(fileHandle != INVALID_HANDLE_VALUE, "Could not open (file: \"" + file.str() + "\"; error: " + String::from((u32)GetLastError()) + ")");
+    mappingHandle = NULL;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize)) {
+        CloseHandle(fileHandle);
+        throw PGE_CREATE_EX("Could not get file size (file: \"" + file.str() + "\")");
+    }
+    size = (size_t)fileSize.QuadPart;
+    // Empty files cannot be mapped.
+    if (size == 0) { return; }
+
+    mappingHandle = CreateFileMappingW(fileHandle, NULL, access == Access::COPY_ON_WRITE ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, NULL);
+    if (mappingHandle == NULL) {
+        CloseHandle(fileHandle);
+        throw PGE_CREATE_EX("Could not map file (file: \"" + file.str() + "\"; error: " + String::from((u32)GetLastError()) + ")");
+    }
+    data = (byte*)MapViewOfFile(mappingHandle, access == Access::COPY_ON_WRITE ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr) {
+        CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        throw PGE_CREATE_EX("Could not map file (file: \"" + file.str() + "\"; error: " + String::from((u32)GetLastError()) + ")");
+    }
+#else
+    int fd = open(file.str().cstr(), O_RDONLY | O_CLOEXEC);
+    PGE_ASSERT(fd >= 0, "Could not open (file: \"" + file.str() + "\"; errno: " + String::from(errno) + ")");
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0) {
+        close(fd);
+        throw PGE_CREATE_EX("Could not get file size (file: \"" + file.str() + "\")");
+    }
+    size = (size_t)fileStat.st_size;
+    // Empty files cannot be mapped.
+    if (size == 0) {
+        close(fd);
+        return;
+    }
+
+    int protection = access == Access::COPY_ON_WRITE ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void* mapping = mmap(nullptr, size, protection, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file.
+    close(fd);
+    PGE_ASSERT(mapping != MAP_FAILED, "Could not map file (file: \"" + file.str() + "\"; errno: " + String::from(errno) + ")");
+    data = (byte*)mapping;
+#endif
+}
+
+MemoryMappedFile::~MemoryMappedFile() {
+#ifdef _WIN32
+    if (data != nullptr) { UnmapViewOfFile(data); }
+    if (mappingHandle != NULL) { CloseHandle(mappingHandle); }
+    CloseHandle(fileHandle);
+#else
+    if (data != nullptr) { munmap(data, size); }
+#endif
+}
+
+const byte* MemoryMappedFile::getData() const {
+    return data;
+}
+
+byte* MemoryMappedFile::getWritableData() {
+    PGE_ASSERT(access == Access::COPY_ON_WRITE, "Tried writing to a read-only mapping");
+    return data;
+}
+
+size_t MemoryMappedFile::getSize() const {
+    return size;
+}
@@ -1,16 +1,224 @@
 #include <PGE/File/TextWriter.h>
 
+#include <cstdio>
+#include <algorithm>
+
 using namespace PGE;
 
-TextWriter::TextWriter(const FilePath& file)
-	: AbstractIO(file, 0) { }
+TextWriter::TextWriter(const FilePath& file, FlushPolicy policy, int bufferSize)
+	: AbstractIO(file, 0), policy(policy), bufferSize(bufferSize) {
+	PGE_ASSERT(bufferSize > 0, "Buffer size must be positive (size: " + String::from(bufferSize) + ")");
+	open = true;
+	buffer = std::make_unique<char[]>(bufferSize);
+	bufferUsed = 0;
+
+	backBufferUsed = 0;
+	backBufferPending = false;
+	stopFlushThread = false;
+	flushFailed = false;
+	if (policy == FlushPolicy::BACKGROUND) {
+		backBuffer = std::make_unique<char[]>(bufferSize);
+		flushThread = std::thread(&TextWriter::runFlushThread, this);
+	}
+}
+
+TextWriter::~TextWriter() {
+	try {
+		if (open) { writeBuffer(); }
+	} catch (const Exception&) {
+		// Swallowed, see earlyClose.
+	}
+	stopBackgroundFlushing();
+}
+
+void TextWriter::ensureOpen() {
+	PGE_ASSERT(open, BAD_STREAM);
+}
+
+void TextWriter::writeBuffer() {
+	if (bufferUsed == 0) { return; }
+	if (policy == FlushPolicy::BACKGROUND) {
+		handOff();
+	} else {
+		stream.write(buffer.get(), bufferUsed);
+		stream.flush();
+		bufferUsed = 0;
+		if (!stream.good()) {
+			open = false;
+		}
+		validate();
+	}
+}
+
+void TextWriter::flush() {
+	ensureOpen();
+	writeBuffer();
+	if (policy == FlushPolicy::BACKGROUND) {
+		waitForFlushThread();
+	}
+}
+
+void TextWriter::earlyClose() {
+	if (open) {
+		flush();
+		open = false;
+	}
+	stopBackgroundFlushing();
+	AbstractIO::earlyClose();
+}
+
+void TextWriter::append(const char* data, int size) {
+	ensureOpen();
+	while (size > 0) {
+		int count = std::min(size, bufferSize - bufferUsed);
+		memcpy(buffer.get() + bufferUsed, data, count);
+		bufferUsed += count;
+		data += count;
+		size -= count;
+		if (bufferUsed == bufferSize) {
+			writeBuffer();
+		}
+	}
+}
+
+template <typename... Args>
+void TextWriter::appendFormatted(const char* format, const Args&... args) {
+	ensureOpen();
+	// Formats straight into the buffer if there's enough space, otherwise flushes and tries again.
+	int size = snprintf(buffer.get() + bufferUsed, bufferSize - bufferUsed, format, args...);
+	if (size < bufferSize - bufferUsed) {
+		bufferUsed += size;
+		return;
+	}
+	writeBuffer();
+	if (size < bufferSize - bufferUsed) {
+		bufferUsed += snprintf(buffer.get() + bufferUsed, bufferSize - bufferUsed, format, args...);
+		return;
+	}
+	// Larger than the whole buffer, only happens with tiny buffers.
+	std::unique_ptr<char[]> tmp = std::make_unique<char[]>(size + 1);
+	snprintf(tmp.get(), size + 1, format, args...);
+	append(tmp.get(), size);
+}
+
+void TextWriter::endLine() {
+	append("\n", 1);
+	if (policy == FlushPolicy::EVERY_LINE) {
+		writeBuffer();
+	} else if (policy == FlushPolicy::BACKGROUND && !backBufferPending) {
+		// The thread is idle, so there's no reason to hold on to completed lines.
+		handOff();
+	}
+}
 
 void TextWriter::write(const String& content) {
-	stream.write(content.cstr(), content.byteLength());
-	validate();
+	append(content.cstr(), content.byteLength());
+}
+
+void TextWriter::write(char ch) {
+	append(&ch, 1);
+}
+
+void TextWriter::write(int value) {
+	appendFormatted("%d", value);
+}
+
+void TextWriter::write(long value) {
+	appendFormatted("%ld", value);
+}
+
+void TextWriter::write(long long value) {
+	appendFormatted("%lld", value);
 }
 
-void TextWriter::writeLine(const String& content) {
-	write(content);
-	stream.write("\n", 1);
+void TextWriter::write(unsigned value) {
+	appendFormatted("%u", value);
+}
+
+void TextWriter::write(unsigned long value) {
+	appendFormatted("%lu", value);
+}
+
+void TextWriter::write(unsigned long long value) {
+	appendFormatted("%llu", value);
+}
+
+void TextWriter::write(float value) {
+	appendFormatted("%f", (double)value);
+}
+
+void TextWriter::write(double value) {
+	appendFormatted("%f", value);
+}
+
+void TextWriter::write(const Vector2f& value) {
+	appendFormatted("(%f, %f)", (double)value.x, (double)value.y);
+}
+
+void TextWriter::write(const Vector3f& value) {
+	appendFormatted("(%f, %f, %f)", (double)value.x, (double)value.y, (double)value.z);
+}
+
+void TextWriter::write(const Vector4f& value) {
+	appendFormatted("(%f, %f, %f, %f)", (double)value.x, (double)value.y, (double)value.z, (double)value.w);
+}
+
+void TextWriter::write(const Vector2i& value) {
+	appendFormatted("(%d, %d)", value.x, value.y);
+}
+
+void TextWriter::handOff() {
+	std::unique_lock<std::mutex> lock(flushMutex);
+	flushCondition.wait(lock, [this]() { return !backBufferPending; });
+	if (flushFailed) {
+		open = false;
+		throw PGE_CREATE_EX(BAD_STREAM);
+	}
+	std::swap(buffer, backBuffer);
+	backBufferUsed = bufferUsed;
+	bufferUsed = 0;
+	backBufferPending = true;
+	flushCondition.notify_all();
+}
+
+void TextWriter::waitForFlushThread() {
+	std::unique_lock<std::mutex> lock(flushMutex);
+	flushCondition.wait(lock, [this]() { return !backBufferPending; });
+	if (flushFailed) {
+		open = false;
+		throw PGE_CREATE_EX(BAD_STREAM);
+	}
+}
+
+void TextWriter::stopBackgroundFlushing() {
+	if (!flushThread.joinable()) { return; }
+	{
+		std::lock_guard<std::mutex> lock(flushMutex);
+		stopFlushThread = true;
+	}
+	flushCondition.notify_all();
+	flushThread.join();
+}
+
+void TextWriter::runFlushThread() {
+	std::unique_lock<std::mutex> lock(flushMutex);
+	while (true) {
+		flushCondition.wait(lock, [this]() { return backBufferPending || stopFlushThread; });
+		if (!backBufferPending) {
+			// Asked to stop and nothing left to write.
+			break;
+		}
+
+		// The main thread doesn't touch the back buffer or the stream while a buffer is pending.
+		lock.unlock();
+		stream.write(backBuffer.get(), backBufferUsed);
+		stream.flush();
+		bool good = stream.good();
+		lock.lock();
+
+		flushFailed = flushFailed || !good;
+		backBufferUsed = 0;
+		backBufferPending = false;
+		flushCondition.notify_all();
+	}
 }
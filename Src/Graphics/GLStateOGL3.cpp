@@ -0,0 +1,198 @@
+#include "GLStateOGL3.h"
+
+#include <PGE/Exception/Exception.h>
+
+using namespace PGE;
+
+void GLStateOGL3::useProgram(GLuint prog) {
+    if (update(Category::PROGRAM, program, prog)) {
+        glUseProgram(prog);
+    }
+}
+
+void GLStateOGL3::bindVertexArray(GLuint vao) {
+    if (update(Category::VERTEX_ARRAY, vertexArray, vao)) {
+        glBindVertexArray(vao);
+    }
+}
+
+GLuint* GLStateOGL3::getBufferBinding(GLenum target) {
+    switch (target) {
+        case GL_ARRAY_BUFFER: { return &arrayBuffer; }
+        case GL_UNIFORM_BUFFER: { return &uniformBuffer; }
+        case GL_PIXEL_UNPACK_BUFFER: { return &pixelUnpackBuffer; }
+        default: { return nullptr; }
+    }
+}
+
+void GLStateOGL3::bindBuffer(GLenum target, GLuint buffer) {
+    GLuint* binding = getBufferBinding(target);
+    if (binding == nullptr) {
+        counters[(size_t)Category::BUFFER].issued++;
+        glBindBuffer(target, buffer);
+    } else if (update(Category::BUFFER, *binding, buffer)) {
+        glBindBuffer(target, buffer);
+    }
+}
+
+void GLStateOGL3::bindUniformBufferBase(GLuint index, GLuint buffer) {
+    if (uniformBufferBases.size() <= index) {
+        uniformBufferBases.resize((size_t)index + 1, 0);
+    }
+    if (update(Category::BUFFER, uniformBufferBases[index], buffer)) {
+        glBindBufferBase(GL_UNIFORM_BUFFER, index, buffer);
+        uniformBuffer = buffer;
+    }
+}
+
+void GLStateOGL3::bindTexture(int unit, GLuint texture) {
+    PGE_ASSERT(unit >= 0 && unit < MAX_TEXTURE_UNITS, "Texture unit out of range (" + String::from(unit) + ")");
+    if (update(Category::TEXTURE, textures[unit], texture)) {
+        if (activeTextureUnit != unit) {
+            activeTextureUnit = unit;
+            glActiveTexture(GL_TEXTURE0 + unit);
+        }
+        glBindTexture(GL_TEXTURE_2D, texture);
+    }
+}
+
+void GLStateOGL3::bindTextureForEditing(GLuint texture) {
+    bindTexture(0, texture);
+    if (activeTextureUnit != 0) {
+        activeTextureUnit = 0;
+        glActiveTexture(GL_TEXTURE0);
+    }
+}
+
+void GLStateOGL3::setUnpackAlignment(GLint alignment) {
+    if (update(Category::TEXTURE, unpackAlignment, alignment)) {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+    }
+}
+
+void GLStateOGL3::bindFramebuffer(GLuint fb) {
+    if (update(Category::FRAMEBUFFER, framebuffer, fb)) {
+        glBindFramebuffer(GL_FRAMEBUFFER, fb);
+    }
+}
+
+void GLStateOGL3::setDepthMask(bool write) {
+    if (update(Category::MASK, depthMask, write)) {
+        glDepthMask(write);
+    }
+}
+
+void GLStateOGL3::setColorMask(bool red, bool green, bool blue, bool alpha) {
+    if (update(Category::MASK, colorMask, { red, green, blue, alpha })) {
+        glColorMask(red, green, blue, alpha);
+    }
+}
+
+void GLStateOGL3::setBlend(bool enabled) {
+    if (update(Category::BLEND, blend, enabled)) {
+        if (enabled) {
+            glEnable(GL_BLEND);
+        } else {
+            glDisable(GL_BLEND);
+        }
+    }
+}
+
+void GLStateOGL3::setBlendFunc(GLenum srcColor, GLenum dstColor, GLenum srcAlpha, GLenum dstAlpha) {
+    if (update(Category::BLEND, blendFunc, { srcColor, dstColor, srcAlpha, dstAlpha })) {
+        glBlendFuncSeparate(srcColor, dstColor, srcAlpha, dstAlpha);
+    }
+}
+
+void GLStateOGL3::setDepthTest(bool enabled) {
+    if (update(Category::DEPTH, depthTest, enabled)) {
+        if (enabled) {
+            glEnable(GL_DEPTH_TEST);
+        } else {
+            glDisable(GL_DEPTH_TEST);
+        }
+    }
+}
+
+void GLStateOGL3::setCulling(bool enabled) {
+    if (update(Category::CULL, culling, enabled)) {
+        if (enabled) {
+            glEnable(GL_CULL_FACE);
+        } else {
+            glDisable(GL_CULL_FACE);
+        }
+    }
+}
+
+void GLStateOGL3::setCullFace(GLenum face) {
+    if (update(Category::CULL, cullFace, face)) {
+        glCullFace(face);
+    }
+}
+
+void GLStateOGL3::countUniformUpload(bool issued) {
+    Counter& counter = counters[(size_t)Category::UNIFORM];
+    if (issued) {
+        counter.issued++;
+    } else {
+        counter.skipped++;
+    }
+}
+
+void GLStateOGL3::forgetProgram(GLuint prog) {
+    if (program == prog) { program = 0; }
+}
+
+void GLStateOGL3::forgetVertexArray(GLuint vao) {
+    if (vertexArray == vao) { vertexArray = 0; }
+}
+
+void GLStateOGL3::forgetBuffer(GLuint buffer) {
+    for (GLuint* binding : { &arrayBuffer, &uniformBuffer, &pixelUnpackBuffer }) {
+        if (*binding == buffer) { *binding = 0; }
+    }
+    for (GLuint& binding : uniformBufferBases) {
+        if (binding == buffer) { binding = 0; }
+    }
+}
+
+void GLStateOGL3::forgetTexture(GLuint texture) {
+    for (GLuint& binding : textures) {
+        if (binding == texture) { binding = 0; }
+    }
+}
+
+void GLStateOGL3::forgetFramebuffer(GLuint fb) {
+    if (framebuffer == fb) { framebuffer = 0; }
+}
+
+const GLStateOGL3::Counter& GLStateOGL3::getCounter(Category category) const {
+    return counters[(size_t)category];
+}
+
+void GLStateOGL3::resetCounters() {
+    counters = { };
+}
+
+const String GLStateOGL3::getInfo() const {
+    static const char* names[] = {
+        "program",
+        "vertex array",
+        "buffer",
+        "texture",
+        "framebuffer",
+        "mask",
+        "blend",
+        "depth",
+        "cull",
+        "uniform",
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == (size_t)Category::COUNT);
+
+    String info;
+    for (int i = 0; i < (int)Category::COUNT; i++) {
+        info += "\n" + String(names[i]) + " state changes (issued/skipped): "
+            + String::from(counters[i].issued) + "/" + String::from(counters[i].skipped);
+    }
+    return info;
+}
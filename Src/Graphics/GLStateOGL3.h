@@ -0,0 +1,123 @@
+#ifndef PGEINTERNAL_GLSTATEOGL3_H_INCLUDED
+#define PGEINTERNAL_GLSTATEOGL3_H_INCLUDED
+
+#include <array>
+#include <vector>
+
+#include <glad/gl.h>
+
+#include <PGE/String/String.h>
+
+namespace PGE {
+
+/// Shadows the state of a GL context, so setting what is already set doesn't reach the driver.
+/// All state changes of the backend must go through here, otherwise the shadow goes stale.
+/// The context must be current when calling any of the setters.
+class GLStateOGL3 {
+    public:
+        enum class Category {
+            PROGRAM,
+            VERTEX_ARRAY,
+            BUFFER,
+            TEXTURE,
+            FRAMEBUFFER,
+            MASK,
+            BLEND,
+            DEPTH,
+            CULL,
+            UNIFORM,
+            COUNT,
+        };
+
+        struct Counter {
+            int issued = 0;
+            int skipped = 0;
+        };
+
+        static constexpr int MAX_TEXTURE_UNITS = 8;
+
+        GLStateOGL3() = default;
+        GLStateOGL3(const GLStateOGL3&) = delete;
+        void operator=(const GLStateOGL3&) = delete;
+
+        void useProgram(GLuint program);
+        void bindVertexArray(GLuint vertexArray);
+        /// GL_ELEMENT_ARRAY_BUFFER is part of the vertex array state and is always passed through.
+        void bindBuffer(GLenum target, GLuint buffer);
+        /// Also binds the buffer to the generic target, as glBindBufferBase does.
+        void bindUniformBufferBase(GLuint index, GLuint buffer);
+        /// Leaves the active unit alone if the texture is already bound, so only meant for drawing.
+        void bindTexture(int unit, GLuint texture);
+        /// Binds the texture to unit 0 and makes that the active unit, which texture commands such as glTexImage2D apply to.
+        void bindTextureForEditing(GLuint texture);
+        /// GL_UNPACK_ALIGNMENT, counted as texture state.
+        void setUnpackAlignment(GLint alignment);
+        void bindFramebuffer(GLuint framebuffer);
+
+        void setDepthMask(bool write);
+        void setColorMask(bool red, bool green, bool blue, bool alpha);
+        void setBlend(bool enabled);
+        void setBlendFunc(GLenum srcColor, GLenum dstColor, GLenum srcAlpha, GLenum dstAlpha);
+        void setDepthTest(bool enabled);
+        void setCulling(bool enabled);
+        void setCullFace(GLenum face);
+
+        /// Uniform values aren't shadowed here, the shaders skip unmodified ones themselves and only report whether they did,
+        /// for each plain constant and each uniform block they would otherwise upload.
+        void countUniformUpload(bool issued);
+
+        // GL unbinds deleted objects, and hands their names out again.
+        // Must be called before deleting, so a new object with the same name isn't considered bound.
+        void forgetProgram(GLuint program);
+        void forgetVertexArray(GLuint vertexArray);
+        void forgetBuffer(GLuint buffer);
+        void forgetTexture(GLuint texture);
+        void forgetFramebuffer(GLuint framebuffer);
+
+        const Counter& getCounter(Category category) const;
+        void resetCounters();
+        /// One line per category, in the format of #PGE::Graphics::getInfo.
+        const String getInfo() const;
+
+    private:
+        // Initialized to the defaults of a new context.
+        GLuint program = 0;
+        GLuint vertexArray = 0;
+        GLuint arrayBuffer = 0;
+        GLuint uniformBuffer = 0;
+        GLuint pixelUnpackBuffer = 0;
+        std::vector<GLuint> uniformBufferBases;
+        int activeTextureUnit = 0;
+        std::array<GLuint, MAX_TEXTURE_UNITS> textures = { };
+        GLint unpackAlignment = 4;
+        GLuint framebuffer = 0;
+
+        bool depthMask = true;
+        std::array<bool, 4> colorMask = { true, true, true, true };
+        bool blend = false;
+        std::array<GLenum, 4> blendFunc = { GL_ONE, GL_ZERO, GL_ONE, GL_ZERO };
+        bool depthTest = false;
+        bool culling = false;
+        GLenum cullFace = GL_BACK;
+
+        std::array<Counter, (size_t)Category::COUNT> counters;
+
+        // Returns whether the call has to be issued, counting it either way.
+        template <typename T>
+        bool update(Category category, T& current, const T& value) {
+            Counter& counter = counters[(size_t)category];
+            if (current == value) {
+                counter.skipped++;
+                return false;
+            }
+            current = value;
+            counter.issued++;
+            return true;
+        }
+
+        GLuint* getBufferBinding(GLenum target);
+};
+
+}
+
+#endif // PGEINTERNAL_GLSTATEOGL3_H_INCLUDED
@@ -29,6 +29,9 @@ void Graphics::update() {
             focused = false;
         }
     }
+
+    // Start of the frame, nothing can be using the old resources anymore.
+    ((GraphicsInternal*)this)->applyHotReloads();
 }
 
 void Graphics::setScreenPosition(const Vector2i& pos) const {
@@ -79,6 +82,14 @@ Graphics::Culling Graphics::getCulling() const {
     return cullingMode;
 }
 
+void Graphics::setTextureUploadBudget(int bytesPerUpdate) {
+    textureUploadBudget = bytesPerUpdate;
+}
+
+int Graphics::getTextureUploadBudget() const {
+    return textureUploadBudget;
+}
+
 Graphics::WindowEventSubscriber::WindowEventSubscriber(const Graphics& gfx) {
     resource = new SysEventsInternal::SubscriberInternal(gfx, SysEventsInternal::SubscriberInternal::EventType::WINDOW);
     SysEventsInternal::subscribe(resource);
@@ -3,6 +3,8 @@
 #endif
 #include "GraphicsOGL3.h"
 
+#include <algorithm>
+
 #if defined(__APPLE__) && defined(__OBJC__)
 #import <Foundation/Foundation.h>
 #include <PGE/SDL_syswm.h>
@@ -48,6 +50,71 @@ SDL_Window* GraphicsInternal::getWindow() const {
     return sdlWindow;
 }
 
+void GraphicsInternal::addHotReload(const void* owner, const FilePath& path, const std::function<bool()>& reload) {
+    if (!fileWatcher.has_value()) {
+        fileWatcher.emplace();
+    }
+    fileWatcher->watch(path);
+    hotReloads.emplace_back(HotReload{ owner, path, reload });
+}
+
+void GraphicsInternal::removeHotReload(const void* owner) {
+    for (auto it = hotReloads.begin(); it != hotReloads.end();) {
+        if (it->owner == owner) {
+            fileWatcher->unwatch(it->path);
+            it = hotReloads.erase(it);
+        } else {
+            it++;
+        }
+    }
+}
+
+void GraphicsInternal::applyHotReloads() {
+    if (hotReloads.empty()) { return; }
+
+    const std::vector<FilePath>& changes = fileWatcher->update();
+    if (changes.empty()) { return; }
+
+    for (HotReload& hotReload : hotReloads) {
+        for (const FilePath& change : changes) {
+            // A file, or a file inside a watched directory.
+            if (change == hotReload.path || change.getParentDirectory() == hotReload.path) {
+                hotReload.reload();
+                break;
+            }
+        }
+    }
+}
+
+void Graphics::enableHotReload(Shader& shader) {
+    GraphicsInternal& gfx = (GraphicsInternal&)*this;
+    gfx.addHotReload(&shader, shader.getPath(), [&gfx, &shader]() {
+        return gfx.reloadShader(shader);
+    });
+}
+
+void Graphics::disableHotReload(const Shader& shader) {
+    ((GraphicsInternal*)this)->removeHotReload(&shader);
+}
+
+void Graphics::enableHotReload(Texture& texture, const FilePath& source, const TextureDecoder& decoder) {
+    GraphicsInternal& gfx = (GraphicsInternal&)*this;
+    gfx.addHotReload(&texture, source, [&gfx, &texture, source, decoder]() {
+        std::vector<byte> buffer;
+        try {
+            buffer = decoder(source);
+        } catch (const Exception&) {
+            // Probably still being written, we'll get another change.
+            return false;
+        }
+        return gfx.reloadTexture(texture, buffer);
+    });
+}
+
+void Graphics::disableHotReload(const Texture& texture) {
+    ((GraphicsInternal*)this)->removeHotReload(&texture);
+}
+
 GraphicsInternal::SDLWindow::SDLWindow(const String& title, int x, int y, int width, int height, u32 flags) {
     resource = SDL_CreateWindow(title.cstr(), x, y, width, height, flags);
     PGE_ASSERT(resource != nullptr, "Failed to create SDL window (SDLERROR: " + String(SDL_GetError()) + ")");
@@ -104,10 +171,36 @@ Texture* Texture::load(Graphics& gfx, int w, int h, const byte* buffer, Format f
     return ((GraphicsInternal&)gfx).loadTexture(w, h, buffer, fmt, mipmaps);
 }
 
+static void validateMipmaps(const std::vector<Texture::Mipmap>& mipmaps, const Texture::AnyFormat& fmt) {
+    PGE_ASSERT(!mipmaps.empty(), "Tried to load texture without any levels");
+    for (int i = 0; i < (int)mipmaps.size(); i++) {
+        const Texture::Mipmap& mipmap = mipmaps[i];
+        PGE_ASSERT(mipmap.buffer != nullptr, "Tried to load texture from nullptr");
+        if (i > 0) {
+            PGE_ASSERT(mipmap.width == std::max(1, mipmaps[i - 1].width / 2) && mipmap.height == std::max(1, mipmaps[i - 1].height / 2),
+                "Level " + String::from(i) + " isn't half the size of the previous one");
+        }
+        if (std::holds_alternative<Texture::Format>(fmt)) {
+            PGE_ASSERT(mipmap.size == (size_t)mipmap.width * mipmap.height * Texture::getBytesPerPixel(std::get<Texture::Format>(fmt)),
+                "Buffer size of level " + String::from(i) + " doesn't match its dimensions");
+        }
+    }
+}
+
+Texture* Texture::load(Graphics& gfx, const std::vector<Mipmap>& mipmaps, Format fmt) {
+    validateMipmaps(mipmaps, fmt);
+    return ((GraphicsInternal&)gfx).loadTextureMipmaps(mipmaps, fmt);
+}
+
 Texture* Texture::loadCompressed(Graphics& gfx, const std::vector<Mipmap>& mipmaps, CompressedFormat fmt) {
     return ((GraphicsInternal&)gfx).loadTextureCompressed(mipmaps, fmt);
 }
 
+Texture* Texture::loadAsync(Graphics& gfx, const std::vector<Mipmap>& mipmaps, const AnyFormat& fmt) {
+    validateMipmaps(mipmaps, fmt);
+    return ((GraphicsInternal&)gfx).loadTextureAsync(mipmaps, fmt);
+}
+
 Material* Material::create(Graphics& gfx, Shader& sh, Opaque o) {
     return ((GraphicsInternal&)gfx).createMaterial(sh, { }, o);
 }
@@ -4,6 +4,7 @@
 #include <SDL.h>
 
 #include <PGE/Graphics/Graphics.h>
+#include <PGE/File/FileWatcher.h>
 #include <PGE/Graphics/Mesh.h>
 #include <PGE/Graphics/Texture.h>
 #include <PGE/Graphics/Material.h>
@@ -40,6 +41,17 @@ class GraphicsInternal : public Graphics {
 
         GraphicsInternal(const String& rendererName, const String& name, int w, int h, WindowMode wm, int x, int y, SDL_WindowFlags windowFlags);
 
+    private:
+        struct HotReload {
+            const void* owner;
+            // File or directory.
+            FilePath path;
+            std::function<bool()> reload;
+        };
+        std::vector<HotReload> hotReloads;
+        // Only created once hot reloading is first enabled.
+        std::optional<FileWatcher> fileWatcher;
+
     public:
         String getInfo() const override;
 
@@ -47,10 +59,19 @@ class GraphicsInternal : public Graphics {
         virtual Mesh* createMesh() = 0;
         virtual Texture* createRenderTargetTexture(int w, int h, Texture::Format fmt) = 0;
         virtual Texture* loadTexture(int w, int h, const byte* buffer, Texture::Format fmt, bool mipmaps) = 0;
+        virtual Texture* loadTextureMipmaps(const std::vector<Texture::Mipmap>& mipmaps, Texture::Format fmt) = 0;
         virtual Texture* loadTextureCompressed(const std::vector<Texture::Mipmap>& mipmaps, Texture::CompressedFormat fmt) = 0;
+        virtual Texture* loadTextureAsync(const std::vector<Texture::Mipmap>& mipmaps, const Texture::AnyFormat& fmt) = 0;
         virtual Material* createMaterial(Shader& sh, const ReferenceVector<Texture>& tex, Material::Opaque o) = 0;
 
         SDL_Window* getWindow() const;
+
+        virtual bool reloadShader(Shader& sh) = 0;
+        virtual bool reloadTexture(Texture& tex, const std::vector<byte>& buffer) = 0;
+
+        void addHotReload(const void* owner, const FilePath& path, const std::function<bool()>& reload);
+        void removeHotReload(const void* owner);
+        void applyHotReloads();
 };
 
 template <typename ShaderType, typename MeshType, typename TextureType, typename MaterialType = Material>
@@ -79,14 +100,30 @@ class GraphicsSpecialized : public GraphicsInternal {
         Texture* loadTexture(int w, int h, const byte* buffer, Texture::Format fmt, bool mipmaps) final override {
             return new TextureType(*this, w, h, buffer, fmt, mipmaps);
         }
+
+        Texture* loadTextureMipmaps(const std::vector<Texture::Mipmap>& mipmaps, Texture::Format fmt) final override {
+            return new TextureType(*this, mipmaps, fmt);
+        }
         
         Texture* loadTextureCompressed(const std::vector<Texture::Mipmap>& mipmaps, Texture::CompressedFormat fmt) final override {
             return new TextureType(*this, mipmaps, fmt);
         }
 
+        Texture* loadTextureAsync(const std::vector<Texture::Mipmap>& mipmaps, const Texture::AnyFormat& fmt) final override {
+            return TextureType::createAsync(*this, mipmaps, fmt);
+        }
+
         Material* createMaterial(Shader& sh, const ReferenceVector<Texture>& tex, Material::Opaque o) final override {
             return new MaterialType(*this, sh, tex, o);
         }
+
+        bool reloadShader(Shader& sh) final override {
+            return ((ShaderType&)sh).reload();
+        }
+
+        bool reloadTexture(Texture& tex, const std::vector<byte>& buffer) final override {
+            return ((TextureType&)tex).reload(buffer);
+        }
 };
 
 }
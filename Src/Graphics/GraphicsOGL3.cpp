@@ -1,9 +1,14 @@
 #include "GraphicsOGL3.h"
 
+#include <algorithm>
+
 #include <glad/gl.h>
 
 using namespace PGE;
 
+// Querying SDL for the current context on every call adds up, all contexts are made current through takeGlContext anyway.
+static SDL_GLContext currentGlContext = nullptr;
+
 GraphicsOGL3::GraphicsOGL3(const String& name, int w, int h, WindowMode wm, int x, int y)
     //TODO: this is incorrect on macOS
     : GraphicsSpecialized("OpenGL", name, w, h, wm, x, y, (SDL_WindowFlags)(SDL_WINDOW_OPENGL | SDL_WINDOW_ALLOW_HIGHDPI/* | SDL_WINDOW_FULLSCREEN_DESKTOP*/)), resourceManager(*this) {
@@ -27,15 +32,18 @@ GraphicsOGL3::GraphicsOGL3(const String& name, int w, int h, WindowMode wm, int
     //    }
 
     glContext = resourceManager.addNewResource<GLContext>(getWindow());
+    currentGlContext = glContext;
 
     PGE_ASSERT(gladLoadGL((GLADloadfunc)SDL_GL_GetProcAddress) != 0, "Failed to initialize GLAD (GLERROR: " + String::from(glGetError()) + ")");
 
     depthTest = true;
-    glEnable(GL_DEPTH_TEST);
+    glState.setDepthTest(true);
     cullingMode = Culling::NONE;
     setCulling(Culling::BACK);
-    glEnable(GL_BLEND);
-    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE);
+    glState.setBlend(true);
+    glState.setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE);
+    // Rows of uploaded levels are tightly packed, also those of small R8 mips whose width isn't a multiple of 4.
+    glState.setUnpackAlignment(1);
     glClearDepth(1.0);
 
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
@@ -48,7 +56,7 @@ GraphicsOGL3::GraphicsOGL3(const String& name, int w, int h, WindowMode wm, int
 
     setViewport(Rectanglei(0,0,w,h));
 
-    glFramebuffer = resourceManager.addNewResource<GLFramebuffer>();
+    glFramebuffer = resourceManager.addNewResource<GLFramebuffer>(glState);
 
     vsync = true;
     SDL_GL_SetSwapInterval(1);
@@ -56,9 +64,38 @@ GraphicsOGL3::GraphicsOGL3(const String& name, int w, int h, WindowMode wm, int
     updateRenderTargetFlags(false);
 }
 
+GraphicsOGL3::~GraphicsOGL3() {
+    // The context is deleted along with the resources, a new one may get the same handle.
+    if (currentGlContext == glContext) {
+        currentGlContext = nullptr;
+    }
+}
+
 void GraphicsOGL3::update() {
     Graphics::update();
     takeGlContext();
+    uploadTextures();
+}
+
+void GraphicsOGL3::queueTextureUpload(TextureOGL3& texture) {
+    textureUploads.push_back(&texture);
+}
+
+void GraphicsOGL3::cancelTextureUpload(TextureOGL3& texture) {
+    textureUploads.erase(std::remove(textureUploads.begin(), textureUploads.end(), &texture), textureUploads.end());
+}
+
+void GraphicsOGL3::uploadTextures() {
+    int uploaded = 0;
+    for (TextureOGL3* texture : textureUploads) {
+        // At least one level per update, so levels larger than the budget still arrive.
+        while (texture->hasLevelsToUpload() && (uploaded == 0 || uploaded < textureUploadBudget)) {
+            uploaded += texture->uploadNextLevel();
+        }
+        if (texture->hasLevelsToUpload()) { break; }
+    }
+    textureUploads.erase(std::remove_if(textureUploads.begin(), textureUploads.end(),
+        [](TextureOGL3* texture) { return texture->finishUpload(); }), textureUploads.end());
 }
 
 void GraphicsOGL3::swap() {
@@ -66,8 +103,9 @@ void GraphicsOGL3::swap() {
 }
 
 void GraphicsOGL3::takeGlContext() {
-    if (SDL_GL_GetCurrentContext()!=glContext) {
+    if (currentGlContext!=glContext) {
         SDL_GL_MakeCurrent(getWindow(),glContext);
+        currentGlContext = glContext;
     }
 }
 
@@ -75,11 +113,19 @@ SDL_GLContext GraphicsOGL3::getGlContext() const {
     return glContext;
 }
 
+GLStateOGL3& GraphicsOGL3::getGlState() {
+    return glState;
+}
+
+String GraphicsOGL3::getInfo() const {
+    return GraphicsInternal::getInfo() + glState.getInfo();
+}
+
 void GraphicsOGL3::clear(const Color& color) {
     takeGlContext();
 
-    glDepthMask(GL_TRUE);
-    glColorMask(true,true,true,true);
+    glState.setDepthMask(true);
+    glState.setColorMask(true,true,true,true);
     glClearColor(color.red,color.green,color.blue,color.alpha);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
@@ -89,7 +135,7 @@ void GraphicsOGL3::setRenderTarget(Texture& renderTarget) {
 
     takeGlContext();
 
-    glBindFramebuffer(GL_FRAMEBUFFER,glFramebuffer);
+    glState.bindFramebuffer(glFramebuffer);
     glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, ((TextureOGL3&)renderTarget).getGlDepthbuffer());
     glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, ((TextureOGL3&)renderTarget).getGlTexture(), 0);
 
@@ -124,7 +170,7 @@ void GraphicsOGL3::setRenderTargets(const ReferenceVector<Texture>& renderTarget
         GL_COLOR_ATTACHMENT6,
         GL_COLOR_ATTACHMENT7
     };
-    glBindFramebuffer(GL_FRAMEBUFFER,glFramebuffer);
+    glState.bindFramebuffer(glFramebuffer);
     glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, largestTarget->getGlDepthbuffer());
     for (int i = 0; i < (int)renderTargets.size(); i++) {
         glFramebufferTexture(GL_FRAMEBUFFER, glAttachments[i], ((TextureOGL3&)renderTargets[i]).getGlTexture(), 0);
@@ -137,9 +183,9 @@ void GraphicsOGL3::resetRenderTarget() {
 
     takeGlContext();
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glDepthMask(GL_TRUE);
-    glColorMask(true,true,true,true);
+    glState.bindFramebuffer(0);
+    glState.setDepthMask(true);
+    glState.setColorMask(true,true,true,true);
 }
 
 void GraphicsOGL3::setViewport(const Rectanglei& vp) {
@@ -153,12 +199,10 @@ void GraphicsOGL3::setViewport(const Rectanglei& vp) {
 
 void GraphicsOGL3::setDepthTest(bool isEnabled) {
     if (isEnabled != depthTest) {
+        takeGlContext();
+
         depthTest = isEnabled;
-        if (isEnabled) {
-            glEnable(GL_DEPTH_TEST);
-        } else {
-            glDisable(GL_DEPTH_TEST);
-        }
+        glState.setDepthTest(isEnabled);
     }
 }
 
@@ -174,14 +218,9 @@ void GraphicsOGL3::setVsync(bool isEnabled) {
 void GraphicsOGL3::setCulling(Culling mode) {
     if (mode == cullingMode) { return; }
 
-    if (mode == Culling::NONE) {
-        glDisable(GL_CULL_FACE);
-    } else {
-        if (cullingMode == Culling::NONE) {
-            glEnable(GL_CULL_FACE);
-        }
-        updateCullingMode(mode, renderingToRenderTarget);
-    }
+    takeGlContext();
+    glState.setCulling(mode != Culling::NONE);
+    updateCullingMode(mode, renderingToRenderTarget);
 
     cullingMode = mode;
 }
@@ -195,7 +234,7 @@ void GraphicsOGL3::updateCullingMode(Culling newMode, bool flip) {
     } else {
         glMode = GL_FRONT;
     }
-    glCullFace(glMode);
+    glState.setCullFace(glMode);
 }
 
 void GraphicsOGL3::addRenderTargetFlag(Shader::Constant& c) {
@@ -206,7 +245,26 @@ void GraphicsOGL3::removeRenderTargetFlag(Shader::Constant& c) {
     renderTargetFlags.erase(&c);
 }
 
+UniformBlockOGL3& GraphicsOGL3::getUniformBlock(const String& name, const StructuredData::ElemLayout& layout) {
+    auto it = uniformBlocks.find(name);
+    if (it != uniformBlocks.end()) {
+        // Layouts are interned, equal layouts are the same object.
+        PGE_ASSERT(it->second->getData().getLayout() == layout, "Uniform block declared with different layouts (name: " + name + ")");
+        return *it->second;
+    }
+
+    takeGlContext();
+    GLint maxBindings;
+    glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &maxBindings);
+    PGE_ASSERT((GLint)uniformBlocks.size() < maxBindings, "Too many uniform blocks (max: " + String::from(maxBindings) + ")");
+
+    UniformBlockOGL3* block = new UniformBlockOGL3(*this, layout, (GLuint)uniformBlocks.size());
+    uniformBlocks.emplace(name, std::unique_ptr<UniformBlockOGL3>(block));
+    return *block;
+}
+
 void GraphicsOGL3::updateRenderTargetFlags(bool rt) {
+    takeGlContext();
     updateCullingMode(cullingMode, rt);
 
     float yFlip = rt ? -1.f : 1.f;
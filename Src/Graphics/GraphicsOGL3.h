@@ -6,6 +6,7 @@
 #include <SDL.h>
 
 #include "GraphicsInternal.h"
+#include "GLStateOGL3.h"
 
 #include "Shader/ShaderOGL3.h"
 #include "Mesh/MeshOGL3.h"
@@ -19,6 +20,7 @@ namespace PGE {
 class GraphicsOGL3 : public GraphicsSpecialized<ShaderOGL3, MeshOGL3, TextureOGL3> {
     public:
         GraphicsOGL3(const String& name, int w, int h, WindowMode wm, int x, int y);
+        ~GraphicsOGL3();
 
         void update() override;
         void swap() override;
@@ -35,13 +37,30 @@ class GraphicsOGL3 : public GraphicsSpecialized<ShaderOGL3, MeshOGL3, TextureOGL
         void setVsync(bool isEnabled) override;
         void setCulling(Culling mode) override;
 
+        /// Also lists how many GL state changes and uniform uploads were issued and skipped so far.
+        String getInfo() const override;
+
+        /// Makes the context current, unless it already is.
+        /// Only tracks the contexts made current through here, anything else switching contexts must not do so in between.
         void takeGlContext();
         SDL_GLContext getGlContext() const;
+        GLStateOGL3& getGlState();
 
         void addRenderTargetFlag(Shader::Constant& c);
         void removeRenderTargetFlag(Shader::Constant& c);
 
+        /// Gets the block shared by all shaders declaring it, creating it on first use.
+        /// @throws #PGE::Exception If a block of the same name with a different layout exists.
+        UniformBlockOGL3& getUniformBlock(const String& name, const StructuredData::ElemLayout& layout);
+
+        /// Uploads the texture's levels during the following updates, within the texture upload budget.
+        void queueTextureUpload(TextureOGL3& texture);
+        void cancelTextureUpload(TextureOGL3& texture);
+
     private:
+        // Outlives all GL objects, which notify it when deleted.
+        GLStateOGL3 glState;
+
         GLContext::View glContext;
         GLFramebuffer::View glFramebuffer;
 
@@ -49,9 +68,16 @@ class GraphicsOGL3 : public GraphicsSpecialized<ShaderOGL3, MeshOGL3, TextureOGL
 
         void updateCullingMode(Culling newMode, bool flip);
 
+        // Pointers must stay valid, as shaders keep them.
+        std::unordered_map<String::Key, std::unique_ptr<UniformBlockOGL3>> uniformBlocks;
+
         bool renderingToRenderTarget = false;
         std::unordered_set<Shader::Constant*> renderTargetFlags;
         void updateRenderTargetFlags(bool rt);
+
+        // In the order they were queued, kept until their upload is complete.
+        std::vector<TextureOGL3*> textureUploads;
+        void uploadTextures();
 };
 
 }
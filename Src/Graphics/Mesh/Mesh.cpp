@@ -1,9 +1,82 @@
 #include <PGE/Graphics/Mesh.h>
 #include <PGE/Graphics/Shader.h>
 #include <PGE/Graphics/Material.h>
+#include <PGE/Graphics/MeshOptimizer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
 
 using namespace PGE;
 
+static std::atomic<u64> totalCpuBytes = 0;
+static std::atomic<u64> totalGpuBytes = 0;
+
+// Geometry compresses well once every byte of an element is delta coded against the same byte of the previous element,
+// as neighboring vertices tend to be similar and indices tend to grow slowly.
+// Zero deltas are stored as a 0 followed by the length of the run minus one.
+static const std::vector<byte> compressGeometry(const byte* data, int count, int stride) {
+    std::vector<byte> compressed;
+    for (int b = 0; b < stride; b++) {
+        byte prev = 0;
+        int zeroRun = 0;
+        for (int i = 0; i < count; i++) {
+            byte curr = data[(size_t)i * stride + b];
+            byte delta = curr - prev;
+            prev = curr;
+            if (delta == 0) {
+                zeroRun++;
+                if (zeroRun == 256) {
+                    compressed.push_back(0);
+                    compressed.push_back(255);
+                    zeroRun = 0;
+                }
+                continue;
+            }
+            if (zeroRun > 0) {
+                compressed.push_back(0);
+                compressed.push_back((byte)(zeroRun - 1));
+                zeroRun = 0;
+            }
+            compressed.push_back(delta);
+        }
+        if (zeroRun > 0) {
+            compressed.push_back(0);
+            compressed.push_back((byte)(zeroRun - 1));
+        }
+    }
+    return compressed;
+}
+
+static void decompressGeometry(const std::vector<byte>& compressed, byte* data, int count, int stride) {
+    size_t pos = 0;
+    for (int b = 0; b < stride; b++) {
+        byte prev = 0;
+        for (int i = 0; i < count;) {
+            byte delta = compressed[pos++];
+            if (delta == 0) {
+                int zeroRun = compressed[pos++] + 1;
+                for (int j = 0; j < zeroRun; j++, i++) {
+                    data[(size_t)i * stride + b] = prev;
+                }
+            } else {
+                prev += delta;
+                data[(size_t)i * stride + b] = prev;
+                i++;
+            }
+        }
+    }
+}
+
+// Whether inner reaches any side of outer, which contains it.
+static bool touchesBounds(const AABBox& inner, const AABBox& outer) {
+    const Vector3f& innerMin = inner.getMin(); const Vector3f& innerMax = inner.getMax();
+    const Vector3f& outerMin = outer.getMin(); const Vector3f& outerMax = outer.getMax();
+    return innerMin.x <= outerMin.x || innerMin.y <= outerMin.y || innerMin.z <= outerMin.z
+        || innerMax.x >= outerMax.x || innerMax.y >= outerMax.y || innerMax.z >= outerMax.z;
+}
+
 #define PGE_ASSERT_MATERIAL_LAYOUT() PGE_ASSERT(material == nullptr || verts.getDataSize() <= 0 || material->getShader().getVertexLayout() == verts.getLayout(), "Material must be set before geometry can be set")
 
 void Mesh::setGeometry(StructuredData&& verts, const std::vector<Line>& lines) {
@@ -18,7 +91,7 @@ void Mesh::setGeometry(StructuredData&& verts, const std::vector<Line>& lines) {
     }
     primitiveType = PrimitiveType::LINE;
 
-    mustReuploadInternalData = true;
+    geometryChanged();
 }
 
 void Mesh::setGeometry(StructuredData&& verts, const std::vector<Triangle>& triangles) {
@@ -34,7 +107,7 @@ void Mesh::setGeometry(StructuredData&& verts, const std::vector<Triangle>& tria
     }
     primitiveType = PrimitiveType::TRIANGLE;
 
-    mustReuploadInternalData = true;
+    geometryChanged();
 }
 
 void Mesh::setGeometry(StructuredData&& verts, PrimitiveType type, std::vector<u32>&& inds) {
@@ -45,20 +118,272 @@ void Mesh::setGeometry(StructuredData&& verts, PrimitiveType type, std::vector<u
     vertices = std::move(verts);
     indices = std::move(inds);
     primitiveType = type;
-    mustReuploadInternalData = true;
+    geometryChanged();
+}
+
+const MeshOptimizer::Report Mesh::setOptimizedGeometry(StructuredData&& verts, PrimitiveType type, std::vector<u32>&& inds, const MeshOptimizer::Options& options) {
+    PGE_ASSERT_MATERIAL_LAYOUT();
+    MeshOptimizer::Report report = MeshOptimizer::optimize(verts, inds, type, options);
+    setGeometry(std::move(verts), type, std::move(inds));
+    return report;
 }
 
 void Mesh::clearGeometry() {
     vertices = StructuredData();
     indices.clear();
     primitiveType.reset();
+    geometryChanged();
+}
+
+Mesh::~Mesh() {
+    totalCpuBytes -= memoryUsage.cpuBytes;
+    totalGpuBytes -= memoryUsage.gpuBytes;
+}
+
+void Mesh::geometryChanged() {
+    mustReuploadInternalData = true;
+    cpuDataReleased = false;
+    discardCompressedData();
+    updateCpuBytes();
+    updateBounds();
+    lodRanges.assign(1, LodRange{ IndexRange{ 0, (int)indices.size() }, 0.f });
+    currentLod = 0;
+}
+
+void Mesh::updateVertices(int firstElem, const StructuredData& verts) {
+    PGE_ASSERT(!cpuDataReleased, "Tried updating vertices after they were released");
+    int oldCount = vertices.getElementCount();
+    // The bounds can only shrink if a replaced vertex lies on them, otherwise growing them by the new vertices is enough.
+    bool boundsMayShrink = false;
+    int replacedCount = std::min(verts.getElementCount(), oldCount - firstElem);
+    if (hasBoundsEntry() && firstElem >= 0 && replacedCount > 0) {
+        AABBox replaced = vertices.computeBounds(String::Key("position"), firstElem, replacedCount, false);
+        boundsMayShrink = touchesBounds(replaced, bounds);
+    }
+
+    vertices.replace(firstElem, verts);
+    if (vertices.getElementCount() != oldCount) {
+        mustReuploadInternalData = true;
+        updateCpuBytes();
+    }
+
+    if (boundsMayShrink || oldCount == 0) {
+        updateBounds();
+    } else if (hasBoundsEntry() && verts.getElementCount() > 0) {
+        AABBox added = verts.computeBounds(String::Key("position"), false);
+        bounds.addPoint(added.getMin());
+        bounds.addPoint(added.getMax());
+        boundingSphere = Sphere(bounds);
+    }
+}
+
+void Mesh::updateIndices(int firstIndex, const std::vector<u32>& inds) {
+    PGE_ASSERT(!cpuDataReleased, "Tried updating indices after they were released");
+    PGE_ASSERT(firstIndex >= 0 && (size_t)firstIndex + inds.size() <= indices.size(),
+        "Index range out of bounds (" + String::from(firstIndex) + " + " + String::from((int)inds.size()) + " > " + String::from((int)indices.size()) + ")");
+    for (u32 index : inds) {
+        PGE_ASSERT(index < (u32)vertices.getElementCount(), "Index out of range (" + String::from(index) + ")");
+    }
+    if (inds.empty()) { return; }
+
+    std::copy(inds.begin(), inds.end(), indices.begin() + firstIndex);
+    int end = firstIndex + (int)inds.size();
+    if (dirtyIndices.has_value()) {
+        end = std::max(end, dirtyIndices->first + dirtyIndices->count);
+        firstIndex = std::min(firstIndex, dirtyIndices->first);
+    }
+    dirtyIndices = IndexRange{ firstIndex, end - firstIndex };
+}
+
+void Mesh::setUsage(Usage u) {
+    if (u == usage) { return; }
+    PGE_ASSERT(u == Usage::STATIC || retention == Retention::KEEP, "Dynamic meshes must keep their geometry");
+    restoreCpuData();
+    usage = u;
+    mustReuploadInternalData = true;
+}
+
+Mesh::Usage Mesh::getUsage() const {
+    return usage;
+}
+
+void Mesh::setRetention(Retention r) {
+    if (r == retention) { return; }
+    PGE_ASSERT(usage == Usage::STATIC, "Dynamic meshes must keep their geometry");
+    // There's neither a copy nor a compressed one to keep.
+    PGE_ASSERT(!cpuDataReleased || retention != Retention::DISCARD, "Tried keeping geometry that was discarded");
+    if (r == Retention::KEEP) {
+        restoreCpuData();
+    }
+    retention = r;
+    if (retention != Retention::COMPRESSED) {
+        discardCompressedData();
+    }
+    updateCpuBytes();
+}
+
+Mesh::Retention Mesh::getRetention() const {
+    return retention;
+}
+
+void Mesh::invalidateGpuData() {
+    restoreCpuData();
+    mustReuploadInternalData = true;
+}
+
+void Mesh::releaseCpuData() {
+    if (retention == Retention::KEEP || usage != Usage::STATIC || cpuDataReleased) { return; }
+
+    if (retention == Retention::COMPRESSED) {
+        compressedVertexCount = vertices.getElementCount();
+        compressedVertices = compressGeometry(vertices.getData(), compressedVertexCount, vertices.getLayout().getElementSize());
+        compressedIndices = compressGeometry((const byte*)indices.data(), (int)indices.size(), sizeof(u32));
+    }
+    // Keeps the layout, which is still needed to draw.
+    vertices = StructuredData(vertices.getLayout(), 0);
+    std::vector<u32>().swap(indices);
+    cpuDataReleased = true;
+    updateCpuBytes();
+}
+
+void Mesh::restoreCpuData() {
+    if (!cpuDataReleased) { return; }
+    PGE_ASSERT(retention == Retention::COMPRESSED, "Tried restoring geometry that was discarded");
+    PGE_ASSERT((!compressedVertices.empty() || compressedVertexCount == 0) && (!compressedIndices.empty() || indexCount == 0),
+        "Tried restoring geometry without a compressed copy");
+
+    // Freshly constructed data owns its memory and is entirely dirty, so writing to it directly is fine.
+    vertices = StructuredData(vertices.getLayout(), compressedVertexCount);
+    decompressGeometry(compressedVertices, (byte*)vertices.getData(), compressedVertexCount, vertices.getLayout().getElementSize());
+    indices.resize(indexCount);
+    decompressGeometry(compressedIndices, (byte*)indices.data(), indexCount, sizeof(u32));
+    cpuDataReleased = false;
+    updateCpuBytes();
+}
+
+void Mesh::discardCompressedData() {
+    compressedVertexCount = 0;
+    std::vector<byte>().swap(compressedVertices);
+    std::vector<byte>().swap(compressedIndices);
+}
+
+void Mesh::updateCpuBytes() {
+    u64 cpuBytes = (u64)vertices.getCapacity() * vertices.getLayout().getElementSize()
+        + indices.capacity() * sizeof(u32)
+        + compressedVertices.capacity() + compressedIndices.capacity();
+    totalCpuBytes += cpuBytes - memoryUsage.cpuBytes;
+    memoryUsage.cpuBytes = cpuBytes;
+}
+
+void Mesh::setGpuBytes(u64 bytes) {
+    totalGpuBytes += bytes - memoryUsage.gpuBytes;
+    memoryUsage.gpuBytes = bytes;
+}
+
+const Mesh::MemoryUsage Mesh::getMemoryUsage() const {
+    return memoryUsage;
+}
+
+const Mesh::MemoryUsage Mesh::getTotalMemoryUsage() {
+    MemoryUsage usage;
+    usage.cpuBytes = totalCpuBytes;
+    usage.gpuBytes = totalGpuBytes;
+    return usage;
+}
+
+bool Mesh::hasBoundsEntry() const {
+    String::Key position("position");
+    const StructuredData::ElemLayout& layout = vertices.getLayout();
+    if (!layout.hasEntry(position)) { return false; }
+    int size = layout.getLocationAndSize(position).size;
+    return size == sizeof(Vector3f) || size == sizeof(Vector4f);
+}
+
+void Mesh::updateBounds() {
+    if (hasBoundsEntry()) {
+        bounds = vertices.computeBounds(String::Key("position"));
+        boundingSphere = Sphere(bounds);
+    } else {
+        bounds = AABBox();
+        boundingSphere = Sphere();
+    }
+}
+
+const AABBox Mesh::getBounds() const {
+    return bounds;
+}
+
+const Sphere Mesh::getBoundingSphere() const {
+    return boundingSphere;
+}
+
+void Mesh::setLods(std::vector<Lod>&& lods) {
+    PGE_ASSERT(primitiveType.has_value(), "Geometry must be set before its levels of detail");
+    PGE_ASSERT(!cpuDataReleased, "Tried setting levels of detail after the geometry was released");
+    int primitiveSize = primitiveType == PrimitiveType::LINE ? 2 : 3;
+    float previousError = 0.f;
+    for (const Lod& lod : lods) {
+        PGE_ASSERT(lod.indices.size() % primitiveSize == 0, "Invalid index count for level of detail (" + String::from((int)lod.indices.size()) + ")");
+        PGE_ASSERT(lod.error >= previousError, "Level of detail errors must be ascending");
+        for (u32 index : lod.indices) {
+            PGE_ASSERT(index < (u32)vertices.getElementCount(), "Index out of range (" + String::from(index) + ")");
+        }
+        previousError = lod.error;
+    }
+
+    // Drops the previous levels, which follow the full detail indices.
+    indices.resize(lodRanges[0].indices.count);
+    lodRanges.resize(1);
+    for (const Lod& lod : lods) {
+        lodRanges.push_back(LodRange{ IndexRange{ (int)indices.size(), (int)lod.indices.size() }, lod.error });
+        indices.insert(indices.end(), lod.indices.begin(), lod.indices.end());
+    }
+    currentLod = std::min(currentLod, (int)lodRanges.size() - 1);
     mustReuploadInternalData = true;
+    updateCpuBytes();
+}
+
+int Mesh::getLodCount() const {
+    return (int)lodRanges.size();
+}
+
+void Mesh::selectLod(float screenRadius, float maxPixelError) {
+    int lod = currentLod;
+    while (lod > 0 && lodRanges[lod].error * screenRadius > maxPixelError) {
+        lod--;
+    }
+    while (lod + 1 < (int)lodRanges.size() && lodRanges[lod + 1].error * screenRadius <= maxPixelError * LOD_HYSTERESIS) {
+        lod++;
+    }
+    currentLod = lod;
+}
+
+void Mesh::setLod(int lod) {
+    PGE_ASSERT(lod >= 0 && lod < (int)lodRanges.size(), "Level of detail out of range (" + String::from(lod) + ")");
+    currentLod = lod;
+}
+
+int Mesh::getLod() const {
+    return currentLod;
+}
+
+float Mesh::computeScreenRadius(const Sphere& sphere, const Vector3f& cameraPosition, float verticalFovRad, int screenHeight) {
+    float distanceSquared = sphere.getCenter().distanceSquared(cameraPosition);
+    float radiusSquared = sphere.getRadius() * sphere.getRadius();
+    if (distanceSquared <= radiusSquared) { return std::numeric_limits<float>::infinity(); }
+    // The tangent of half the angle the sphere covers, over the tangent of half the field of view.
+    return sphere.getRadius() / std::sqrt(distanceSquared - radiusSquared) / std::tan(verticalFovRad * 0.5f) * (screenHeight * 0.5f);
+}
+
+const Mesh::IndexRange Mesh::getDrawRange() const {
+    if (lodRanges.empty()) { return IndexRange{ 0, indexCount }; }
+    return lodRanges[currentLod].indices;
 }
 
 void Mesh::setMaterial(Material* m) {
     PGE_ASSERT(
         m == nullptr ||
-        vertices.getDataSize() <= 0 ||
+        (vertices.getDataSize() <= 0 && !cpuDataReleased) ||
         m->getShader().getVertexLayout() == vertices.getLayout(),
         "Can't set material with mismatched vertex layout without discarding"
     );
@@ -70,13 +395,83 @@ bool Mesh::isOpaque() const {
 }
 
 void Mesh::render() {
+    RenderState state;
+    render(state);
+    finishRendering(state);
+}
+
+void Mesh::render(RenderState& state) {
     if (primitiveType.has_value() && material != nullptr) {
-        if (mustReuploadInternalData) {
-            uploadInternalData();
-            mustReuploadInternalData = false;
-        }
-        renderInternal();
+        uploadModifiedData();
+        renderInternal(state);
+        state.stats.draws++;
+    }
+}
+
+void Mesh::renderInstanced(int count, const StructuredData& perInstance) {
+    if (count <= 0 || !primitiveType.has_value() || material == nullptr) { return; }
+    PGE_ASSERT(perInstance.getLayout() == material->getShader().getInstanceLayout(), "Instance data doesn't match the shader's instance layout");
+    PGE_ASSERT(count <= perInstance.getElementCount(),
+        "Not enough instance data (" + String::from(count) + " > " + String::from(perInstance.getElementCount()) + ")");
+
+    uploadModifiedData();
+    RenderState state;
+    renderInstancedInternal(state, count, perInstance);
+    finishRendering(state);
+}
+
+void Mesh::uploadModifiedData() {
+    if (mustReuploadInternalData) {
+        restoreCpuData();
+        indexCount = (int)indices.size();
+        shortIndices = vertices.getElementCount() <= MAX_SHORT_INDEX_VERTICES;
+        uploadInternalData();
+        mustReuploadInternalData = false;
+        vertices.clearDirtyRange();
+        dirtyIndices.reset();
+        releaseCpuData();
+        return;
+    }
+    std::optional<StructuredData::ByteRange> vertexRange;
+    if (vertices.isDirty()) {
+        vertexRange = vertices.getDirtyRange();
+    }
+    if (vertexRange.has_value() || dirtyIndices.has_value()) {
+        updateInternalData(vertexRange, dirtyIndices);
+    }
+    vertices.clearDirtyRange();
+    dirtyIndices.reset();
+}
+
+bool Mesh::changeShader(RenderState& state, const Shader& shader) {
+    if (state.shader == &shader) {
+        state.stats.shaderChangesSkipped++;
+        return false;
+    }
+    state.shader = &shader;
+    state.stats.shaderChanges++;
+    return true;
+}
+
+bool Mesh::changeTexture(RenderState& state, int index, const Texture& texture) {
+    PGE_ASSERT(index >= 0 && index < RenderState::MAX_TEXTURES, "Texture index out of bounds (" + String::from(index) + ")");
+    if (state.textures[index] == &texture) {
+        state.stats.textureChangesSkipped++;
+        return false;
+    }
+    state.textures[index] = &texture;
+    state.stats.textureChanges++;
+    return true;
+}
+
+bool Mesh::changeDepthState(RenderState& state, bool opaque) {
+    if (state.opaque == opaque) {
+        state.stats.depthStateChangesSkipped++;
+        return false;
     }
+    state.opaque = opaque;
+    state.stats.depthStateChanges++;
+    return true;
 }
 
 Mesh::Line::Line(u32 a, u32 b) {
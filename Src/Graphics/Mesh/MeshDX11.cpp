@@ -12,22 +12,62 @@ void MeshDX11::uploadInternalData() {
         dxVertexBuffer = resourceManager.addNewResource<D3D11Buffer>(dxDevice, D3D11Buffer::Type::VERTEX, (void*)vertices.getData(), vertices.getDataSize());
     }
 
+    size_t indexSize = shortIndices ? sizeof(u16) : sizeof(u32);
     if (indices.size() > 0) {
         resourceManager.deleteResource(dxIndexBuffer);
-        dxIndexBuffer = resourceManager.addNewResource<D3D11Buffer>(dxDevice, D3D11Buffer::Type::INDEX, indices.data(), sizeof(u32) * (UINT)indices.size());
+        if (shortIndices) {
+            std::vector<u16> shortIndexData(indices.begin(), indices.end());
+            dxIndexBuffer = resourceManager.addNewResource<D3D11Buffer>(dxDevice, D3D11Buffer::Type::INDEX, shortIndexData.data(), indexSize * indices.size());
+        } else {
+            dxIndexBuffer = resourceManager.addNewResource<D3D11Buffer>(dxDevice, D3D11Buffer::Type::INDEX, indices.data(), indexSize * indices.size());
+        }
     }
+
+    setGpuBytes((u64)vertices.getDataSize() + indexSize * indices.size());
 }
 
-void MeshDX11::renderInternal() {
+void MeshDX11::updateInternalData(const std::optional<StructuredData::ByteRange>& vertexRange, const std::optional<IndexRange>& indexRange) {
+    // The driver renames buffers still in use by pending draws, so dynamic meshes need no special handling here.
+    ID3D11DeviceContext* dxContext = graphics.getDxContext();
+    D3D11_BOX dxBox;
+    dxBox.top = 0; dxBox.bottom = 1;
+    dxBox.front = 0; dxBox.back = 1;
+
+    if (vertexRange.has_value() && dxVertexBuffer.isHoldingResource()) {
+        dxBox.left = (UINT)vertexRange->offset;
+        dxBox.right = (UINT)(vertexRange->offset + vertexRange->size);
+        dxContext->UpdateSubresource(dxVertexBuffer, 0, &dxBox, vertices.getData() + vertexRange->offset, 0, 0);
+    }
+
+    if (indexRange.has_value() && dxIndexBuffer.isHoldingResource()) {
+        size_t indexSize = shortIndices ? sizeof(u16) : sizeof(u32);
+        dxBox.left = (UINT)(indexRange->first * indexSize);
+        dxBox.right = (UINT)((indexRange->first + indexRange->count) * indexSize);
+        if (shortIndices) {
+            std::vector<u16> shortIndexData(indices.begin() + indexRange->first, indices.begin() + indexRange->first + indexRange->count);
+            dxContext->UpdateSubresource(dxIndexBuffer, 0, &dxBox, shortIndexData.data(), 0, 0);
+        } else {
+            dxContext->UpdateSubresource(dxIndexBuffer, 0, &dxBox, indices.data() + indexRange->first, 0, 0);
+        }
+    }
+}
+
+void MeshDX11::renderInternal(RenderState& state) {
     ID3D11DeviceContext* dxContext = graphics.getDxContext();
 
     if (!dxVertexBuffer.isHoldingResource() || !dxIndexBuffer.isHoldingResource()) { return; }
 
-    ((ShaderDX11&)material->getShader()).useVertexInputLayout();
+    ShaderDX11& shader = ((ShaderDX11&)material->getShader());
+    if (changeShader(state, shader)) {
+        shader.useVertexInputLayout();
+        shader.useShader();
+        shader.useSamplers();
+    }
+    shader.updateConstantBuffers();
 
     UINT offset = 0; UINT stride = vertices.getLayout().getElementSize();
     dxContext->IASetVertexBuffers(0,1,&dxVertexBuffer,&stride,&offset);
-    dxContext->IASetIndexBuffer(dxIndexBuffer,DXGI_FORMAT_R32_UINT,0);
+    dxContext->IASetIndexBuffer(dxIndexBuffer,shortIndices ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT,0);
 
     D3D11_PRIMITIVE_TOPOLOGY dxPrimitiveTopology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
     if (primitiveType==PrimitiveType::LINE) {
@@ -36,23 +76,37 @@ void MeshDX11::renderInternal() {
 
     dxContext->IASetPrimitiveTopology(dxPrimitiveTopology);
 
-    ShaderDX11& shader = ((ShaderDX11&)material->getShader());
-
-    shader.useShader();
-    shader.useSamplers();
     for (int i=0;i<material->getTextureCount();i++) {
-        ((TextureDX11&)material->getTexture(i)).useTexture(i);
+        Texture& texture = material->getTexture(i);
+        if (changeTexture(state, i, texture)) {
+            ((TextureDX11&)texture).useTexture(i);
+        }
     }
 
-    graphics.setZBufferState(
-        graphics.getDepthTest()
-                ? (isOpaque() ? GraphicsDX11::ZBufferStateIndex::ENABLED_WRITE : GraphicsDX11::ZBufferStateIndex::ENABLED_NOWRITE)
-                : GraphicsDX11::ZBufferStateIndex::DISABLED);
+    if (changeDepthState(state, isOpaque())) {
+        graphics.setZBufferState(
+            graphics.getDepthTest()
+                    ? (isOpaque() ? GraphicsDX11::ZBufferStateIndex::ENABLED_WRITE : GraphicsDX11::ZBufferStateIndex::ENABLED_NOWRITE)
+                    : GraphicsDX11::ZBufferStateIndex::DISABLED);
+    }
     
-    dxContext->DrawIndexed((UINT)indices.size(),0,0);
+    IndexRange range = getDrawRange();
+    dxContext->DrawIndexed((UINT)range.count,(UINT)range.first,0);
+}
 
+void MeshDX11::renderInstancedInternal(RenderState& state, int count, const StructuredData& perInstance) {
+    // Requires per-instance input elements in the input layout, which the reflection info doesn't describe yet.
+    throw PGE_CREATE_EX("Instanced rendering is not supported by the DirectX 11 renderer");
+}
+
+void MeshDX11::finishRendering(RenderState& state) {
+    // Textures mustn't stay bound, they might be used as render targets next.
+    ID3D11DeviceContext* dxContext = graphics.getDxContext();
     ID3D11ShaderResourceView* nullResource = nullptr;
-    for (int i=0;i<material->getTextureCount();i++) {
-        dxContext->PSSetShaderResources(i,1,&nullResource);
+    for (int i=0;i<RenderState::MAX_TEXTURES;i++) {
+        if (state.textures[i] != nullptr) {
+            dxContext->PSSetShaderResources(i,1,&nullResource);
+            state.textures[i] = nullptr;
+        }
     }
 }
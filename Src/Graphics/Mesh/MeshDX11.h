@@ -29,7 +29,10 @@ class MeshDX11 : public Mesh {
         ResourceManager resourceManager;
 
         void uploadInternalData() override;
-        void renderInternal() override;
+        void updateInternalData(const std::optional<StructuredData::ByteRange>& vertexRange, const std::optional<IndexRange>& indexRange) override;
+        void renderInternal(RenderState& state) override;
+        void renderInstancedInternal(RenderState& state, int count, const StructuredData& perInstance) override;
+        void finishRendering(RenderState& state) override;
 };
 
 }
@@ -1,69 +1,268 @@
 #include "../GraphicsOGL3.h"
 
+#include <algorithm>
+
 using namespace PGE;
 
 MeshOGL3::MeshOGL3(Graphics& gfx) : resourceManager(gfx), graphics((GraphicsOGL3&)gfx) {
     graphics.takeGlContext();
 
-    glVertexBufferObject = resourceManager.addNewResource<GLBuffer>();
-    glIndexBufferObject = resourceManager.addNewResource<GLBuffer>();
+    glVertexBufferObject = resourceManager.addNewResource<GLBuffer>(graphics.getGlState());
+    glIndexBufferObject = resourceManager.addNewResource<GLBuffer>(graphics.getGlState());
+    glInstanceBufferObject = resourceManager.addNewResource<GLBuffer>(graphics.getGlState());
+
+    glVertexArrayObject = resourceManager.addNewResource<GLVertexArray>(graphics.getGlState());
+}
 
-    glVertexArrayObject = resourceManager.addNewResource<GLVertexArray>();
+MeshOGL3::~MeshOGL3() {
+    graphics.takeGlContext();
+    deleteRegionFences();
 }
 
 void MeshOGL3::prepareVertexOperation() {
     graphics.takeGlContext();
-    glBindVertexArray(glVertexArrayObject);
-    glBindBuffer(GL_ARRAY_BUFFER, glVertexBufferObject);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, glIndexBufferObject);
+    GLStateOGL3& glState = graphics.getGlState();
+    glState.bindVertexArray(glVertexArrayObject);
+    glState.bindBuffer(GL_ARRAY_BUFFER, glVertexBufferObject);
+    glState.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, glIndexBufferObject);
 }
 
 void MeshOGL3::uploadInternalData() {
     prepareVertexOperation();
+    deleteRegionFences();
 
     GLuint glError = GL_NO_ERROR;
 
-    //TODO: determine when we should use GL_DYNAMIC_DRAW
-    glBufferData(GL_ARRAY_BUFFER, vertices.getDataSize(), vertices.getData(),GL_STATIC_DRAW);
+    // Every region starts out with the full data.
+    int regionCount = usage == Usage::DYNAMIC ? DYNAMIC_REGION_COUNT : 1;
+    GLenum glUsage = usage == Usage::DYNAMIC ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW;
+    currentRegion = 0;
+    regionElementCount = usage == Usage::DYNAMIC ? vertices.getElementCount() : 0;
+    regionIndexCount = usage == Usage::DYNAMIC ? (int)indices.size() : 0;
+    previousUpdates = { };
+
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)vertices.getDataSize() * regionCount, nullptr, glUsage);
+    for (int i = 0; i < regionCount; i++) {
+        glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)vertices.getDataSize() * i, vertices.getDataSize(), vertices.getData());
+    }
     glError = glGetError();
     PGE_ASSERT(glError == GL_NO_ERROR, "Failed to create data store for vertex buffer (GLERROR: " + String::from(glError) + ")");
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER,indices.size()*sizeof(GLuint),indices.data(),GL_STATIC_DRAW);
+
+    u64 indexBytes = (u64)indices.size() * getIndexSize();
+    std::vector<byte> indexData(indexBytes);
+    writeIndices(indexData.data(), 0, (int)indices.size());
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)indexBytes * regionCount, nullptr, glUsage);
+    for (int i = 0; i < regionCount; i++) {
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, (GLintptr)indexBytes * i, (GLsizeiptr)indexBytes, indexData.data());
+    }
     glError = glGetError();
     PGE_ASSERT(glError == GL_NO_ERROR, "Failed to create data store for index buffer (GLERROR: " + String::from(glError) + ")");
+
+    geometryGpuBytes = ((u64)vertices.getDataSize() + indexBytes) * regionCount;
+    setGpuBytes(geometryGpuBytes + instanceGpuBytes);
+}
+
+void MeshOGL3::writeIndices(void* dst, int first, int count) const {
+    if (shortIndices) {
+        GLushort* shortDst = (GLushort*)dst;
+        for (int i = 0; i < count; i++) {
+            shortDst[i] = (GLushort)indices[first + i];
+        }
+    } else {
+        memcpy(dst, indices.data() + first, count * sizeof(GLuint));
+    }
+}
+
+int MeshOGL3::getIndexSize() const {
+    return shortIndices ? sizeof(GLushort) : sizeof(GLuint);
 }
 
-const static GLenum glTextureLayers[] = {
-    GL_TEXTURE0,
-    GL_TEXTURE1,
-    GL_TEXTURE2,
-    GL_TEXTURE3,
-    GL_TEXTURE4,
-    GL_TEXTURE5,
-    GL_TEXTURE6,
-    GL_TEXTURE7,
-};
-
-void MeshOGL3::renderInternal() {
+void MeshOGL3::updateInternalData(const std::optional<StructuredData::ByteRange>& vertexRange, const std::optional<IndexRange>& indexRange) {
     prepareVertexOperation();
 
+    if (usage == Usage::STATIC) {
+        if (vertexRange.has_value()) {
+            glBufferSubData(GL_ARRAY_BUFFER, vertexRange->offset, vertexRange->size, vertices.getData() + vertexRange->offset);
+        }
+        if (indexRange.has_value()) {
+            std::vector<byte> indexData((size_t)indexRange->count * getIndexSize());
+            writeIndices(indexData.data(), indexRange->first, indexRange->count);
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, (GLintptr)indexRange->first * getIndexSize(), (GLsizeiptr)indexData.size(), indexData.data());
+        }
+        GLenum glError = glGetError();
+        PGE_ASSERT(glError == GL_NO_ERROR, "Failed to update geometry buffers (GLERROR: " + String::from(glError) + ")");
+        return;
+    }
+
+    // Draws issued so far read the current region, the fence tells when they're done with it.
+    regionFences[currentRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    currentRegion = (currentRegion + 1) % DYNAMIC_REGION_COUNT;
+
+    // The next region was last written DYNAMIC_REGION_COUNT updates ago,
+    // so it's missing everything those updates since then modified, along with this one.
+    std::optional<StructuredData::ByteRange> vertexWrite = vertexRange;
+    std::optional<IndexRange> indexWrite = indexRange;
+    for (const RegionUpdate& update : previousUpdates) {
+        if (update.vertices.has_value()) {
+            if (!vertexWrite.has_value()) {
+                vertexWrite = update.vertices;
+            } else {
+                int end = std::max(vertexWrite->offset + vertexWrite->size, update.vertices->offset + update.vertices->size);
+                vertexWrite->offset = std::min(vertexWrite->offset, update.vertices->offset);
+                vertexWrite->size = end - vertexWrite->offset;
+            }
+        }
+        if (update.indices.has_value()) {
+            if (!indexWrite.has_value()) {
+                indexWrite = update.indices;
+            } else {
+                int end = std::max(indexWrite->first + indexWrite->count, update.indices->first + update.indices->count);
+                indexWrite->first = std::min(indexWrite->first, update.indices->first);
+                indexWrite->count = end - indexWrite->first;
+            }
+        }
+    }
+    for (int i = (int)previousUpdates.size() - 1; i > 0; i--) {
+        previousUpdates[i] = previousUpdates[i - 1];
+    }
+    previousUpdates[0] = RegionUpdate{ vertexRange, indexRange };
+
+    GLsync& fence = regionFences[currentRegion];
+    if (fence != nullptr) {
+        // Usually signaled long ago, otherwise this is where updating faster than the GPU draws stalls.
+        glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    // The fence guarantees no pending draw reads the ranges, so there's no need for the driver to synchronize.
+    GLbitfield mapFlags = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+    if (vertexWrite.has_value()) {
+        GLintptr regionOffset = (GLintptr)vertices.getDataSize() * currentRegion;
+        void* mapped = glMapBufferRange(GL_ARRAY_BUFFER, regionOffset + vertexWrite->offset, vertexWrite->size, mapFlags);
+        PGE_ASSERT(mapped != nullptr, "Failed to map vertex buffer (GLERROR: " + String::from(glGetError()) + ")");
+        memcpy(mapped, vertices.getData() + vertexWrite->offset, vertexWrite->size);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+    if (indexWrite.has_value()) {
+        GLintptr regionOffset = (GLintptr)regionIndexCount * getIndexSize() * currentRegion;
+        void* mapped = glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, regionOffset + (GLintptr)indexWrite->first * getIndexSize(),
+            (GLsizeiptr)indexWrite->count * getIndexSize(), mapFlags);
+        PGE_ASSERT(mapped != nullptr, "Failed to map index buffer (GLERROR: " + String::from(glGetError()) + ")");
+        writeIndices(mapped, indexWrite->first, indexWrite->count);
+        glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
+    }
+}
+
+void MeshOGL3::deleteRegionFences() {
+    for (GLsync& fence : regionFences) {
+        if (fence != nullptr) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+}
+
+void MeshOGL3::bindVertexArray(ShaderOGL3& shader, bool instanced) {
+    GLStateOGL3& glState = graphics.getGlState();
+    bindCount++;
+    for (VertexArray& vertexArray : vertexArrays) {
+        if (vertexArray.shader == &shader && vertexArray.shaderRevision == shader.getRevision() && vertexArray.instanced == instanced) {
+            vertexArray.lastBind = bindCount;
+            glState.bindVertexArray(vertexArray.glVertexArrayObject);
+            return;
+        }
+    }
+
+    // The shader was reloaded, or a new one took the place of a deleted one.
+    auto isStale = [&](const VertexArray& vertexArray) {
+        return vertexArray.shader == &shader && vertexArray.shaderRevision != shader.getRevision();
+    };
+    for (VertexArray& vertexArray : vertexArrays) {
+        if (isStale(vertexArray)) { resourceManager.deleteResource(vertexArray.glVertexArrayObject); }
+    }
+    vertexArrays.erase(std::remove_if(vertexArrays.begin(), vertexArrays.end(), isStale), vertexArrays.end());
+
+    if (vertexArrays.size() >= MAX_VERTEX_ARRAYS) {
+        auto leastRecentlyUsed = std::min_element(vertexArrays.begin(), vertexArrays.end(),
+            [](const VertexArray& a, const VertexArray& b) { return a.lastBind < b.lastBind; });
+        resourceManager.deleteResource(leastRecentlyUsed->glVertexArrayObject);
+        vertexArrays.erase(leastRecentlyUsed);
+    }
+
+    GLVertexArray::View glVao = resourceManager.addNewResource<GLVertexArray>(graphics.getGlState());
+    glState.bindVertexArray(glVao);
+    glState.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, glIndexBufferObject);
+    shader.setUpVertexArray(glVertexBufferObject, instanced ? glInstanceBufferObject.get() : 0);
+    vertexArrays.push_back(VertexArray{ &shader, shader.getRevision(), instanced, glVao, bindCount });
+}
+
+ShaderOGL3& MeshOGL3::prepareDraw(RenderState& state, bool instanced) {
+    graphics.takeGlContext();
+    GLStateOGL3& glState = graphics.getGlState();
+
     for (int i=0;i<material->getTextureCount();i++) {
-        glActiveTexture(glTextureLayers[i]);
-        glBindTexture(GL_TEXTURE_2D,((TextureOGL3&)material->getTexture(i)).getGlTexture());
+        Texture& texture = material->getTexture(i);
+        if (changeTexture(state, i, texture)) {
+            glState.bindTexture(i,((TextureOGL3&)texture).getGlTexture());
+        }
     }
 
-    ((ShaderOGL3&)material->getShader()).useShader();
+    ShaderOGL3& shader = (ShaderOGL3&)material->getShader();
+    if (changeShader(state, shader)) {
+        shader.useProgram();
+    }
+    bindVertexArray(shader, instanced);
+    shader.uploadConstants();
+
+    if (changeDepthState(state, isOpaque())) {
+        glState.setDepthMask(isOpaque());
+        glState.setColorMask(true,true,true,!isOpaque());
+    }
 
+    return shader;
+}
+
+GLenum MeshOGL3::getGlPrimitiveType() const {
     GLenum glPrimitiveType = GL_TRIANGLES;
     if (primitiveType==PrimitiveType::LINE) {
         glPrimitiveType=GL_LINES;
     }
+    return glPrimitiveType;
+}
 
-    glDepthMask(isOpaque());
-    glColorMask(true,true,true,!isOpaque());
+GLenum MeshOGL3::getGlIndexType() const {
+    return shortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
 
-    glDrawElements(glPrimitiveType,(GLsizei)indices.size(),GL_UNSIGNED_INT,nullptr);
+const void* MeshOGL3::getIndexOffset(const IndexRange& range) const {
+    return (const void*)(((size_t)currentRegion * regionIndexCount + range.first) * getIndexSize());
+}
+
+void MeshOGL3::renderInternal(RenderState& state) {
+    prepareDraw(state, false);
 
-    ((ShaderOGL3&)material->getShader()).unbindGLAttribs();
-    glBindVertexArray(0);
+    IndexRange range = getDrawRange();
+    glDrawElementsBaseVertex(getGlPrimitiveType(),(GLsizei)range.count,getGlIndexType(),getIndexOffset(range),currentRegion*regionElementCount);
 }
 
+void MeshOGL3::renderInstancedInternal(RenderState& state, int count, const StructuredData& perInstance) {
+    prepareDraw(state, true);
+    GLStateOGL3& glState = graphics.getGlState();
+
+    // Orphaning the old storage lets the driver hand out fresh memory instead of waiting for previous draws.
+    // The vertex array refers to the buffer object, so it stays valid.
+    int instanceDataSize = count * perInstance.getLayout().getElementSize();
+    glState.bindBuffer(GL_ARRAY_BUFFER, glInstanceBufferObject);
+    glBufferData(GL_ARRAY_BUFFER, instanceDataSize, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, instanceDataSize, perInstance.getData());
+    if ((u64)instanceDataSize != instanceGpuBytes) {
+        instanceGpuBytes = instanceDataSize;
+        setGpuBytes(geometryGpuBytes + instanceGpuBytes);
+    }
+
+    IndexRange range = getDrawRange();
+    glDrawElementsInstancedBaseVertex(getGlPrimitiveType(),(GLsizei)range.count,getGlIndexType(),getIndexOffset(range),count,currentRegion*regionElementCount);
+    GLenum glError = glGetError();
+    PGE_ASSERT(glError == GL_NO_ERROR, "Failed to draw instances (GLERROR: " + String::from(glError) + ")");
+}
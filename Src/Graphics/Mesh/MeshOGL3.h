@@ -4,6 +4,7 @@
 #include <PGE/Graphics/Mesh.h>
 
 #include <vector>
+#include <array>
 
 #include <glad/gl.h>
 
@@ -13,23 +14,76 @@
 namespace PGE {
 
 class GraphicsOGL3;
+class ShaderOGL3;
 class MeshOGL3 : public Mesh {
     public:
         MeshOGL3(Graphics& gfx);
+        ~MeshOGL3();
 
     private:
         GraphicsOGL3& graphics;
 
         void prepareVertexOperation();
+        ShaderOGL3& prepareDraw(RenderState& state, bool instanced);
+        GLenum getGlPrimitiveType() const;
+        GLenum getGlIndexType() const;
+        // Byte offset of the first index to draw, passed in place of a pointer.
+        const void* getIndexOffset(const IndexRange& range) const;
 
         void uploadInternalData() override;
-        void renderInternal() override;
+        void updateInternalData(const std::optional<StructuredData::ByteRange>& vertexRange, const std::optional<IndexRange>& indexRange) override;
+        void renderInternal(RenderState& state) override;
+        void renderInstancedInternal(RenderState& state, int count, const StructuredData& perInstance) override;
 
         GLBuffer::View glVertexBufferObject;
         GLBuffer::View glIndexBufferObject;
+        // Streamed on every instanced draw.
+        GLBuffer::View glInstanceBufferObject;
 
+        u64 geometryGpuBytes = 0;
+        u64 instanceGpuBytes = 0;
+
+        // Dynamic meshes keep this many copies of their vertices and indices in the vertex and index buffers.
+        // Each update writes the next region, only waiting if the GPU is still reading it from that many updates ago.
+        static constexpr int DYNAMIC_REGION_COUNT = 3;
+        int currentRegion = 0;
+        // In elements, so draws can select the region through the base vertex.
+        int regionElementCount = 0;
+        // Draws select the region of the indices through the index offset.
+        int regionIndexCount = 0;
+        struct RegionUpdate {
+            // In bytes.
+            std::optional<StructuredData::ByteRange> vertices;
+            std::optional<IndexRange> indices;
+        };
+        // What the previous updates modified, to bring the next region up to date.
+        std::array<RegionUpdate, DYNAMIC_REGION_COUNT - 1> previousUpdates;
+        // Converts to 16-bit indices if needed.
+        void writeIndices(void* dst, int first, int count) const;
+        int getIndexSize() const;
+        // Signaled once the GPU is done with all draws issued before the region was left.
+        std::array<GLsync, DYNAMIC_REGION_COUNT> regionFences = { };
+        void deleteRegionFences();
+
+        // Only used for uploads, draws use one of the vertex arrays below.
         GLVertexArray::View glVertexArrayObject;
 
+        // The attribute setup only depends on the shader and the buffer objects, which never change,
+        // so it's recorded once per shader rather than on every draw.
+        struct VertexArray {
+            const ShaderOGL3* shader;
+            u64 shaderRevision;
+            bool instanced;
+            GLVertexArray::View glVertexArrayObject;
+            // Compared against bindCount to find the least recently used vertex array.
+            u64 lastBind;
+        };
+        // Vertex arrays of deleted shaders are never looked up again, so the least recently used one is dropped past this many.
+        static constexpr int MAX_VERTEX_ARRAYS = 8;
+        std::vector<VertexArray> vertexArrays;
+        u64 bindCount = 0;
+        void bindVertexArray(ShaderOGL3& shader, bool instanced);
+
         ResourceManagerOGL3 resourceManager;
 };
 
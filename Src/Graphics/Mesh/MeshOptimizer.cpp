@@ -0,0 +1,628 @@
+#include <PGE/Graphics/MeshOptimizer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace PGE;
+
+static u64 getIndexBytes(int indexCount, int vertexCount) {
+    return (u64)indexCount * (vertexCount <= Mesh::MAX_SHORT_INDEX_VERTICES ? sizeof(u16) : sizeof(u32));
+}
+
+static u64 getGeometryBytes(const StructuredData& vertices, const std::vector<u32>& indices) {
+    return (u64)vertices.getDataSize() + getIndexBytes((int)indices.size(), vertices.getElementCount());
+}
+
+// FNV-1a.
+static u64 hashBytes(const byte* data, int size) {
+    u64 hash = 0xcbf29ce484222325;
+    for (int i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+static void weld(StructuredData& vertices, std::vector<u32>& indices) {
+    int elemSize = vertices.getLayout().getElementSize();
+    const byte* data = vertices.getData();
+
+    std::vector<int> remap(vertices.getElementCount());
+    std::vector<int> uniqueVertices;
+    // Maps a hash to the last unique vertex with it, earlier ones are chained through previousWithHash.
+    std::unordered_map<u64, int> lastWithHash;
+    std::vector<int> previousWithHash;
+    for (int i = 0; i < vertices.getElementCount(); i++) {
+        const byte* elem = data + (size_t)i * elemSize;
+        auto [it, inserted] = lastWithHash.emplace(hashBytes(elem, elemSize), (int)uniqueVertices.size());
+        if (!inserted) {
+            int candidate = it->second;
+            while (candidate >= 0 && memcmp(data + (size_t)uniqueVertices[candidate] * elemSize, elem, elemSize) != 0) {
+                candidate = previousWithHash[candidate];
+            }
+            if (candidate >= 0) {
+                remap[i] = candidate;
+                continue;
+            }
+            previousWithHash.push_back(it->second);
+            it->second = (int)uniqueVertices.size();
+        } else {
+            previousWithHash.push_back(-1);
+        }
+        remap[i] = (int)uniqueVertices.size();
+        uniqueVertices.push_back(i);
+    }
+
+    if ((int)uniqueVertices.size() == vertices.getElementCount()) { return; }
+    vertices = vertices.gather(uniqueVertices);
+    for (u32& index : indices) {
+        index = remap[index];
+    }
+}
+
+// Tom Forsyth's "Linear-Speed Vertex Cache Optimisation".
+// Greedily emits the triangle whose vertices score highest, favoring vertices that are in the cache
+// and vertices with few triangles left, so that no lonely triangles are left behind.
+static constexpr int FORSYTH_CACHE_SIZE = 32;
+
+static float computeVertexScore(int cachePosition, int remainingTriangles) {
+    if (remainingTriangles == 0) { return -1.f; }
+
+    float score = 0.f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // The vertices of the last triangle are scored equally, or the order they were added in would matter.
+            score = 0.75f;
+        } else {
+            score = std::pow(1.f - (float)(cachePosition - 3) / (FORSYTH_CACHE_SIZE - 3), 1.5f);
+        }
+    }
+    return score + 2.f / std::sqrt((float)remainingTriangles);
+}
+
+static void optimizeVertexCache(std::vector<u32>& indices, int vertexCount) {
+    int triangleCount = (int)indices.size() / 3;
+    if (triangleCount == 0) { return; }
+
+    // The triangles using each vertex, flattened.
+    std::vector<int> adjacencyOffsets(vertexCount + 1, 0);
+    for (u32 index : indices) {
+        adjacencyOffsets[index + 1]++;
+    }
+    for (int i = 0; i < vertexCount; i++) {
+        adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+    }
+    std::vector<int> adjacency(indices.size());
+    std::vector<int> remainingTriangles(vertexCount, 0);
+    for (int i = 0; i < (int)indices.size(); i++) {
+        u32 vertex = indices[i];
+        adjacency[adjacencyOffsets[vertex] + remainingTriangles[vertex]++] = i / 3;
+    }
+
+    std::vector<int> cachePositions(vertexCount, -1);
+    std::vector<float> vertexScores(vertexCount);
+    for (int i = 0; i < vertexCount; i++) {
+        vertexScores[i] = computeVertexScore(-1, remainingTriangles[i]);
+    }
+    std::vector<float> triangleScores(triangleCount);
+    for (int i = 0; i < triangleCount; i++) {
+        triangleScores[i] = vertexScores[indices[i * 3]] + vertexScores[indices[i * 3 + 1]] + vertexScores[indices[i * 3 + 2]];
+    }
+    std::vector<bool> emitted(triangleCount, false);
+
+    std::vector<u32> result;
+    result.reserve(indices.size());
+    std::vector<int> cache;
+    std::vector<int> newCache;
+    int bestTriangle = -1;
+    // Where to continue looking when the cache has nothing to offer.
+    int scanPosition = 0;
+    for (int emittedCount = 0; emittedCount < triangleCount; emittedCount++) {
+        if (bestTriangle < 0) {
+            while (emitted[scanPosition]) { scanPosition++; }
+            bestTriangle = scanPosition;
+        }
+
+        emitted[bestTriangle] = true;
+        newCache.clear();
+        for (int i = 0; i < 3; i++) {
+            u32 vertex = indices[bestTriangle * 3 + i];
+            result.push_back(vertex);
+            newCache.push_back(vertex);
+
+            // Swap-removes the triangle from the vertex's remaining ones.
+            int* begin = adjacency.data() + adjacencyOffsets[vertex];
+            int* end = begin + remainingTriangles[vertex];
+            for (int* it = begin; it != end; it++) {
+                if (*it == bestTriangle) {
+                    *it = *(end - 1);
+                    break;
+                }
+            }
+            remainingTriangles[vertex]--;
+        }
+        for (int vertex : cache) {
+            if (vertex != newCache[0] && vertex != newCache[1] && vertex != newCache[2]) {
+                newCache.push_back(vertex);
+            }
+        }
+        std::swap(cache, newCache);
+
+        // Rescores everything that was or is in the cache, evicted vertices included.
+        for (int i = 0; i < (int)cache.size(); i++) {
+            cachePositions[cache[i]] = i < FORSYTH_CACHE_SIZE ? i : -1;
+        }
+        bestTriangle = -1;
+        float bestScore = -1.f;
+        for (int vertex : cache) {
+            float oldScore = vertexScores[vertex];
+            vertexScores[vertex] = computeVertexScore(cachePositions[vertex], remainingTriangles[vertex]);
+            float scoreDelta = vertexScores[vertex] - oldScore;
+            for (int i = 0; i < remainingTriangles[vertex]; i++) {
+                int triangle = adjacency[adjacencyOffsets[vertex] + i];
+                triangleScores[triangle] += scoreDelta;
+                if (triangleScores[triangle] > bestScore) {
+                    bestScore = triangleScores[triangle];
+                    bestTriangle = triangle;
+                }
+            }
+        }
+        if (cache.size() > FORSYTH_CACHE_SIZE) {
+            cache.resize(FORSYTH_CACHE_SIZE);
+        }
+    }
+
+    indices = std::move(result);
+}
+
+static void optimizeVertexFetch(StructuredData& vertices, std::vector<u32>& indices) {
+    std::vector<int> remap(vertices.getElementCount(), -1);
+    std::vector<int> order;
+    order.reserve(vertices.getElementCount());
+    for (u32& index : indices) {
+        if (remap[index] < 0) {
+            remap[index] = (int)order.size();
+            order.push_back(index);
+        }
+        index = remap[index];
+    }
+    vertices = vertices.gather(order);
+}
+
+// Garland and Heckbert's "Surface Simplification Using Quadric Error Metrics",
+// restricted to collapsing edges into one of their vertices so that the vertex data can be shared by all levels of detail.
+namespace {
+
+// The sum of squared distances to a set of planes, as a symmetric 4x4 matrix.
+struct Quadric {
+    double xx = 0.0, xy = 0.0, xz = 0.0, xw = 0.0;
+    double yy = 0.0, yz = 0.0, yw = 0.0;
+    double zz = 0.0, zw = 0.0;
+    double ww = 0.0;
+
+    // The normal must be normalized, the plane is normal . p + d = 0.
+    static const Quadric fromPlane(const Vector3f& n, float d, double weight) {
+        Quadric q;
+        q.xx = weight * n.x * n.x; q.xy = weight * n.x * n.y; q.xz = weight * n.x * n.z; q.xw = weight * n.x * d;
+        q.yy = weight * n.y * n.y; q.yz = weight * n.y * n.z; q.yw = weight * n.y * d;
+        q.zz = weight * n.z * n.z; q.zw = weight * n.z * d;
+        q.ww = weight * d * d;
+        return q;
+    }
+
+    void operator+=(const Quadric& other) {
+        xx += other.xx; xy += other.xy; xz += other.xz; xw += other.xw;
+        yy += other.yy; yz += other.yz; yw += other.yw;
+        zz += other.zz; zw += other.zw;
+        ww += other.ww;
+    }
+
+    double evaluate(const Vector3f& p) const {
+        double x = p.x, y = p.y, z = p.z;
+        return xx * x * x + yy * y * y + zz * z * z + ww
+            + 2.0 * (xy * x * y + xz * x * z + xw * x + yz * y * z + yw * y + zw * z);
+    }
+};
+
+// Planes aren't weighted by area, so that the error is at least the distance to the farthest of them.
+// Borders are weighted heavily, as moving them opens visible holes.
+constexpr double BORDER_WEIGHT = 10.0;
+
+class Simplifier {
+    public:
+        Simplifier(const StructuredData& vertices, const std::vector<u32>& indices, const MeshOptimizer::SimplifyOptions& options);
+
+        // Collapses edges until at most targetIndexCount indices are left, or the next collapse would exceed the maximum error.
+        void collapseUntil(int targetIndexCount);
+
+        const std::vector<u32> getIndices() const;
+        const std::vector<u32> getRemap() const;
+        int getIndexCount() const;
+        float getError() const;
+
+    private:
+        enum class Kind {
+            FREE,
+            // On an open border, may only move along it.
+            BORDER,
+            // On a seam or a non-manifold edge, may not move.
+            LOCKED,
+        };
+
+        struct Collapse {
+            double cost;
+            int from;
+            int to;
+            // Of both vertices, candidates outdated by a collapse into either of them are skipped.
+            int fromVersion;
+            int toVersion;
+
+            // Cheapest on top of the queue.
+            bool operator<(const Collapse& other) const { return cost > other.cost; }
+        };
+
+        std::vector<Vector3f> positions;
+        int attributeCount = 0;
+        std::vector<float> attributes;
+        float attributeWeight;
+        double maxCost;
+
+        std::vector<Quadric> quadrics;
+        std::vector<Kind> kinds;
+        std::vector<int> versions;
+        std::vector<bool> removed;
+        std::vector<u32> collapsedInto;
+
+        std::vector<u32> triangles;
+        std::vector<bool> triangleAlive;
+        std::vector<std::vector<int>> vertexTriangles;
+        int aliveIndexCount = 0;
+
+        std::unordered_set<u64> borderEdges;
+        std::priority_queue<Collapse> queue;
+        double appliedCost = 0.0;
+
+        static u64 getEdgeKey(u32 a, u32 b) {
+            return a < b ? ((u64)a << 32 | b) : ((u64)b << 32 | a);
+        }
+
+        void pushCandidate(int from, int to);
+        bool flips(int from, int to) const;
+        void collapse(int from, int to);
+};
+
+Simplifier::Simplifier(const StructuredData& vertices, const std::vector<u32>& indices, const MeshOptimizer::SimplifyOptions& options)
+    : attributeWeight(options.attributeWeight), maxCost((double)options.maxError * options.maxError) {
+    const StructuredData::ElemLayout& layout = vertices.getLayout();
+    String::Key positionKey("position");
+    PGE_ASSERT(layout.hasEntry(positionKey), "Vertices have no position entry");
+    const StructuredData::ElemLayout::LocationAndSize& positionLocation = layout.getLocationAndSize(positionKey);
+    PGE_ASSERT(positionLocation.size == sizeof(Vector3f) || positionLocation.size == sizeof(Vector4f),
+        "Position entry is neither a Vector3f nor a Vector4f (size " + String::from(positionLocation.size) + ")");
+
+    int vertexCount = vertices.getElementCount();
+    int stride = layout.getElementSize();
+    const byte* data = vertices.getData();
+
+    // Normalized to the bounds, so that errors are relative to their radius and comparable to attribute differences.
+    AABBox bounds = vertices.computeBounds(positionKey);
+    Vector3f center = bounds.getCenter();
+    float radius = bounds.getDims().length() * 0.5f;
+    if (radius <= 0.f) { radius = 1.f; }
+    positions.resize(vertexCount);
+    for (int i = 0; i < vertexCount; i++) {
+        Vector3f position;
+        memcpy(&position, data + (size_t)i * stride + positionLocation.location, sizeof(Vector3f));
+        positions[i] = (position - center) / radius;
+    }
+
+    for (const String::Key& attribute : options.attributes) {
+        const StructuredData::ElemLayout::LocationAndSize& location = layout.getLocationAndSize(attribute);
+        PGE_ASSERT(location.size % sizeof(float) == 0, "Attribute \"" + String::hexFromInt(attribute.hash) + "\" isn't made of floats");
+        attributeCount += location.size / sizeof(float);
+    }
+    attributes.reserve((size_t)vertexCount * attributeCount);
+    for (int i = 0; i < vertexCount; i++) {
+        for (const String::Key& attribute : options.attributes) {
+            const StructuredData::ElemLayout::LocationAndSize& location = layout.getLocationAndSize(attribute);
+            for (int j = 0; j < location.size / (int)sizeof(float); j++) {
+                float value;
+                memcpy(&value, data + (size_t)i * stride + location.location + j * sizeof(float), sizeof(float));
+                attributes.push_back(value);
+            }
+        }
+    }
+
+    quadrics.resize(vertexCount);
+    kinds.resize(vertexCount, Kind::FREE);
+    versions.resize(vertexCount, 0);
+    removed.resize(vertexCount, false);
+    collapsedInto.resize(vertexCount);
+    for (int i = 0; i < vertexCount; i++) { collapsedInto[i] = i; }
+    vertexTriangles.resize(vertexCount);
+
+    // Degenerate triangles draw nothing and are dropped right away.
+    std::unordered_map<u64, int> edgeUses;
+    for (int i = 0; i < (int)indices.size(); i += 3) {
+        u32 a = indices[i], b = indices[i + 1], c = indices[i + 2];
+        PGE_ASSERT(a < (u32)vertexCount && b < (u32)vertexCount && c < (u32)vertexCount, "Index out of range");
+        if (a == b || b == c || c == a) { continue; }
+        int triangle = (int)triangles.size() / 3;
+        triangles.insert(triangles.end(), { a, b, c });
+        triangleAlive.push_back(true);
+        for (int k = 0; k < 3; k++) {
+            u32 v = triangles[triangle * 3 + k];
+            vertexTriangles[v].push_back(triangle);
+            edgeUses[getEdgeKey(v, triangles[triangle * 3 + (k + 1) % 3])]++;
+        }
+
+        Vector3f normal = (positions[b] - positions[a]).crossProduct(positions[c] - positions[a]);
+        float doubleArea = normal.length();
+        if (doubleArea > 0.f) {
+            normal = normal / doubleArea;
+            Quadric q = Quadric::fromPlane(normal, -normal.dotProduct(positions[a]), 1.0);
+            quadrics[a] += q; quadrics[b] += q; quadrics[c] += q;
+        }
+    }
+    aliveIndexCount = (int)triangles.size();
+
+    for (int triangle = 0; triangle < (int)triangleAlive.size(); triangle++) {
+        for (int k = 0; k < 3; k++) {
+            u32 a = triangles[triangle * 3 + k];
+            u32 b = triangles[triangle * 3 + (k + 1) % 3];
+            int uses = edgeUses[getEdgeKey(a, b)];
+            if (uses > 2) {
+                kinds[a] = Kind::LOCKED; kinds[b] = Kind::LOCKED;
+            } else if (uses == 1) {
+                borderEdges.insert(getEdgeKey(a, b));
+                if (kinds[a] == Kind::FREE) { kinds[a] = Kind::BORDER; }
+                if (kinds[b] == Kind::FREE) { kinds[b] = Kind::BORDER; }
+
+                // A plane through the edge, perpendicular to the triangle, keeps the border in place.
+                u32 c = triangles[triangle * 3 + (k + 2) % 3];
+                Vector3f edge = positions[b] - positions[a];
+                Vector3f normal = edge.crossProduct((positions[c] - positions[a]).crossProduct(edge));
+                // Not normalize, which treats short vectors as zero.
+                float length = normal.length();
+                if (length <= 0.f) { continue; }
+                normal = normal / length;
+                Quadric q = Quadric::fromPlane(normal, -normal.dotProduct(positions[a]), BORDER_WEIGHT);
+                quadrics[a] += q; quadrics[b] += q;
+            }
+        }
+    }
+
+    // Duplicated vertices with different attributes would tear apart if only one of them moved.
+    std::unordered_map<u64, int> firstAtPosition;
+    for (int i = 0; i < vertexCount; i++) {
+        if (vertexTriangles[i].empty()) { continue; }
+        auto [it, inserted] = firstAtPosition.emplace(hashBytes((const byte*)&positions[i], sizeof(Vector3f)), i);
+        if (!inserted && positions[it->second] == positions[i]) {
+            kinds[i] = Kind::LOCKED;
+            kinds[it->second] = Kind::LOCKED;
+        }
+    }
+
+    for (int i = 0; i < (int)triangles.size(); i += 3) {
+        for (int k = 0; k < 3; k++) {
+            pushCandidate(triangles[i + k], triangles[i + (k + 1) % 3]);
+            pushCandidate(triangles[i + (k + 1) % 3], triangles[i + k]);
+        }
+    }
+}
+
+void Simplifier::pushCandidate(int from, int to) {
+    if (kinds[from] == Kind::LOCKED) { return; }
+    if (kinds[from] == Kind::BORDER && borderEdges.find(getEdgeKey(from, to)) == borderEdges.end()) { return; }
+
+    Quadric q = quadrics[from];
+    q += quadrics[to];
+    double cost = std::max(0.0, q.evaluate(positions[to]));
+    for (int i = 0; i < attributeCount; i++) {
+        double diff = attributes[(size_t)from * attributeCount + i] - attributes[(size_t)to * attributeCount + i];
+        cost += attributeWeight * diff * diff;
+    }
+    queue.push(Collapse{ cost, from, to, versions[from], versions[to] });
+}
+
+bool Simplifier::flips(int from, int to) const {
+    for (int triangle : vertexTriangles[from]) {
+        if (!triangleAlive[triangle]) { continue; }
+        const u32* tri = &triangles[triangle * 3];
+        if (tri[0] == (u32)to || tri[1] == (u32)to || tri[2] == (u32)to) { continue; }
+
+        Vector3f before[3];
+        Vector3f after[3];
+        for (int k = 0; k < 3; k++) {
+            before[k] = positions[tri[k]];
+            after[k] = tri[k] == (u32)from ? positions[to] : before[k];
+        }
+        Vector3f normalBefore = (before[1] - before[0]).crossProduct(before[2] - before[0]);
+        Vector3f normalAfter = (after[1] - after[0]).crossProduct(after[2] - after[0]);
+        if (normalBefore.dotProduct(normalAfter) <= 0.f) { return true; }
+    }
+    return false;
+}
+
+void Simplifier::collapse(int from, int to) {
+    for (int triangle : vertexTriangles[from]) {
+        if (!triangleAlive[triangle]) { continue; }
+        u32* tri = &triangles[triangle * 3];
+        if (tri[0] == (u32)to || tri[1] == (u32)to || tri[2] == (u32)to) {
+            triangleAlive[triangle] = false;
+            aliveIndexCount -= 3;
+            continue;
+        }
+        for (int k = 0; k < 3; k++) {
+            if (tri[k] == (u32)from) {
+                tri[k] = to;
+            } else if (borderEdges.find(getEdgeKey(from, tri[k])) != borderEdges.end()) {
+                borderEdges.insert(getEdgeKey(to, tri[k]));
+            }
+        }
+        vertexTriangles[to].push_back(triangle);
+    }
+    quadrics[to] += quadrics[from];
+    removed[from] = true;
+    collapsedInto[from] = to;
+    std::vector<int>().swap(vertexTriangles[from]);
+
+    std::vector<int>& toTriangles = vertexTriangles[to];
+    toTriangles.erase(std::remove_if(toTriangles.begin(), toTriangles.end(), [&](int t) { return !triangleAlive[t]; }), toTriangles.end());
+
+    // Every candidate from or to the target was priced with its old quadric.
+    versions[to]++;
+    for (int triangle : toTriangles) {
+        for (int k = 0; k < 3; k++) {
+            int neighbor = triangles[triangle * 3 + k];
+            if (neighbor == to) { continue; }
+            pushCandidate(to, neighbor);
+            pushCandidate(neighbor, to);
+        }
+    }
+}
+
+void Simplifier::collapseUntil(int targetIndexCount) {
+    while (aliveIndexCount > targetIndexCount && !queue.empty()) {
+        Collapse candidate = queue.top();
+        if (candidate.cost > maxCost) { break; }
+        queue.pop();
+
+        if (removed[candidate.from] || removed[candidate.to]
+            || versions[candidate.from] != candidate.fromVersion || versions[candidate.to] != candidate.toVersion) {
+            continue;
+        }
+        if (flips(candidate.from, candidate.to)) { continue; }
+        collapse(candidate.from, candidate.to);
+        appliedCost = std::max(appliedCost, candidate.cost);
+    }
+}
+
+const std::vector<u32> Simplifier::getIndices() const {
+    std::vector<u32> result;
+    result.reserve(aliveIndexCount);
+    for (int triangle = 0; triangle < (int)triangleAlive.size(); triangle++) {
+        if (triangleAlive[triangle]) {
+            result.insert(result.end(), triangles.begin() + triangle * 3, triangles.begin() + triangle * 3 + 3);
+        }
+    }
+    return result;
+}
+
+const std::vector<u32> Simplifier::getRemap() const {
+    std::vector<u32> result(collapsedInto.size());
+    for (int i = 0; i < (int)collapsedInto.size(); i++) {
+        u32 v = i;
+        while (collapsedInto[v] != v) { v = collapsedInto[v]; }
+        result[i] = v;
+    }
+    return result;
+}
+
+int Simplifier::getIndexCount() const {
+    return aliveIndexCount;
+}
+
+float Simplifier::getError() const {
+    return (float)std::sqrt(appliedCost);
+}
+
+}
+
+// Levels removing less than this share of the previous one's indices aren't worth their memory.
+static constexpr float LOD_STALL_RATIO = 0.9f;
+
+const MeshOptimizer::Report MeshOptimizer::optimize(StructuredData& vertices, std::vector<u32>& indices, Mesh::PrimitiveType type, const Options& options) {
+    int primitiveSize = type == Mesh::PrimitiveType::TRIANGLE ? 3 : 2;
+    PGE_ASSERT(indices.size() % primitiveSize == 0, "Index count doesn't match the primitive type (" + String::from((int)indices.size()) + ")");
+    for (u32 index : indices) {
+        PGE_ASSERT(index < (u32)vertices.getElementCount(), "Index out of range (" + String::from(index) + ")");
+    }
+
+    Report report;
+    report.verticesBefore = vertices.getElementCount();
+    report.bytesBefore = getGeometryBytes(vertices, indices);
+    if (type == Mesh::PrimitiveType::TRIANGLE) {
+        report.acmrBefore = computeACMR(indices);
+    }
+
+    if (options.weld) {
+        weld(vertices, indices);
+    }
+    if (options.optimizeVertexCache && type == Mesh::PrimitiveType::TRIANGLE) {
+        optimizeVertexCache(indices, vertices.getElementCount());
+    }
+    // After the triangles were reordered, as the fetch order follows them.
+    if (options.optimizeVertexFetch) {
+        optimizeVertexFetch(vertices, indices);
+    }
+
+    report.verticesAfter = vertices.getElementCount();
+    report.bytesAfter = getGeometryBytes(vertices, indices);
+    if (type == Mesh::PrimitiveType::TRIANGLE) {
+        report.acmrAfter = computeACMR(indices);
+    }
+    return report;
+}
+
+float MeshOptimizer::computeACMR(const std::vector<u32>& indices) {
+    int triangleCount = (int)indices.size() / 3;
+    if (triangleCount == 0) { return 0.f; }
+
+    u32 cache[CACHE_SIZE];
+    int cacheFill = 0;
+    int cacheNext = 0;
+    int misses = 0;
+    for (int i = 0; i < triangleCount * 3; i++) {
+        bool hit = false;
+        for (int j = 0; j < cacheFill; j++) {
+            if (cache[j] == indices[i]) {
+                hit = true;
+                break;
+            }
+        }
+        if (hit) { continue; }
+
+        misses++;
+        cache[cacheNext] = indices[i];
+        cacheNext = (cacheNext + 1) % CACHE_SIZE;
+        if (cacheFill < CACHE_SIZE) { cacheFill++; }
+    }
+    return (float)misses / triangleCount;
+}
+
+float MeshOptimizer::simplify(const StructuredData& vertices, std::vector<u32>& indices, int targetIndexCount, const SimplifyOptions& options,
+    std::vector<u32>* remap) {
+    PGE_ASSERT(indices.size() % 3 == 0, "Index count isn't a multiple of 3 (" + String::from((int)indices.size()) + ")");
+    Simplifier simplifier(vertices, indices, options);
+    simplifier.collapseUntil(targetIndexCount);
+    indices = simplifier.getIndices();
+    if (remap != nullptr) { *remap = simplifier.getRemap(); }
+    return simplifier.getError();
+}
+
+const std::vector<Mesh::Lod> MeshOptimizer::generateLods(const StructuredData& vertices, const std::vector<u32>& indices, int count, float reduction,
+    const SimplifyOptions& options) {
+    PGE_ASSERT(indices.size() % 3 == 0, "Index count isn't a multiple of 3 (" + String::from((int)indices.size()) + ")");
+    // A single pass, taking a snapshot whenever the next level's index count is reached.
+    Simplifier simplifier(vertices, indices, options);
+    std::vector<Mesh::Lod> lods;
+    int previousCount = simplifier.getIndexCount();
+    for (int i = 0; i < count; i++) {
+        int target = (int)(previousCount * reduction) / 3 * 3;
+        simplifier.collapseUntil(target);
+        if (simplifier.getIndexCount() == 0 || simplifier.getIndexCount() > previousCount * LOD_STALL_RATIO) { break; }
+
+        Mesh::Lod lod;
+        lod.indices = simplifier.getIndices();
+        lod.error = simplifier.getError();
+        optimizeVertexCache(lod.indices, vertices.getElementCount());
+        previousCount = (int)lod.indices.size();
+        lods.push_back(std::move(lod));
+    }
+    return lods;
+}
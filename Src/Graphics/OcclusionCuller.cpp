@@ -0,0 +1,276 @@
+#include <PGE/Graphics/OcclusionCuller.h>
+
+#include <algorithm>
+
+#include <PGE/Exception/Exception.h>
+
+#include "../Math/SIMD.h"
+#include "../Threading/Parallel.h"
+
+using namespace PGE;
+
+// Below these, spinning up threads costs more than it saves.
+static constexpr int PARALLEL_RANGE_TILES = 8;
+static constexpr int PARALLEL_RANGE_WORDS = 16;
+
+// Triangles smaller than this, in square pixels, can't cover a pixel center reliably.
+static constexpr float MIN_TRIANGLE_AREA = 1e-6f;
+
+// The pixel containing a coordinate, clamped to one past the screen on either side first,
+// as vertices close to the camera plane project arbitrarily far.
+static int toPixel(float coord, int size) {
+    return Math::floor(std::clamp(coord, -1.f, (float)size));
+}
+
+OcclusionCuller::OcclusionCuller(int w, int h) {
+    PGE_ASSERT(w > 0 && h > 0 && w % TILE_SIZE == 0 && h % TILE_SIZE == 0,
+        "Occlusion buffer size must be a multiple of " + String::from(TILE_SIZE) + " (" + String::from(w) + "x" + String::from(h) + ")");
+    width = w;
+    height = h;
+    tilesX = w / TILE_SIZE;
+    tilesY = h / TILE_SIZE;
+    depth.resize((size_t)width * height, 1.f);
+    tileMaxDepth.resize((size_t)tilesX * tilesY, 1.f);
+    tileBins.resize((size_t)tilesX * tilesY);
+}
+
+void OcclusionCuller::beginFrame(const Matrix4x4f& viewProj) {
+    viewProjection = viewProj;
+    std::fill(depth.begin(), depth.end(), 1.f);
+    std::fill(tileMaxDepth.begin(), tileMaxDepth.end(), 1.f);
+    triangles.clear();
+}
+
+void OcclusionCuller::addOccluder(const std::vector<Vector3f>& positions, const std::vector<u32>& indices, const Matrix4x4f& world) {
+    PGE_ASSERT(indices.size() % 3 == 0, "Index count isn't a multiple of 3 (" + String::from((int)indices.size()) + ")");
+
+    Matrix4x4f transform = viewProjection * world;
+    std::vector<Vector3f> screen(positions.size());
+    std::vector<bool> inFront(positions.size());
+    for (int i = 0; i < (int)positions.size(); i++) {
+        Vector4f clip = transform.transform(Vector4f(positions[i], 1.f));
+        inFront[i] = clip.z >= 0.f && clip.w > 0.f;
+        if (inFront[i]) {
+            screen[i] = Vector3f(
+                (clip.x / clip.w * 0.5f + 0.5f) * width,
+                (clip.y / clip.w * 0.5f + 0.5f) * height,
+                clip.z / clip.w);
+        }
+    }
+
+    for (int i = 0; i < (int)indices.size(); i += 3) {
+        u32 inds[3] = { indices[i], indices[i + 1], indices[i + 2] };
+        for (u32 index : inds) {
+            PGE_ASSERT(index < positions.size(), "Index out of range (" + String::from(index) + ")");
+        }
+        if (!inFront[inds[0]] || !inFront[inds[1]] || !inFront[inds[2]]) { continue; }
+
+        Vector3f v[3] = { screen[inds[0]], screen[inds[1]], screen[inds[2]] };
+        float area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[2].x - v[0].x) * (v[1].y - v[0].y);
+        if (std::abs(area) < MIN_TRIANGLE_AREA) { continue; }
+        // Both windings occlude, counter-clockwise ones keep the edge functions positive inside.
+        if (area < 0.f) {
+            std::swap(v[1], v[2]);
+            area = -area;
+        }
+
+        Triangle tri;
+        tri.minX = std::max(0, toPixel(std::min({ v[0].x, v[1].x, v[2].x }), width));
+        tri.minY = std::max(0, toPixel(std::min({ v[0].y, v[1].y, v[2].y }), height));
+        tri.maxX = std::min(width - 1, toPixel(std::max({ v[0].x, v[1].x, v[2].x }), width));
+        tri.maxY = std::min(height - 1, toPixel(std::max({ v[0].y, v[1].y, v[2].y }), height));
+        if (tri.minX > tri.maxX || tri.minY > tri.maxY) { continue; }
+
+        // Edge k is opposite to vertex k, and divided by the area it's that vertex's barycentric coordinate.
+        tri.depthA = 0.f; tri.depthB = 0.f; tri.depthC = 0.f;
+        for (int k = 0; k < 3; k++) {
+            const Vector3f& a = v[(k + 1) % 3];
+            const Vector3f& b = v[(k + 2) % 3];
+            tri.edgeA[k] = a.y - b.y;
+            tri.edgeB[k] = b.x - a.x;
+            tri.edgeC[k] = -(tri.edgeA[k] * a.x + tri.edgeB[k] * a.y);
+            tri.depthA += tri.edgeA[k] * v[k].z / area;
+            tri.depthB += tri.edgeB[k] * v[k].z / area;
+            tri.depthC += tri.edgeC[k] * v[k].z / area;
+        }
+        triangles.push_back(tri);
+    }
+}
+
+void OcclusionCuller::rasterize(bool allowParallel) {
+    for (std::vector<int>& bin : tileBins) {
+        bin.clear();
+    }
+    for (int i = 0; i < (int)triangles.size(); i++) {
+        const Triangle& tri = triangles[i];
+        for (int ty = tri.minY / TILE_SIZE; ty <= tri.maxY / TILE_SIZE; ty++) {
+            for (int tx = tri.minX / TILE_SIZE; tx <= tri.maxX / TILE_SIZE; tx++) {
+                tileBins[ty * tilesX + tx].push_back(i);
+            }
+        }
+    }
+
+    // Tiles don't share any pixels, so each thread has its own part of the buffer.
+    int tileCount = tilesX * tilesY;
+    Parallel::forRange(tileCount, allowParallel ? PARALLEL_RANGE_TILES : tileCount, [&](int begin, int end) {
+        for (int tile = begin; tile < end; tile++) {
+            rasterizeTile(tile);
+        }
+    });
+}
+
+void OcclusionCuller::rasterizeTile(int tile) {
+    int tileX = (tile % tilesX) * TILE_SIZE;
+    int tileY = (tile / tilesX) * TILE_SIZE;
+
+    const float laneOffsets[4] = { 0.5f, 1.5f, 2.5f, 3.5f };
+    const SIMD::Float4 lanes = SIMD::load(laneOffsets);
+    const SIMD::Float4 zero = SIMD::set(0.f);
+
+    for (int index : tileBins[tile]) {
+        const Triangle& tri = triangles[index];
+        // Aligned down to whole groups of 4 pixels, the edge functions discard the extra ones.
+        int minX = std::max(tri.minX, tileX) & ~3;
+        int maxX = std::min(tri.maxX, tileX + TILE_SIZE - 1);
+        int minY = std::max(tri.minY, tileY);
+        int maxY = std::min(tri.maxY, tileY + TILE_SIZE - 1);
+
+        SIMD::Float4 edgeA[3];
+        for (int k = 0; k < 3; k++) {
+            edgeA[k] = SIMD::set(tri.edgeA[k]);
+        }
+        SIMD::Float4 depthA = SIMD::set(tri.depthA);
+
+        for (int y = minY; y <= maxY; y++) {
+            float centerY = y + 0.5f;
+            SIMD::Float4 rowEdge[3];
+            for (int k = 0; k < 3; k++) {
+                rowEdge[k] = SIMD::set(tri.edgeB[k] * centerY + tri.edgeC[k]);
+            }
+            SIMD::Float4 rowDepth = SIMD::set(tri.depthB * centerY + tri.depthC);
+
+            float* row = depth.data() + (size_t)y * width;
+            for (int x = minX; x <= maxX; x += 4) {
+                SIMD::Float4 centerX = SIMD::add(SIMD::set((float)x), lanes);
+                SIMD::Float4 minEdge = SIMD::min(
+                    SIMD::madd(edgeA[0], centerX, rowEdge[0]),
+                    SIMD::min(SIMD::madd(edgeA[1], centerX, rowEdge[1]), SIMD::madd(edgeA[2], centerX, rowEdge[2])));
+                SIMD::Float4 z = SIMD::madd(depthA, centerX, rowDepth);
+                SIMD::Float4 old = SIMD::load(row + x);
+                SIMD::store(row + x, SIMD::select(SIMD::greater(zero, minEdge), old, SIMD::min(old, z)));
+            }
+        }
+    }
+
+    SIMD::Float4 maxDepth = zero;
+    for (int y = tileY; y < tileY + TILE_SIZE; y++) {
+        const float* row = depth.data() + (size_t)y * width;
+        for (int x = tileX; x < tileX + TILE_SIZE; x += 4) {
+            maxDepth = SIMD::max(maxDepth, SIMD::load(row + x));
+        }
+    }
+    tileMaxDepth[tile] = SIMD::horizontalMax(maxDepth);
+}
+
+bool OcclusionCuller::project(const AABBox& box, int& minX, int& minY, int& maxX, int& maxY, float& minDepth) const {
+    const Vector3f& boxMin = box.getMin();
+    const Vector3f& boxMax = box.getMax();
+    float screenMinX = 0.f, screenMinY = 0.f, screenMaxX = 0.f, screenMaxY = 0.f;
+    for (int i = 0; i < 8; i++) {
+        Vector3f corner(i & 1 ? boxMax.x : boxMin.x, i & 2 ? boxMax.y : boxMin.y, i & 4 ? boxMax.z : boxMin.z);
+        Vector4f clip = viewProjection.transform(Vector4f(corner, 1.f));
+        if (clip.z < 0.f || clip.w <= 0.f) {
+            // Reaches in front of the near plane, may cover the entire screen.
+            minX = 0; minY = 0; maxX = width - 1; maxY = height - 1;
+            minDepth = 0.f;
+            return true;
+        }
+        float x = (clip.x / clip.w * 0.5f + 0.5f) * width;
+        float y = (clip.y / clip.w * 0.5f + 0.5f) * height;
+        float z = clip.z / clip.w;
+        if (i == 0) {
+            screenMinX = x; screenMaxX = x; screenMinY = y; screenMaxY = y; minDepth = z;
+        } else {
+            screenMinX = std::min(screenMinX, x); screenMaxX = std::max(screenMaxX, x);
+            screenMinY = std::min(screenMinY, y); screenMaxY = std::max(screenMaxY, y);
+            minDepth = std::min(minDepth, z);
+        }
+    }
+
+    // Every pixel the box touches, even partially.
+    minX = std::max(0, toPixel(screenMinX, width));
+    minY = std::max(0, toPixel(screenMinY, height));
+    maxX = std::min(width - 1, toPixel(screenMaxX, width));
+    maxY = std::min(height - 1, toPixel(screenMaxY, height));
+    return minX <= maxX && minY <= maxY;
+}
+
+bool OcclusionCuller::isRectVisible(int minX, int minY, int maxX, int maxY, float minDepth) const {
+    SIMD::Float4 boxDepth = SIMD::set(minDepth);
+    for (int ty = minY / TILE_SIZE; ty <= maxY / TILE_SIZE; ty++) {
+        for (int tx = minX / TILE_SIZE; tx <= maxX / TILE_SIZE; tx++) {
+            // Everything in the tile is in front of the box.
+            if (minDepth > tileMaxDepth[ty * tilesX + tx]) { continue; }
+
+            int tileMinX = std::max(minX, tx * TILE_SIZE);
+            int tileMaxX = std::min(maxX, tx * TILE_SIZE + TILE_SIZE - 1);
+            int tileMinY = std::max(minY, ty * TILE_SIZE);
+            int tileMaxY = std::min(maxY, ty * TILE_SIZE + TILE_SIZE - 1);
+            for (int y = tileMinY; y <= tileMaxY; y++) {
+                const float* row = depth.data() + (size_t)y * width;
+                for (int x = tileMinX & ~3; x <= tileMaxX; x += 4) {
+                    int laneMask = 0xf;
+                    if (x < tileMinX) { laneMask &= 0xf << (tileMinX - x); }
+                    if (x + 3 > tileMaxX) { laneMask &= 0xf >> (x + 3 - tileMaxX); }
+                    int occluded = SIMD::mask(SIMD::greater(boxDepth, SIMD::load(row + x)));
+                    if (~occluded & laneMask) { return true; }
+                }
+            }
+        }
+    }
+    return false;
+}
+
+bool OcclusionCuller::isVisible(const AABBox& box) const {
+    int minX, minY, maxX, maxY;
+    float minDepth;
+    return project(box, minX, minY, maxX, maxY, minDepth) && isRectVisible(minX, minY, maxX, maxY, minDepth);
+}
+
+void OcclusionCuller::test(const std::vector<AABBox>& boxes, std::vector<u64>& visible, bool allowParallel) const {
+    int count = (int)boxes.size();
+    int wordCount = (count + 63) / 64;
+    visible.assign(wordCount, 0);
+    if (wordCount == 0) { return; }
+
+    // Threads are split by whole words, so that no two write to the same one.
+    Parallel::forRange(wordCount, allowParallel ? PARALLEL_RANGE_WORDS : wordCount, [&](int begin, int end) {
+        for (int w = begin; w < end; w++) {
+            u64 word = 0;
+            int last = std::min(w * 64 + 64, count);
+            for (int i = w * 64; i < last; i++) {
+                if (isVisible(boxes[i])) {
+                    word |= (u64)1 << (i - w * 64);
+                }
+            }
+            visible[w] = word;
+        }
+    });
+}
+
+int OcclusionCuller::getWidth() const {
+    return width;
+}
+
+int OcclusionCuller::getHeight() const {
+    return height;
+}
+
+float OcclusionCuller::getDepth(int x, int y) const {
+    PGE_ASSERT(x >= 0 && y >= 0 && x < width && y < height, "Pixel out of bounds (" + String::from(x) + ", " + String::from(y) + ")");
+    return depth[(size_t)y * width + x];
+}
+
+int OcclusionCuller::getTriangleCount() const {
+    return (int)triangles.size();
+}
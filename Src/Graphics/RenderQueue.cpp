@@ -0,0 +1,136 @@
+#include <PGE/Graphics/RenderQueue.h>
+
+#include <PGE/Graphics/Mesh.h>
+#include <PGE/Graphics/Material.h>
+#include <PGE/Exception/Exception.h>
+
+#include <algorithm>
+
+using namespace PGE;
+
+static constexpr int PASS_BITS = 4;
+static constexpr int TRANSPARENT_BITS = 1;
+static constexpr int SHADER_BITS = 10;
+static constexpr int TEXTURE_BITS = 12;
+static constexpr int MATERIAL_BITS = 12;
+static constexpr int DEPTH_BITS = 24;
+static_assert(PASS_BITS + TRANSPARENT_BITS + SHADER_BITS + TEXTURE_BITS + MATERIAL_BITS + DEPTH_BITS <= 64);
+static_assert(RenderQueue::MAX_PASS < (1 << PASS_BITS));
+
+static constexpr u64 maxValue(int bits) {
+    return ((u64)1 << bits) - 1;
+}
+
+// The bit patterns of non-negative floats sort like the floats themselves,
+// so the most significant bits are an order preserving quantization without needing to know the depth range.
+static u64 quantizeDepth(float depth) {
+    if (!(depth > 0.f)) { return 0; }
+    u32 bits;
+    memcpy(&bits, &depth, sizeof(u32));
+    return bits >> (32 - DEPTH_BITS);
+}
+
+u64 RenderQueue::getId(std::unordered_map<const void*, u64>& ids, const void* object, u64 max) {
+    auto [it, inserted] = ids.emplace(object, (u64)ids.size());
+    // Objects beyond the limit share the last id, which only costs some sorting precision.
+    return std::min(it->second, max);
+}
+
+void RenderQueue::submit(Mesh& mesh, float depth, int pass, const std::function<void()>& prepare) {
+    PGE_ASSERT(pass >= 0 && pass <= MAX_PASS, "Render pass out of range (" + String::from(pass) + ")");
+    if (!mesh.primitiveType.has_value() || mesh.material == nullptr) { return; }
+
+    const Material& material = *mesh.material;
+    u64 shader = getId(shaderIds, &material.getShader(), maxValue(SHADER_BITS));
+    u64 texture = getId(textureIds, material.getTextureCount() > 0 ? &material.getTexture(0) : nullptr, maxValue(TEXTURE_BITS));
+    u64 materialId = getId(materialIds, &material, maxValue(MATERIAL_BITS));
+    u64 depthBits = quantizeDepth(depth);
+
+    u64 key = (u64)pass;
+    if (material.isOpaque()) {
+        key = (key << TRANSPARENT_BITS) | 0;
+        key = (key << SHADER_BITS) | shader;
+        key = (key << TEXTURE_BITS) | texture;
+        key = (key << MATERIAL_BITS) | materialId;
+        key = (key << DEPTH_BITS) | depthBits;
+    } else {
+        key = (key << TRANSPARENT_BITS) | 1;
+        key = (key << DEPTH_BITS) | (maxValue(DEPTH_BITS) - depthBits);
+        key = (key << SHADER_BITS) | shader;
+        key = (key << TEXTURE_BITS) | texture;
+        key = (key << MATERIAL_BITS) | materialId;
+    }
+
+    items.push_back(Item{ &mesh, prepare });
+    keys.push_back(key);
+}
+
+void RenderQueue::sort() {
+    int count = (int)keys.size();
+    order.resize(count);
+    sortedOrder.resize(count);
+    sortedKeys.resize(count);
+    for (int i = 0; i < count; i++) {
+        order[i] = i;
+    }
+
+    // LSD radix sort, one byte per pass, stable.
+    for (int shift = 0; shift < 64; shift += 8) {
+        int histogram[256] = { };
+        for (int i = 0; i < count; i++) {
+            histogram[(keys[i] >> shift) & 0xFF]++;
+        }
+        // Every key has the same byte here, e.g. the unused upper bits or a single pass.
+        if (histogram[(keys[0] >> shift) & 0xFF] == count) { continue; }
+
+        int offset = 0;
+        for (int i = 0; i < 256; i++) {
+            int bucketSize = histogram[i];
+            histogram[i] = offset;
+            offset += bucketSize;
+        }
+        for (int i = 0; i < count; i++) {
+            int dst = histogram[(keys[i] >> shift) & 0xFF]++;
+            sortedKeys[dst] = keys[i];
+            sortedOrder[dst] = order[i];
+        }
+        std::swap(keys, sortedKeys);
+        std::swap(order, sortedOrder);
+    }
+}
+
+void RenderQueue::flush() {
+    stats = Stats();
+    if (items.empty()) { return; }
+
+    sort();
+
+    Mesh::RenderState state;
+    Mesh* lastMesh = nullptr;
+    for (int index : order) {
+        Item& item = items[index];
+        if (item.prepare) { item.prepare(); }
+        item.mesh->render(state);
+        lastMesh = item.mesh;
+    }
+    lastMesh->finishRendering(state);
+    stats = state.stats;
+
+    clear();
+}
+
+void RenderQueue::clear() {
+    items.clear();
+    keys.clear();
+    shaderIds.clear();
+    textureIds.clear();
+    materialIds.clear();
+}
+
+int RenderQueue::getSize() const {
+    return (int)items.size();
+}
+
+const RenderQueue::Stats& RenderQueue::getStats() const {
+    return stats;
+}
@@ -3,7 +3,8 @@
 using namespace PGE;
 
 ShaderDX11::ShaderDX11(const Graphics& gfx,const FilePath& path) : Shader(path), graphics((GraphicsDX11&)gfx) {
-    BinaryReader reader(path + "reflection.dxri");
+    reflectionInfo = (path + "reflection.dxri").readBytes();
+    BinaryReader reader(reflectionInfo.data(), reflectionInfo.size());
 
     readConstantBuffers(reader, vertexConstantBuffers);
 
@@ -11,9 +12,8 @@ ShaderDX11::ShaderDX11(const Graphics& gfx,const FilePath& path) : Shader(path),
     u32 propertyCount = reader.read<u32>();
     vertexInputElems.reserve(propertyCount);
 
-    // We have to keep the names in memory.
-    std::vector<String> semanticNames(propertyCount);
-    std::vector<D3D11_INPUT_ELEMENT_DESC> dxVertexInputElemDesc(propertyCount);
+    semanticNames.resize(propertyCount);
+    dxVertexInputElemDesc.resize(propertyCount);
     for (int i = 0; i < (int)propertyCount; i++) {
         String name = reader.read<String>();
         semanticNames[i] = reader.read<String>();
@@ -57,6 +57,42 @@ ShaderDX11::ShaderDX11(const Graphics& gfx,const FilePath& path) : Shader(path),
     vertexLayout = StructuredData::ElemLayout(vertexInputElems);
 }
 
+bool ShaderDX11::reload() {
+    ID3D11Device* dxDevice = graphics.getDxDevice();
+
+    D3D11VertexShader::View newVertexShader;
+    D3D11PixelShader::View newFragmentShader;
+    D3D11InputLayout::View newVertexInputLayout;
+    try {
+        PGE_ASSERT((filepath + "reflection.dxri").readBytes() == reflectionInfo,
+            "Shader interface changed, cannot reload (filepath: " + filepath.str() + ")");
+
+        std::vector<byte> vertexShaderBytecode = (filepath + "vertex.dxbc").readBytes();
+        PGE_ASSERT(vertexShaderBytecode.size() > 0, "Vertex shader is empty (filename: " + filepath.str() + ")");
+
+        std::vector<byte> fragmentShaderBytecode = (filepath + "fragment.dxbc").readBytes();
+        PGE_ASSERT(fragmentShaderBytecode.size() > 0, "Fragment shader is empty (filename: " + filepath.str() + ")");
+
+        newVertexShader = resourceManager.addNewResource<D3D11VertexShader>(dxDevice, vertexShaderBytecode);
+        newFragmentShader = resourceManager.addNewResource<D3D11PixelShader>(dxDevice, fragmentShaderBytecode);
+        newVertexInputLayout = resourceManager.addNewResource<D3D11InputLayout>(dxDevice, dxVertexInputElemDesc, vertexShaderBytecode);
+    } catch (const Exception&) {
+        // Keep using the old shaders.
+        resourceManager.deleteResource(newVertexInputLayout);
+        resourceManager.deleteResource(newFragmentShader);
+        resourceManager.deleteResource(newVertexShader);
+        return false;
+    }
+
+    resourceManager.deleteResource(dxVertexInputLayout);
+    resourceManager.deleteResource(dxFragmentShader);
+    resourceManager.deleteResource(dxVertexShader);
+    dxVertexShader = newVertexShader;
+    dxFragmentShader = newFragmentShader;
+    dxVertexInputLayout = newVertexInputLayout;
+    return true;
+}
+
 void ShaderDX11::readConstantBuffers(BinaryReader& reader, std::vector<CBufferInfo>& constantBuffers) {
     u32 cBufferCount = reader.read<u32>();
 
@@ -115,13 +151,13 @@ Shader::Constant& ShaderDX11::getFragmentShaderConstant(const String& name) {
 void ShaderDX11::useShader() {
     ID3D11DeviceContext* dxContext = graphics.getDxContext();
 
+    updateConstantBuffers();
+
     for (int i = 0; i < (int)vertexConstantBuffers.size(); i++) {
-        vertexConstantBuffers[i].update();
         dxContext->VSSetConstantBuffers(i,1,&vertexConstantBuffers[i].getDxCBuffer());
     }
 
     for (int i = 0; i < (int)fragmentConstantBuffers.size(); i++) {
-        fragmentConstantBuffers[i].update();
         dxContext->PSSetConstantBuffers(i,1,&fragmentConstantBuffers[i].getDxCBuffer());
     }
     
@@ -129,6 +165,16 @@ void ShaderDX11::useShader() {
     dxContext->PSSetShader(dxFragmentShader,NULL,0);
 }
 
+void ShaderDX11::updateConstantBuffers() {
+    for (CBufferInfo& cBuffer : vertexConstantBuffers) {
+        cBuffer.update();
+    }
+
+    for (CBufferInfo& cBuffer : fragmentConstantBuffers) {
+        cBuffer.update();
+    }
+}
+
 void ShaderDX11::useVertexInputLayout() {
     ID3D11DeviceContext* dxContext = graphics.getDxContext();
     dxContext->IASetInputLayout(dxVertexInputLayout);
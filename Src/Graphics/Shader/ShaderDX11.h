@@ -23,15 +23,27 @@ class ShaderDX11 : public Shader {
         Constant& getVertexShaderConstant(const String& name) override;
         Constant& getFragmentShaderConstant(const String& name) override;
 
+        /// Binds the shaders and their constant buffers, also updates the constant buffers.
         void useShader();
+        /// Uploads modified constants, for when the shader is already in use.
+        void updateConstantBuffers();
         void useVertexInputLayout();
         void useSamplers();
 
+        /// Reloads the bytecode from disk.
+        /// Fails if the reflection info has changed, in which case the old shaders stay in use.
+        bool reload();
+
     private:
         GraphicsDX11& graphics;
 
+        // We have to keep the names in memory.
+        std::vector<String> semanticNames;
+        std::vector<D3D11_INPUT_ELEMENT_DESC> dxVertexInputElemDesc;
         D3D11InputLayout::View dxVertexInputLayout;
 
+        std::vector<byte> reflectionInfo;
+
         class CBufferInfo;
         class ConstantDX11 : public Constant {
             public:
@@ -1,12 +1,48 @@
 #include "../GraphicsOGL3.h"
 
+#include <algorithm>
+
 using namespace PGE;
 
 static const String RT_NAME = "_PGE_INTERNAL_YFLIP";
 
+u64 ShaderOGL3::nextRevision = 0;
+
+static const String VERTEX_INPUT_PREFIX = "vertexInput_";
+static const String INSTANCE_INPUT_PREFIX = "instanceInput_";
+
+// Strips the input prefix, attributes without one are per-vertex.
+static const String sanitizeAttributeName(const String& name, bool& perInstance) {
+    perInstance = name.findFirst(INSTANCE_INPUT_PREFIX) == name.begin();
+    if (perInstance) {
+        return name.substr(INSTANCE_INPUT_PREFIX.length());
+    }
+    if (name.findFirst(VERTEX_INPUT_PREFIX) == name.begin()) {
+        return name.substr(VERTEX_INPUT_PREFIX.length());
+    }
+    return name;
+}
+
+// Splits a declaration like "bones[64]" into its name and array size.
+static void parseArrayDeclaration(const String& declaration, String& name, int& arraySize) {
+    const String::Iterator bracketOpen = declaration.findFirst("[");
+    if (bracketOpen == declaration.end()) {
+        name = declaration;
+        arraySize = 1;
+        return;
+    }
+
+    name = declaration.substr(declaration.begin(), bracketOpen);
+    bool success;
+    arraySize = declaration.substr(bracketOpen + 1, declaration.findFirst("]", bracketOpen)).to<int>(success);
+    PGE_ASSERT(success && arraySize > 0, "Unsupported array size (declaration: " + declaration + ")");
+}
+
 ShaderOGL3::ShaderOGL3(Graphics& gfx, const FilePath& path) : Shader(path), resourceManager(gfx), graphics((GraphicsOGL3&)gfx) {
     graphics.takeGlContext();
 
+    revision = nextRevision++;
+
     String vertexSource = (path + "vertex.glsl").readText();
     PGE_ASSERT(!vertexSource.isEmpty(), "Failed to find vertex.glsl (filepath: " + path.str() + ")");
     glVertexShader = resourceManager.addNewResource<GLShader>(GL_VERTEX_SHADER, vertexSource);
@@ -15,7 +51,7 @@ ShaderOGL3::ShaderOGL3(Graphics& gfx, const FilePath& path) : Shader(path), reso
     PGE_ASSERT(!fragmentSource.isEmpty(), "Failed to find fragment shader (filepath: " + path.str() + ")");
     glFragmentShader = resourceManager.addNewResource<GLShader>(GL_FRAGMENT_SHADER, fragmentSource);
 
-    glShaderProgram = resourceManager.addNewResource<GLProgram>(std::vector{ glVertexShader.get(), glFragmentShader.get() });
+    glShaderProgram = resourceManager.addNewResource<GLProgram>(graphics.getGlState(), std::vector{ glVertexShader.get(), glFragmentShader.get() });
 
     // TODO: Revisit the multiple passes needed here.
     extractVertexUniforms(vertexSource);
@@ -26,6 +62,12 @@ ShaderOGL3::ShaderOGL3(Graphics& gfx, const FilePath& path) : Shader(path), reso
 
     extractFragmentOutputs(fragmentSource);
 
+    setUpUniformBlocks(vertexSource, vertexShaderConstants);
+    setUpUniformBlocks(fragmentSource, fragmentShaderConstants);
+    buildUniformUploads();
+
+    interfaceSignature = getInterfaceSignature(vertexSource, fragmentSource);
+
     Shader::Constant& rtConstant = getVertexShaderConstant(RT_NAME);
     rtConstant.setValue(1.f);
     graphics.addRenderTargetFlag(rtConstant);
@@ -35,50 +77,151 @@ ShaderOGL3::~ShaderOGL3() {
     graphics.removeRenderTargetFlag(getVertexShaderConstant(RT_NAME));
 }
 
+bool ShaderOGL3::reload() {
+    graphics.takeGlContext();
+
+    String vertexSource;
+    String fragmentSource;
+    GLShader::View newVertexShader;
+    GLShader::View newFragmentShader;
+    GLProgram::View newShaderProgram;
+    try {
+        vertexSource = (filepath + "vertex.glsl").readText();
+        fragmentSource = (filepath + "fragment.glsl").readText();
+        PGE_ASSERT(getInterfaceSignature(vertexSource, fragmentSource).equals(interfaceSignature),
+            "Shader interface changed, cannot reload (filepath: " + filepath.str() + ")");
+
+        newVertexShader = resourceManager.addNewResource<GLShader>(GL_VERTEX_SHADER, vertexSource);
+        newFragmentShader = resourceManager.addNewResource<GLShader>(GL_FRAGMENT_SHADER, fragmentSource);
+        newShaderProgram = resourceManager.addNewResource<GLProgram>(graphics.getGlState(), std::vector{ newVertexShader.get(), newFragmentShader.get() });
+    } catch (const Exception&) {
+        // Keep using the old program.
+        resourceManager.deleteResource(newShaderProgram);
+        resourceManager.deleteResource(newFragmentShader);
+        resourceManager.deleteResource(newVertexShader);
+        return false;
+    }
+
+    resourceManager.deleteResource(glShaderProgram);
+    resourceManager.deleteResource(glFragmentShader);
+    resourceManager.deleteResource(glVertexShader);
+    glVertexShader = newVertexShader;
+    glFragmentShader = newFragmentShader;
+    glShaderProgram = newShaderProgram;
+
+    // The interface is unchanged, so only the locations need updating.
+    std::vector<ParsedShaderVar> parsedVars;
+    String name; int arraySize;
+    extractShaderVars(vertexSource, "uniform", parsedVars);
+    for (const ParsedShaderVar& var : parsedVars) {
+        parseArrayDeclaration(var.name, name, arraySize);
+        vertexShaderConstants.find(name)->second.setLocation(glGetUniformLocation(glShaderProgram, name.cstr()));
+    }
+
+    parsedVars.clear();
+    extractShaderVars(fragmentSource, "uniform", parsedVars);
+    for (const ParsedShaderVar& var : parsedVars) {
+        parseArrayDeclaration(var.name, name, arraySize);
+        auto& constants = var.type.equals("sampler2D") ? samplerConstants : fragmentShaderConstants;
+        constants.find(name)->second.setLocation(glGetUniformLocation(glShaderProgram, name.cstr()));
+    }
+
+    parsedVars.clear();
+    extractShaderVars(vertexSource, "in", parsedVars);
+    for (const ParsedShaderVar& var : parsedVars) {
+        bool perInstance;
+        String sanitizedAttrName = sanitizeAttributeName(var.name, perInstance);
+        auto& locations = perInstance ? glInstanceAttribLocations : glVertexAttribLocations;
+        locations.find(sanitizedAttrName)->second.location = glGetAttribLocation(glShaderProgram, var.name.cstr());
+    }
+
+    extractFragmentOutputs(fragmentSource);
+
+    // Vertex arrays set up for the old program may have recorded stale locations.
+    revision = nextRevision++;
+
+    bindUniformBlocks();
+    // Uniform values are program state, the new program has none of them.
+    for (ConstantOGL3* constant : uniformUploads) {
+        constant->markDirty();
+    }
+
+    return true;
+}
+
+const String ShaderOGL3::getInterfaceSignature(const String& vertexSource, const String& fragmentSource) {
+    String signature;
+    auto appendVars = [&](const String& src, const String& varKind) {
+        std::vector<ParsedShaderVar> vars;
+        extractShaderVars(src, varKind, vars);
+        for (const ParsedShaderVar& var : vars) {
+            signature += varKind + " " + var.type + " " + var.name + ";";
+        }
+    };
+    appendVars(vertexSource, "uniform");
+    appendVars(vertexSource, "in");
+    appendVars(fragmentSource, "uniform");
+    appendVars(fragmentSource, "out");
+    for (const String& src : { vertexSource, fragmentSource }) {
+        std::vector<ParsedUniformBlock> blocks;
+        extractUniformBlocks(src, blocks);
+        for (const ParsedUniformBlock& block : blocks) {
+            signature += "block " + block.name + "{";
+            for (const ParsedShaderVar& member : block.members) {
+                signature += member.type + " " + member.name + ";";
+            }
+            signature += "}";
+        }
+    }
+    return signature;
+}
+
 void ShaderOGL3::extractVertexUniforms(const String& vertexSource) {
     std::vector<ParsedShaderVar> vertexUniforms;
     extractShaderVars(vertexSource, "uniform", vertexUniforms);
+    std::vector<String> names(vertexUniforms.size());
+    std::vector<int> arrSizes(vertexUniforms.size());
     std::vector<StructuredData::ElemLayout::Entry> layoutEntries;
     for (int i = 0; i < (int)vertexUniforms.size(); i++) {
-        int arrSize = 1; //TODO: add array support
+        parseArrayDeclaration(vertexUniforms[i].name, names[i], arrSizes[i]);
         GLenum glType = parsedTypeToGlType(vertexUniforms[i].type);
-        int byteSize = glSizeToByteSize(glType, arrSize);
-        layoutEntries.emplace_back(vertexUniforms[i].name, byteSize);
+        layoutEntries.emplace_back(names[i], glSizeToByteSize(glType, 1), arrSizes[i]);
+    }
+    // Laid out like a std140 uniform block, so the data can be uploaded to one as is.
+    vertexUniformData = StructuredData(StructuredData::ElemLayout(layoutEntries, StructuredData::ElemLayout::Packing::STD140), 1);
+
+    for (int i = 0; i < (int)vertexUniforms.size(); i++) {
         vertexShaderConstants.emplace(
-            vertexUniforms[i].name,
+            names[i],
             ConstantOGL3(
                 graphics,
-                glGetUniformLocation(glShaderProgram, vertexUniforms[i].name.cstr()),
-                glType,
-                arrSize,
+                glGetUniformLocation(glShaderProgram, names[i].cstr()),
+                parsedTypeToGlType(vertexUniforms[i].type),
+                arrSizes[i],
                 vertexUniformData,
-                String::Key(vertexUniforms[i].name)
+                String::Key(names[i])
             )
         );
     }
-    vertexUniformData = StructuredData(StructuredData::ElemLayout(layoutEntries), 1);
 }
 
 void ShaderOGL3::extractVertexAttributes(const String& vertexSource) {
-    const String vertexInputPrefix = "vertexInput_";
-
     std::vector<ParsedShaderVar> parsedAttribs;
     extractShaderVars(vertexSource, "in", parsedAttribs);
 
     std::vector<StructuredData::ElemLayout::Entry> layoutEntries;
+    std::vector<StructuredData::ElemLayout::Entry> instanceLayoutEntries;
     for (int i = 0; i < (int)parsedAttribs.size(); i++) {
         String attrName = parsedAttribs[i].name;
-        String sanitizedAttrName = attrName;
-        if (sanitizedAttrName.findFirst(vertexInputPrefix) == sanitizedAttrName.begin()) {
-            sanitizedAttrName = sanitizedAttrName.substr(vertexInputPrefix.length());
-        }
+        bool perInstance;
+        String sanitizedAttrName = sanitizeAttributeName(attrName, perInstance);
 
         GLenum attrType = parsedTypeToGlType(parsedAttribs[i].type);
         GLenum attrElemType; int attrElemCount;
         decomposeGlType(attrType, attrElemType, attrElemCount);
 
-        layoutEntries.emplace_back(sanitizedAttrName, glSizeToByteSize(attrElemType, attrElemCount));
-        glVertexAttribLocations.emplace(
+        (perInstance ? instanceLayoutEntries : layoutEntries).emplace_back(sanitizedAttrName, glSizeToByteSize(attrElemType, attrElemCount));
+        (perInstance ? glInstanceAttribLocations : glVertexAttribLocations).emplace(
             String::Key(sanitizedAttrName),
             GlAttribLocation(
                 glGetAttribLocation(glShaderProgram, attrName.cstr()),
@@ -89,39 +232,119 @@ void ShaderOGL3::extractVertexAttributes(const String& vertexSource) {
     }
 
     vertexLayout = StructuredData::ElemLayout(layoutEntries);
+    instanceLayout = StructuredData::ElemLayout(instanceLayoutEntries);
 }
 
 void ShaderOGL3::extractFragmentUniforms(const String& fragmentSource) {
     std::vector<ParsedShaderVar> fragmentUniforms;
     extractShaderVars(fragmentSource, "uniform", fragmentUniforms);
+    std::vector<String> names(fragmentUniforms.size());
+    std::vector<int> arrSizes(fragmentUniforms.size());
     std::vector<StructuredData::ElemLayout::Entry> layoutEntries;
     for (int i = 0; i < (int)fragmentUniforms.size(); i++) {
-        int arrSize = 1; //TODO: add array support
+        parseArrayDeclaration(fragmentUniforms[i].name, names[i], arrSizes[i]);
         GLenum glType = parsedTypeToGlType(fragmentUniforms[i].type);
-        int byteSize = glSizeToByteSize(glType, arrSize);
-        layoutEntries.emplace_back(fragmentUniforms[i].name, byteSize);
+        layoutEntries.emplace_back(names[i], glSizeToByteSize(glType, 1), arrSizes[i]);
     }
-    fragmentUniformData = StructuredData(StructuredData::ElemLayout(layoutEntries), 1);
+    fragmentUniformData = StructuredData(StructuredData::ElemLayout(layoutEntries, StructuredData::ElemLayout::Packing::STD140), 1);
 
     for (int i = 0; i < (int)fragmentUniforms.size(); i++) {
-        int arrSize = 1; //TODO: add array support
         ConstantOGL3 constant(
             graphics,
-            glGetUniformLocation(glShaderProgram, fragmentUniforms[i].name.cstr()),
+            glGetUniformLocation(glShaderProgram, names[i].cstr()),
             parsedTypeToGlType(fragmentUniforms[i].type),
-            arrSize,
+            arrSizes[i],
             fragmentUniformData,
-            String::Key(fragmentUniforms[i].name)
+            String::Key(names[i])
         );
         if (fragmentUniforms[i].type.equals("sampler2D")) {
             constant.setValue((u32)samplerConstants.size());
-            samplerConstants.emplace(fragmentUniforms[i].name, constant);
+            samplerConstants.emplace(names[i], constant);
         } else {
-            fragmentShaderConstants.emplace(fragmentUniforms[i].name, constant);
+            fragmentShaderConstants.emplace(names[i], constant);
+        }
+    }
+}
+
+void ShaderOGL3::extractUniformBlocks(const String& src, std::vector<ParsedUniformBlock>& blockList) {
+    // Only std140 blocks are supported, as that's the layout the data is packed with.
+    const String blockStart = "layout(std140) uniform ";
+    std::vector<String> lines = src.replace("\r", "").split("\n", true);
+    for (int i = 0; i < (int)lines.size(); i++) {
+        String line = lines[i].trim();
+        if (line.findFirst(blockStart) != line.begin()) { continue; }
+
+        ParsedUniformBlock block;
+        block.name = line.substr(blockStart.length()).replace("{", "").trim();
+        for (i++; i < (int)lines.size(); i++) {
+            String member = lines[i].trim();
+            if (member.findFirst("}") == member.begin()) { break; }
+            if (member.isEmpty()) { continue; }
+
+            std::vector<String> tokens = member.replace(";", "").split(" ", true);
+            PGE_ASSERT(tokens.size() == 2, "Unsupported uniform block member (filepath: " + filepath.str() + "; member: " + member + ")");
+            block.members.push_back({ tokens[1], tokens[0] });
+        }
+        blockList.emplace_back(block);
+    }
+}
+
+void ShaderOGL3::setUpUniformBlocks(const String& src, std::unordered_map<String::Key, ConstantOGL3>& constants) {
+    std::vector<ParsedUniformBlock> blocks;
+    extractUniformBlocks(src, blocks);
+    for (const ParsedUniformBlock& parsedBlock : blocks) {
+        std::vector<String> names(parsedBlock.members.size());
+        std::vector<int> arrSizes(parsedBlock.members.size());
+        std::vector<StructuredData::ElemLayout::Entry> layoutEntries;
+        for (int i = 0; i < (int)parsedBlock.members.size(); i++) {
+            parseArrayDeclaration(parsedBlock.members[i].name, names[i], arrSizes[i]);
+            layoutEntries.emplace_back(names[i], glSizeToByteSize(parsedTypeToGlType(parsedBlock.members[i].type), 1), arrSizes[i]);
+        }
+
+        UniformBlockOGL3& block = graphics.getUniformBlock(parsedBlock.name,
+            StructuredData::ElemLayout(layoutEntries, StructuredData::ElemLayout::Packing::STD140));
+        if (std::find(uniformBlocks.begin(), uniformBlocks.end(), &block) == uniformBlocks.end()) {
+            uniformBlocks.push_back(&block);
+            uniformBlockNames.push_back(parsedBlock.name);
+        }
+
+        for (int i = 0; i < (int)parsedBlock.members.size(); i++) {
+            constants.emplace(
+                names[i],
+                ConstantOGL3(
+                    graphics,
+                    -1,
+                    parsedTypeToGlType(parsedBlock.members[i].type),
+                    arrSizes[i],
+                    block.getData(),
+                    String::Key(names[i]),
+                    &block
+                )
+            );
         }
     }
+    bindUniformBlocks();
+}
 
-    for (int i = 0; i < (int)samplerConstants.size(); i++) {
+void ShaderOGL3::bindUniformBlocks() {
+    graphics.takeGlContext();
+    for (int i = 0; i < (int)uniformBlocks.size(); i++) {
+        GLuint blockIndex = glGetUniformBlockIndex(glShaderProgram, uniformBlockNames[i].cstr());
+        // Unused blocks are optimized out.
+        if (blockIndex != GL_INVALID_INDEX) {
+            glUniformBlockBinding(glShaderProgram, blockIndex, uniformBlocks[i]->getBindingIndex());
+        }
+    }
+}
+
+void ShaderOGL3::buildUniformUploads() {
+    uniformUploads.clear();
+    for (auto* constants : { &vertexShaderConstants, &fragmentShaderConstants, &samplerConstants }) {
+        for (auto& [_, constant] : *constants) {
+            if (!constant.isInBlock()) {
+                uniformUploads.push_back(&constant);
+            }
+        }
     }
 }
 
@@ -254,42 +477,63 @@ void ShaderOGL3::decomposeGlType(GLenum compositeType, GLenum& elemType, int& el
     }
 }
 
-void ShaderOGL3::useShader() {
-    GLuint glError = GL_NO_ERROR;
+void ShaderOGL3::useProgram() {
+    graphics.takeGlContext();
+    graphics.getGlState().useProgram(glShaderProgram);
+}
 
+void ShaderOGL3::uploadConstants() {
     graphics.takeGlContext();
 
-    glUseProgram(glShaderProgram);
+    for (ConstantOGL3* constant : uniformUploads) {
+        constant->setUniform();
+    }
+
+    for (UniformBlockOGL3* block : uniformBlocks) {
+        block->upload();
+    }
+
+    GLenum glError = glGetError();
+    PGE_ASSERT(glError == GL_NO_ERROR, "Failed to set uniform values (filepath: " + filepath.str() + "; GLERROR: " + String::from(glError) + ")");
+}
+
+void ShaderOGL3::setUpVertexArray(GLuint vertexBuffer, GLuint instanceBuffer) {
+    graphics.takeGlContext();
 
+    GLStateOGL3& glState = graphics.getGlState();
     byte* ptr = nullptr;
+    glState.bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
     for (const auto& [key, glAttribLocation] : glVertexAttribLocations) {
         const StructuredData::ElemLayout::LocationAndSize& locationAndSizeInBuffer = vertexLayout.getLocationAndSize(key);
 
         glEnableVertexAttribArray(glAttribLocation.location);
         glVertexAttribPointer(glAttribLocation.location, glAttribLocation.elementCount, glAttribLocation.elementType, GL_FALSE, vertexLayout.getElementSize(), ptr + locationAndSizeInBuffer.location);
-        glError = glGetError();
-        PGE_ASSERT(glError == GL_NO_ERROR, "Failed to set vertex attribute (filepath: " + filepath.str() + "; attrib: " + String::hexFromInt(key.hash) + ")");
     }
 
-    for (auto& [_, constant] : vertexShaderConstants) {
-        constant.setUniform();
-    }
-
-    for (auto& [_, constant] : fragmentShaderConstants) {
-        constant.setUniform();
+    if (instanceBuffer != 0) {
+        glState.bindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        for (const auto& [key, glAttribLocation] : glInstanceAttribLocations) {
+            const StructuredData::ElemLayout::LocationAndSize& locationAndSizeInBuffer = instanceLayout.getLocationAndSize(key);
+
+            // Matrices take up one location per column.
+            int columns = glAttribLocation.elementCount > 4 ? glAttribLocation.elementCount / 4 : 1;
+            int columnSize = glAttribLocation.elementCount / columns;
+            for (int i = 0; i < columns; i++) {
+                GLuint location = glAttribLocation.location + i;
+                glEnableVertexAttribArray(location);
+                glVertexAttribPointer(location, columnSize, glAttribLocation.elementType, GL_FALSE, instanceLayout.getElementSize(),
+                    ptr + locationAndSizeInBuffer.location + i * columnSize * sizeof(GLfloat));
+                glVertexAttribDivisor(location, 1);
+            }
+        }
     }
 
-    for (auto& [_, constant] : samplerConstants) {
-        constant.setUniform();
-    }
+    GLenum glError = glGetError();
+    PGE_ASSERT(glError == GL_NO_ERROR, "Failed to set up vertex attributes (filepath: " + filepath.str() + "; GLERROR: " + String::from(glError) + ")");
 }
 
-void ShaderOGL3::unbindGLAttribs() {
-    graphics.takeGlContext();
-
-    for (const auto& [_, glAttribLocation] : glVertexAttribLocations) {
-        glDisableVertexAttribArray(glAttribLocation.location);
-    }
+u64 ShaderOGL3::getRevision() const {
+    return revision;
 }
 
 Shader::Constant& ShaderOGL3::getVertexShaderConstant(const String& name) {
@@ -304,75 +548,146 @@ Shader::Constant& ShaderOGL3::getFragmentShaderConstant(const String& name) {
     return it->second;
 }
 
-ShaderOGL3::ConstantOGL3::ConstantOGL3(GraphicsOGL3& gfx, GLint glLoc, GLenum glTyp, int glArrSz, StructuredData& data, const String::Key& dk) : dataBuffer(data), graphics(gfx) {
+ShaderOGL3::ConstantOGL3::ConstantOGL3(GraphicsOGL3& gfx, GLint glLoc, GLenum glTyp, int glArrSz, StructuredData& data, const String::Key& dk, UniformBlockOGL3* blk) : dataBuffer(data), graphics(gfx) {
     glLocation = glLoc;
     glType = glTyp;
     glArraySize = glArrSz;
     dataKey = dk;
+    block = blk;
+
+    const StructuredData::ElemLayout::LocationAndSize& locAndSize = dataBuffer.getLayout().getLocationAndSize(dataKey);
+    dataOffset = locAndSize.location;
+    dataSize = locAndSize.size;
+    dataArrayStride = locAndSize.arrayStride;
 }
 
 void ShaderOGL3::ConstantOGL3::setValue(const Matrix4x4f& value) {
     dataBuffer.setValue(0, dataKey, value);
+    markDirty();
 }
 
 void ShaderOGL3::ConstantOGL3::setValue(const Vector2f& value) {
     dataBuffer.setValue(0, dataKey, value);
+    markDirty();
 }
 
 void ShaderOGL3::ConstantOGL3::setValue(const Vector3f& value) {
     dataBuffer.setValue(0, dataKey, value);
+    markDirty();
 }
 
 void ShaderOGL3::ConstantOGL3::setValue(const Vector4f& value) {
     dataBuffer.setValue(0, dataKey, value);
+    markDirty();
 }
 
 void ShaderOGL3::ConstantOGL3::setValue(const Color& value) {
     dataBuffer.setValue(0, dataKey, value);
+    markDirty();
 }
 
 void ShaderOGL3::ConstantOGL3::setValue(float value) {
     dataBuffer.setValue(0, dataKey, value);
+    markDirty();
 }
 
 void ShaderOGL3::ConstantOGL3::setValue(u32 value) {
     dataBuffer.setValue(0, dataKey, value);
+    markDirty();
 }
 
-void ShaderOGL3::ConstantOGL3::setUniform() {
-    GLuint glError = GL_NO_ERROR;
+void ShaderOGL3::ConstantOGL3::markDirty() {
+    if (block != nullptr) {
+        block->markDirty();
+    } else {
+        dirty = true;
+    }
+}
 
-    graphics.takeGlContext();
-    const void* dataPtr = dataBuffer.getData() + dataBuffer.getLayout().getLocationAndSize(dataKey).location;
+bool ShaderOGL3::ConstantOGL3::isInBlock() const {
+    return block != nullptr;
+}
+
+void ShaderOGL3::ConstantOGL3::setUniform() {
+    if (block != nullptr) { return; }
+    graphics.getGlState().countUniformUpload(dirty);
+    if (!dirty) { return; }
+    dirty = false;
+
+    const byte* dataPtr = dataBuffer.getData() + dataOffset;
+    // glUniform*v expects tightly packed arrays, std140 pads the elements of small types to 16 bytes.
+    std::vector<byte> packedArray;
+    if (glArraySize > 1 && dataArrayStride != dataSize) {
+        packedArray.resize((size_t)dataSize * glArraySize);
+        for (int i = 0; i < glArraySize; i++) {
+            memcpy(packedArray.data() + (size_t)i * dataSize, dataPtr + (size_t)i * dataArrayStride, dataSize);
+        }
+        dataPtr = packedArray.data();
+    }
     const GLfloat* dataPtrF = (GLfloat*)dataPtr;
     const GLint* dataPtrI = (GLint*)dataPtr;
     const GLuint* dataPtrU = (GLuint*)dataPtr;
     switch (glType) {
         case GL_FLOAT_MAT4: {
-            glUniformMatrix4fv(glLocation, 1, GL_FALSE, dataPtrF);
+            glUniformMatrix4fv(glLocation, glArraySize, GL_FALSE, dataPtrF);
         } break;
         case GL_FLOAT_VEC2: {
-            glUniform2f(glLocation, *dataPtrF, *(dataPtrF + 1));
+            glUniform2fv(glLocation, glArraySize, dataPtrF);
         } break;
         case GL_FLOAT_VEC3: {
-            glUniform3f(glLocation, *dataPtrF, *(dataPtrF + 1), *(dataPtrF + 2));
+            glUniform3fv(glLocation, glArraySize, dataPtrF);
         } break;
         case GL_FLOAT_VEC4: {
-            glUniform4f(glLocation, *dataPtrF, *(dataPtrF + 1), *(dataPtrF + 2), *(dataPtrF + 3));
+            glUniform4fv(glLocation, glArraySize, dataPtrF);
         } break;
         case GL_FLOAT: {
-            glUniform1f(glLocation, *dataPtrF);
+            glUniform1fv(glLocation, glArraySize, dataPtrF);
         } break;
         case GL_INT: {
-            glUniform1i(glLocation, *dataPtrI);
+            glUniform1iv(glLocation, glArraySize, dataPtrI);
         } break;
         case GL_UNSIGNED_INT: {
-            glUniform1ui(glLocation, *dataPtrU);
+            glUniform1uiv(glLocation, glArraySize, dataPtrU);
         } break;
     }
+}
+
+void ShaderOGL3::ConstantOGL3::setLocation(GLint glLoc) {
+    glLocation = glLoc;
+}
+
+UniformBlockOGL3::UniformBlockOGL3(GraphicsOGL3& gfx, const StructuredData::ElemLayout& layout, GLuint bindingIndex) : glState(gfx.getGlState()), resourceManager(gfx) {
+    data = StructuredData(layout, 1);
+    glBindingIndex = bindingIndex;
+    dirty = true;
+
+    gfx.takeGlContext();
+    glBuffer = resourceManager.addNewResource<GLBuffer>(glState);
+    glState.bindBuffer(GL_UNIFORM_BUFFER, glBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, data.getDataSize(), nullptr, GL_DYNAMIC_DRAW);
+    glState.bindUniformBufferBase(glBindingIndex, glBuffer);
+    GLenum glError = glGetError();
+    PGE_ASSERT(glError == GL_NO_ERROR, "Failed to create uniform buffer (GLERROR: " + String::from(glError) + ")");
+}
+
+StructuredData& UniformBlockOGL3::getData() {
+    return data;
+}
+
+GLuint UniformBlockOGL3::getBindingIndex() const {
+    return glBindingIndex;
+}
+
+void UniformBlockOGL3::markDirty() {
+    dirty = true;
+}
 
-    glError = glGetError();
-    PGE_ASSERT(glError == GL_NO_ERROR, "Failed to set uniform value (GLERROR: " + String::from(glError) +")");
+void UniformBlockOGL3::upload() {
+    glState.countUniformUpload(dirty);
+    if (!dirty) { return; }
+    dirty = false;
+    glState.bindBuffer(GL_UNIFORM_BUFFER, glBuffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, data.getDataSize(), data.getData());
 }
 
 ShaderOGL3::GlAttribLocation::GlAttribLocation(GLint loc, GLenum elemType, int elemCount) {
@@ -13,6 +13,33 @@
 namespace PGE {
 
 class GraphicsOGL3;
+
+/// A `layout(std140) uniform` block, shared by all programs declaring a block of the same name.
+/// Setting a constant of the block in any shader sets it for all of them, the buffer is uploaded once per modification.
+class UniformBlockOGL3 {
+    public:
+        UniformBlockOGL3(GraphicsOGL3& gfx, const StructuredData::ElemLayout& layout, GLuint bindingIndex);
+
+        UniformBlockOGL3(const UniformBlockOGL3&) = delete;
+        void operator=(const UniformBlockOGL3&) = delete;
+
+        StructuredData& getData();
+        GLuint getBindingIndex() const;
+
+        void markDirty();
+        /// Uploads the data if it was modified since the last upload.
+        void upload();
+
+    private:
+        StructuredData data;
+        GLuint glBindingIndex;
+        bool dirty;
+
+        GLStateOGL3& glState;
+        ResourceManagerOGL3 resourceManager;
+        GLBuffer::View glBuffer;
+};
+
 class ShaderOGL3 : public Shader {
     public:
         ShaderOGL3(Graphics& gfx, const FilePath& path);
@@ -21,15 +48,29 @@ class ShaderOGL3 : public Shader {
         Constant& getVertexShaderConstant(const String& name) override;
         Constant& getFragmentShaderConstant(const String& name) override;
 
-        void useShader();
-        void unbindGLAttribs();
+        void useProgram();
+        /// Uploads the constants that changed since the last upload.
+        void uploadConstants();
+        /// Records the attribute setup into the currently bound vertex array.
+        /// Only needs to be done once per vertex array, as long as the revision doesn't change.
+        /// @param[in] instanceBuffer The buffer to source per-instance attributes from, 0 to leave them disabled.
+        /// @see #getRevision
+        void setUpVertexArray(GLuint vertexBuffer, GLuint instanceBuffer);
+        /// Changes whenever the attribute locations may have, unique across all shaders.
+        u64 getRevision() const;
+
+        /// Recompiles the shader from disk.
+        /// Fails if the sources don't compile or their interface (uniforms, attributes, outputs) has changed,
+        /// in which case the old program stays in use.
+        bool reload();
 
     private:
         GraphicsOGL3& graphics;
 
         class ConstantOGL3 : public Constant {
             public:
-                ConstantOGL3(GraphicsOGL3& gfx, GLint glLoc, GLenum glTyp, int glArrSz, StructuredData& data, const String::Key& dk);
+                /// @param[in] blk The block the constant belongs to, if any.
+                ConstantOGL3(GraphicsOGL3& gfx, GLint glLoc, GLenum glTyp, int glArrSz, StructuredData& data, const String::Key& dk, UniformBlockOGL3* blk = nullptr);
 
                 void setValue(const Matrix4x4f& value) override;
                 void setValue(const Vector2f& value) override;
@@ -39,7 +80,12 @@ class ShaderOGL3 : public Shader {
                 void setValue(float value) override;
                 void setValue(u32 value) override;
 
+                /// Uploads the value if it changed, the GL context must be current.
+                /// Does nothing for constants in a block, as those are uploaded with their block.
                 void setUniform();
+                void setLocation(GLint glLoc);
+                void markDirty();
+                bool isInBlock() const;
 
             private:
                 GraphicsOGL3& graphics;
@@ -49,6 +95,13 @@ class ShaderOGL3 : public Shader {
                 int glArraySize;
                 StructuredData& dataBuffer;
                 String::Key dataKey;
+                UniformBlockOGL3* block;
+
+                // Resolved once, so uploading doesn't need to look anything up.
+                int dataOffset;
+                int dataSize;
+                int dataArrayStride;
+                bool dirty = true;
         };
 
         std::unordered_map<String::Key, ConstantOGL3> vertexShaderConstants;
@@ -64,10 +117,20 @@ class ShaderOGL3 : public Shader {
         };
 
         std::unordered_map<String::Key, GlAttribLocation> glVertexAttribLocations;
+        std::unordered_map<String::Key, GlAttribLocation> glInstanceAttribLocations;
+
+        u64 revision;
+        static u64 nextRevision;
 
         StructuredData vertexUniformData;
         StructuredData fragmentUniformData;
 
+        // Everything uploadConstants needs to touch, in a flat list.
+        std::vector<ConstantOGL3*> uniformUploads;
+        std::vector<UniformBlockOGL3*> uniformBlocks;
+        std::vector<String> uniformBlockNames;
+        void buildUniformUploads();
+
         int glSizeToByteSize(GLenum type, int size) const;
         GLenum parsedTypeToGlType(const String& parsedType);
         void decomposeGlType(GLenum compositeType, GLenum& elemType, int& elemCount);
@@ -83,6 +146,17 @@ class ShaderOGL3 : public Shader {
         };
         void extractShaderVars(const String& src,const String& varKind,std::vector<ParsedShaderVar>& varList);
 
+        struct ParsedUniformBlock {
+            String name;
+            std::vector<ParsedShaderVar> members;
+        };
+        void extractUniformBlocks(const String& src, std::vector<ParsedUniformBlock>& blockList);
+        void setUpUniformBlocks(const String& src, std::unordered_map<String::Key, ConstantOGL3>& constants);
+        void bindUniformBlocks();
+
+        const String getInterfaceSignature(const String& vertexSource, const String& fragmentSource);
+        String interfaceSignature;
+
         GLShader::View glVertexShader;
         GLShader::View glFragmentShader;
         GLProgram::View glShaderProgram;
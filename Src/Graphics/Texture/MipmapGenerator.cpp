@@ -0,0 +1,333 @@
+#include <PGE/Graphics/MipmapGenerator.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+
+#include <PGE/Math/Math.h>
+#include <PGE/Exception/Exception.h>
+
+#include "../../Math/SIMD.h"
+#include "../../Threading/Parallel.h"
+
+using namespace PGE;
+
+namespace {
+
+constexpr int MIN_PARALLEL_ROWS = 16;
+
+constexpr float WINDOWED_SINC_RADIUS = 3.f;
+constexpr float KAISER_ALPHA = 4.f;
+
+float sinc(float x) {
+    if (std::abs(x) < 1e-5f) { return 1.f; }
+    x *= Math::PI;
+    return std::sin(x) / x;
+}
+
+// Modified Bessel function of the first kind, which shapes the Kaiser window.
+float besselI0(float x) {
+    float sum = 1.f;
+    float term = 1.f;
+    for (int k = 1; k < 20; k++) {
+        float factor = x / (2.f * k);
+        term *= factor * factor;
+        sum += term;
+    }
+    return sum;
+}
+
+// t is the distance in destination pixels.
+float evaluateFilter(MipmapGenerator::Filter filter, float t) {
+    t = std::abs(t);
+    switch (filter) {
+        case MipmapGenerator::Filter::BOX: {
+            return t < 0.5f ? 1.f : (t == 0.5f ? 0.5f : 0.f);
+        }
+        case MipmapGenerator::Filter::KAISER: {
+            if (t >= WINDOWED_SINC_RADIUS) { return 0.f; }
+            float r = t / WINDOWED_SINC_RADIUS;
+            return sinc(t) * besselI0(KAISER_ALPHA * std::sqrt(1.f - r * r)) / besselI0(KAISER_ALPHA);
+        }
+        case MipmapGenerator::Filter::LANCZOS: {
+            if (t >= WINDOWED_SINC_RADIUS) { return 0.f; }
+            return sinc(t) * sinc(t / WINDOWED_SINC_RADIUS);
+        }
+        default: {
+            throw PGE_CREATE_EX("Invalid filter");
+        }
+    }
+}
+
+float getFilterRadius(MipmapGenerator::Filter filter) {
+    return filter == MipmapGenerator::Filter::BOX ? 0.5f : WINDOWED_SINC_RADIUS;
+}
+
+// The source pixels each destination pixel along one axis is made of.
+struct Kernel {
+    int taps;
+    // taps entries per destination pixel, the sources already wrapped or clamped.
+    std::vector<int> sources;
+    std::vector<float> weights;
+
+    Kernel(int srcSize, int dstSize, MipmapGenerator::Filter filter, bool wrap) {
+        float scale = (float)srcSize / dstSize;
+        float support = getFilterRadius(filter) * scale;
+        taps = (int)std::ceil(support * 2.f) + 1;
+        sources.resize((size_t)dstSize * taps);
+        weights.resize((size_t)dstSize * taps);
+        for (int i = 0; i < dstSize; i++) {
+            float center = (i + 0.5f) * scale - 0.5f;
+            int first = (int)std::floor(center - support);
+            float sum = 0.f;
+            for (int j = 0; j < taps; j++) {
+                int source = first + j;
+                float weight = evaluateFilter(filter, (source - center) / scale);
+                source = wrap ? ((source % srcSize) + srcSize) % srcSize : std::clamp(source, 0, srcSize - 1);
+                sources[(size_t)i * taps + j] = source;
+                weights[(size_t)i * taps + j] = weight;
+                sum += weight;
+            }
+            for (int j = 0; j < taps; j++) {
+                weights[(size_t)i * taps + j] /= sum;
+            }
+        }
+    }
+};
+
+// Pixels as floats with either one or four channels, linear and normalized for the integer formats.
+struct Image {
+    int width;
+    int height;
+    int channels;
+    std::vector<float> pixels;
+
+    Image(int w, int h, int c) : width(w), height(h), channels(c), pixels((size_t)w * h * c) { }
+};
+
+int getChannelCount(Texture::Format fmt) {
+    return fmt == Texture::Format::R8 || fmt == Texture::Format::R32F ? 1 : 4;
+}
+
+float srgbToLinear(float f) {
+    return f <= 0.04045f ? f / 12.92f : std::pow((f + 0.055f) / 1.055f, 2.4f);
+}
+
+float linearToSrgb(float f) {
+    return f <= 0.0031308f ? f * 12.92f : 1.055f * std::pow(f, 1.f / 2.4f) - 0.055f;
+}
+
+void forRows(int count, bool allowParallel, const std::function<void(int begin, int end)>& func) {
+    if (allowParallel) {
+        Parallel::forRange(count, MIN_PARALLEL_ROWS, func);
+    } else {
+        func(0, count);
+    }
+}
+
+const Image decode(const byte* buffer, int w, int h, Texture::Format fmt, const MipmapGenerator::Options& options) {
+    Image image(w, h, getChannelCount(fmt));
+    float srgbTable[256];
+    for (int i = 0; i < 256; i++) {
+        srgbTable[i] = options.srgb ? srgbToLinear(i / 255.f) : i / 255.f;
+    }
+    forRows(h, options.allowParallel, [&](int begin, int end) {
+        size_t first = (size_t)begin * w * image.channels;
+        size_t last = (size_t)end * w * image.channels;
+        float* dst = image.pixels.data();
+        switch (fmt) {
+            case Texture::Format::RGBA32: {
+                for (size_t i = first; i < last; i++) {
+                    dst[i] = i % 4 == 3 ? buffer[i] / 255.f : srgbTable[buffer[i]];
+                }
+            } break;
+            case Texture::Format::RGBA64: {
+                for (size_t i = first; i < last; i++) {
+                    u16 value;
+                    memcpy(&value, buffer + i * sizeof(u16), sizeof(u16));
+                    float f = value / 65535.f;
+                    dst[i] = options.srgb && i % 4 != 3 ? srgbToLinear(f) : f;
+                }
+            } break;
+            case Texture::Format::R8: {
+                for (size_t i = first; i < last; i++) {
+                    dst[i] = buffer[i] / 255.f;
+                }
+            } break;
+            case Texture::Format::R32F: {
+                memcpy(dst + first, buffer + first * sizeof(float), (last - first) * sizeof(float));
+            } break;
+            default: {
+                throw PGE_CREATE_EX("Invalid format");
+            }
+        }
+    });
+    return image;
+}
+
+void encode(const Image& image, Texture::Format fmt, float alphaScale, const MipmapGenerator::Options& options, byte* out) {
+    forRows(image.height, options.allowParallel, [&](int begin, int end) {
+        size_t first = (size_t)begin * image.width * image.channels;
+        size_t last = (size_t)end * image.width * image.channels;
+        const float* src = image.pixels.data();
+        auto normalize = [&](size_t i) {
+            float f = src[i];
+            if (image.channels == 4 && i % 4 == 3) {
+                f *= alphaScale;
+            } else if (options.srgb && image.channels == 4) {
+                f = linearToSrgb(std::max(f, 0.f));
+            }
+            return std::clamp(f, 0.f, 1.f);
+        };
+        switch (fmt) {
+            case Texture::Format::RGBA32:
+            case Texture::Format::R8: {
+                for (size_t i = first; i < last; i++) {
+                    out[i] = (byte)std::lround(normalize(i) * 255.f);
+                }
+            } break;
+            case Texture::Format::RGBA64: {
+                for (size_t i = first; i < last; i++) {
+                    u16 value = (u16)std::lround(normalize(i) * 65535.f);
+                    memcpy(out + i * sizeof(u16), &value, sizeof(u16));
+                }
+            } break;
+            case Texture::Format::R32F: {
+                // Not normalized, so left as is.
+                memcpy(out + first * sizeof(float), src + first, (last - first) * sizeof(float));
+            } break;
+            default: {
+                throw PGE_CREATE_EX("Invalid format");
+            }
+        }
+    });
+}
+
+const Image downsample(const Image& src, int dstWidth, int dstHeight, const MipmapGenerator::Options& options) {
+    Image dst(dstWidth, dstHeight, src.channels);
+    Kernel vertical(src.height, dstHeight, options.filter, options.wrap);
+    Kernel horizontal(src.width, dstWidth, options.filter, options.wrap);
+    int rowLength = src.width * src.channels;
+
+    forRows(dstHeight, options.allowParallel, [&](int begin, int end) {
+        std::vector<float> row(rowLength);
+        for (int y = begin; y < end; y++) {
+            // Vertically into a row of the source's width, which is contiguous and filtered four floats at a time.
+            std::fill(row.begin(), row.end(), 0.f);
+            for (int tap = 0; tap < vertical.taps; tap++) {
+                float weight = vertical.weights[(size_t)y * vertical.taps + tap];
+                if (weight == 0.f) { continue; }
+                const float* srcRow = src.pixels.data() + (size_t)vertical.sources[(size_t)y * vertical.taps + tap] * rowLength;
+                SIMD::Float4 weights = SIMD::set(weight);
+                int i = 0;
+                for (; i + 4 <= rowLength; i += 4) {
+                    SIMD::store(&row[i], SIMD::madd(SIMD::load(srcRow + i), weights, SIMD::load(&row[i])));
+                }
+                for (; i < rowLength; i++) {
+                    row[i] += srcRow[i] * weight;
+                }
+            }
+
+            // Then horizontally, with a whole pixel per SIMD vector if there are four channels.
+            float* dstRow = dst.pixels.data() + (size_t)y * dstWidth * dst.channels;
+            for (int x = 0; x < dstWidth; x++) {
+                const int* sources = &horizontal.sources[(size_t)x * horizontal.taps];
+                const float* weights = &horizontal.weights[(size_t)x * horizontal.taps];
+                if (src.channels == 4) {
+                    SIMD::Float4 sum = SIMD::set(0.f);
+                    for (int tap = 0; tap < horizontal.taps; tap++) {
+                        sum = SIMD::madd(SIMD::load(&row[(size_t)sources[tap] * 4]), SIMD::set(weights[tap]), sum);
+                    }
+                    SIMD::store(dstRow + (size_t)x * 4, sum);
+                } else {
+                    float sum = 0.f;
+                    for (int tap = 0; tap < horizontal.taps; tap++) {
+                        sum += row[sources[tap]] * weights[tap];
+                    }
+                    dstRow[x] = sum;
+                }
+            }
+        }
+    });
+    return dst;
+}
+
+float computeAlphaCoverage(const Image& image, float reference, float scale) {
+    size_t covered = 0;
+    size_t pixelCount = (size_t)image.width * image.height;
+    for (size_t i = 0; i < pixelCount; i++) {
+        if (image.pixels[i * 4 + 3] * scale > reference) { covered++; }
+    }
+    return (float)covered / pixelCount;
+}
+
+// Searches for the alpha scale at which the image's coverage comes closest to the target.
+// Coverage rises in steps, so the search narrows down on the step crossing the target and picks the closer side.
+float findAlphaScale(const Image& image, float reference, float targetCoverage) {
+    float low = 0.f;
+    float high = 4.f;
+    for (int i = 0; i < 16; i++) {
+        float middle = (low + high) / 2.f;
+        if (computeAlphaCoverage(image, reference, middle) < targetCoverage) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    float lowError = std::abs(computeAlphaCoverage(image, reference, low) - targetCoverage);
+    float highError = std::abs(computeAlphaCoverage(image, reference, high) - targetCoverage);
+    return lowError < highError ? low : high;
+}
+
+}
+
+MipmapGenerator::MipmapChain::MipmapChain(Texture::Format fmt) : format(fmt) { }
+
+Texture::Format MipmapGenerator::MipmapChain::getFormat() const {
+    return format;
+}
+
+const std::vector<Texture::Mipmap>& MipmapGenerator::MipmapChain::getMipmaps() const {
+    return mipmaps;
+}
+
+Texture* MipmapGenerator::MipmapChain::load(Graphics& gfx) const {
+    return Texture::load(gfx, mipmaps, format);
+}
+
+const MipmapGenerator::MipmapChain MipmapGenerator::generate(const byte* buffer, int w, int h, Texture::Format fmt, const Options& options) {
+    PGE_ASSERT(buffer != nullptr, "Tried to generate mipmaps from nullptr");
+    PGE_ASSERT(w > 0 && h > 0, "Invalid dimensions (" + String::from(w) + "x" + String::from(h) + ")");
+
+    int bytesPerPixel = Texture::getBytesPerPixel(fmt);
+    MipmapChain result(fmt);
+    result.mipmaps.emplace_back(w, h, buffer, (size_t)w * h * bytesPerPixel);
+
+    std::vector<size_t> offsets;
+    size_t totalSize = 0;
+    for (int levelWidth = w, levelHeight = h; (levelWidth > 1 || levelHeight > 1)
+        && (options.maxLevels <= 0 || (int)offsets.size() + 1 < options.maxLevels);) {
+        levelWidth = std::max(1, levelWidth / 2);
+        levelHeight = std::max(1, levelHeight / 2);
+        offsets.push_back(totalSize);
+        totalSize += (size_t)levelWidth * levelHeight * bytesPerPixel;
+    }
+    result.data.resize(totalSize);
+    if (offsets.empty()) { return result; }
+
+    Image current = decode(buffer, w, h, fmt, options);
+    bool preserveCoverage = options.alphaCoverageReference.has_value() && current.channels == 4;
+    float targetCoverage = preserveCoverage ? computeAlphaCoverage(current, *options.alphaCoverageReference, 1.f) : 0.f;
+
+    for (size_t offset : offsets) {
+        // Always filtered from the previous level before its alpha was scaled, so scales don't compound.
+        Image next = downsample(current, std::max(1, current.width / 2), std::max(1, current.height / 2), options);
+        float alphaScale = preserveCoverage ? findAlphaScale(next, *options.alphaCoverageReference, targetCoverage) : 1.f;
+        byte* out = result.data.data() + offset;
+        encode(next, fmt, alphaScale, options, out);
+        result.mipmaps.emplace_back(next.width, next.height, out, (size_t)next.width * next.height * bytesPerPixel);
+        current = std::move(next);
+    }
+
+    return result;
+}
@@ -26,9 +26,35 @@ int Texture::getBytesPerPixel(Texture::Format fmt) {
     }
 }
 
+int Texture::getBytesPerBlock(Texture::CompressedFormat fmt) {
+    switch (fmt) {
+        case Texture::CompressedFormat::BC1:
+        case Texture::CompressedFormat::BC4:
+        {
+            return 8;
+        }
+        case Texture::CompressedFormat::BC2:
+        case Texture::CompressedFormat::BC3:
+        case Texture::CompressedFormat::BC5:
+        case Texture::CompressedFormat::BC6:
+        case Texture::CompressedFormat::BC7:
+        {
+            return 16;
+        }
+        default:
+        {
+            throw PGE_CREATE_EX("Invalid compressed format");
+        }
+    }
+}
+
 Texture::Texture(int w, int h, bool rt, const AnyFormat& fmt)
     : dimensions(w, h), isRT(rt), format(fmt) { }
 
+Texture::UploadStatus Texture::getUploadStatus() const {
+    return UploadStatus::COMPLETE;
+}
+
 bool Texture::isRenderTarget() const {
     return isRT;
 }
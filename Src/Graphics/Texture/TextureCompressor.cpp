@@ -0,0 +1,863 @@
+#include <PGE/Graphics/TextureCompressor.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <string.h>
+
+#include <PGE/Exception/Exception.h>
+
+#include "../../Math/SIMD.h"
+#include "../../Threading/Parallel.h"
+
+using namespace PGE;
+
+namespace {
+
+constexpr int BLOCK_SIZE = 4;
+constexpr int BLOCK_PIXELS = BLOCK_SIZE * BLOCK_SIZE;
+constexpr u32 ALL_PIXELS = (1u << BLOCK_PIXELS) - 1;
+
+constexpr int BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// Rounds the same way for the encoder's palettes and the decoder.
+int interpolate(int a, int b, int num, int den) {
+    return (a * (den - num) + b * num + den / 2) / den;
+}
+
+int roundToByte(float f) {
+    return std::clamp((int)std::lround(f), 0, 255);
+}
+
+// The channels of a block's pixels, split up so that four pixels fit into a SIMD vector.
+struct Block {
+    float channels[4][BLOCK_PIXELS];
+
+    // Pixels past the edges repeat the last row or column.
+    Block(const Texture::Mipmap& level, int blockX, int blockY) {
+        for (int y = 0; y < BLOCK_SIZE; y++) {
+            int srcY = std::min(blockY * BLOCK_SIZE + y, level.height - 1);
+            for (int x = 0; x < BLOCK_SIZE; x++) {
+                int srcX = std::min(blockX * BLOCK_SIZE + x, level.width - 1);
+                const byte* pixel = level.buffer + ((size_t)srcY * level.width + srcX) * 4;
+                for (int c = 0; c < 4; c++) {
+                    channels[c][y * BLOCK_SIZE + x] = pixel[c];
+                }
+            }
+        }
+    }
+};
+
+struct Palette {
+    float colors[16][4];
+    int size;
+};
+
+// Picks the closest palette entry for each pixel, comparing the channels [first, first + count).
+// Returns the squared error of the pixels in the mask.
+float findIndices(const Block& block, int first, int count, const Palette& palette, u32 mask, byte* indices) {
+    float total = 0.f;
+    for (int group = 0; group < BLOCK_PIXELS; group += 4) {
+        SIMD::Float4 pixels[4];
+        for (int c = 0; c < count; c++) {
+            pixels[c] = SIMD::load(&block.channels[first + c][group]);
+        }
+        SIMD::Float4 bestError = SIMD::set(std::numeric_limits<float>::max());
+        SIMD::Float4 bestIndex = SIMD::set(0.f);
+        for (int i = 0; i < palette.size; i++) {
+            SIMD::Float4 error = SIMD::set(0.f);
+            for (int c = 0; c < count; c++) {
+                SIMD::Float4 diff = SIMD::sub(pixels[c], SIMD::set(palette.colors[i][first + c]));
+                error = SIMD::madd(diff, diff, error);
+            }
+            SIMD::Float4 closer = SIMD::greater(bestError, error);
+            bestError = SIMD::select(closer, error, bestError);
+            bestIndex = SIMD::select(closer, SIMD::set((float)i), bestIndex);
+        }
+        float errors[4];
+        float groupIndices[4];
+        SIMD::store(errors, bestError);
+        SIMD::store(groupIndices, bestIndex);
+        for (int i = 0; i < 4; i++) {
+            indices[group + i] = (byte)groupIndices[i];
+            if ((mask & (1u << (group + i))) != 0) { total += errors[i]; }
+        }
+    }
+    return total;
+}
+
+// The line through color space a block's palette is spread along.
+struct Endpoints {
+    float colors[2][4];
+};
+
+Endpoints fitBoundingBox(const Block& block, int first, int count, u32 mask) {
+    Endpoints endpoints;
+    float mean[4] = { };
+    int pixelCount = 0;
+    int widest = first;
+    for (int c = first; c < first + count; c++) {
+        float low = 255.f;
+        float high = 0.f;
+        for (int i = 0; i < BLOCK_PIXELS; i++) {
+            if ((mask & (1u << i)) == 0) { continue; }
+            low = std::min(low, block.channels[c][i]);
+            high = std::max(high, block.channels[c][i]);
+            mean[c] += block.channels[c][i];
+            if (c == first) { pixelCount++; }
+        }
+        endpoints.colors[0][c] = low;
+        endpoints.colors[1][c] = high;
+        if (high - low > endpoints.colors[1][widest] - endpoints.colors[0][widest]) { widest = c; }
+    }
+    for (int c = first; c < first + count; c++) {
+        mean[c] /= pixelCount;
+    }
+
+    for (int c = first; c < first + count; c++) {
+        // Follow the diagonal of the box the colors lie along, channels falling while the widest one rises are flipped.
+        if (c != widest) {
+            float covariance = 0.f;
+            for (int i = 0; i < BLOCK_PIXELS; i++) {
+                if ((mask & (1u << i)) == 0) { continue; }
+                covariance += (block.channels[c][i] - mean[c]) * (block.channels[widest][i] - mean[widest]);
+            }
+            if (covariance < 0.f) { std::swap(endpoints.colors[0][c], endpoints.colors[1][c]); }
+        }
+        // Outliers rarely sit right on the corners, moving the endpoints inwards lowers the average error.
+        float inset = (endpoints.colors[1][c] - endpoints.colors[0][c]) / 16.f;
+        endpoints.colors[0][c] += inset;
+        endpoints.colors[1][c] -= inset;
+    }
+    return endpoints;
+}
+
+Endpoints fitPrincipalAxis(const Block& block, int first, int count, u32 mask) {
+    float mean[4] = { };
+    int pixelCount = 0;
+    for (int i = 0; i < BLOCK_PIXELS; i++) {
+        if ((mask & (1u << i)) == 0) { continue; }
+        for (int c = first; c < first + count; c++) {
+            mean[c] += block.channels[c][i];
+        }
+        pixelCount++;
+    }
+    for (int c = first; c < first + count; c++) {
+        mean[c] /= pixelCount;
+    }
+
+    float covariance[4][4] = { };
+    for (int i = 0; i < BLOCK_PIXELS; i++) {
+        if ((mask & (1u << i)) == 0) { continue; }
+        for (int a = first; a < first + count; a++) {
+            for (int b = first; b < first + count; b++) {
+                covariance[a][b] += (block.channels[a][i] - mean[a]) * (block.channels[b][i] - mean[b]);
+            }
+        }
+    }
+
+    // Power iteration, starting from the row of the channel varying the most.
+    int widest = first;
+    for (int c = first; c < first + count; c++) {
+        if (covariance[c][c] > covariance[widest][widest]) { widest = c; }
+    }
+    float axis[4] = { };
+    for (int c = first; c < first + count; c++) {
+        axis[c] = covariance[widest][c];
+    }
+    for (int iteration = 0; iteration < 8; iteration++) {
+        float next[4] = { };
+        float largest = 0.f;
+        for (int a = first; a < first + count; a++) {
+            for (int b = first; b < first + count; b++) {
+                next[a] += covariance[a][b] * axis[b];
+            }
+            largest = std::max(largest, std::abs(next[a]));
+        }
+        if (largest <= 0.f) { break; }
+        for (int c = first; c < first + count; c++) {
+            axis[c] = next[c] / largest;
+        }
+    }
+    float lengthSquared = 0.f;
+    for (int c = first; c < first + count; c++) {
+        lengthSquared += axis[c] * axis[c];
+    }
+
+    Endpoints endpoints;
+    if (lengthSquared <= 0.f) {
+        for (int c = first; c < first + count; c++) {
+            endpoints.colors[0][c] = mean[c];
+            endpoints.colors[1][c] = mean[c];
+        }
+        return endpoints;
+    }
+    float length = std::sqrt(lengthSquared);
+    for (int c = first; c < first + count; c++) {
+        axis[c] /= length;
+    }
+
+    float low = std::numeric_limits<float>::max();
+    float high = std::numeric_limits<float>::lowest();
+    for (int i = 0; i < BLOCK_PIXELS; i++) {
+        if ((mask & (1u << i)) == 0) { continue; }
+        float t = 0.f;
+        for (int c = first; c < first + count; c++) {
+            t += (block.channels[c][i] - mean[c]) * axis[c];
+        }
+        low = std::min(low, t);
+        high = std::max(high, t);
+    }
+    for (int c = first; c < first + count; c++) {
+        endpoints.colors[0][c] = std::clamp(mean[c] + axis[c] * low, 0.f, 255.f);
+        endpoints.colors[1][c] = std::clamp(mean[c] + axis[c] * high, 0.f, 255.f);
+    }
+    return endpoints;
+}
+
+// Solves for the endpoints that minimize the squared error with the indices kept as they are.
+// weights holds how far along from the first to the second endpoint each palette entry lies.
+bool refineEndpoints(const Block& block, int first, int count, u32 mask, const byte* indices, const float* weights, Endpoints& endpoints) {
+    float aa = 0.f;
+    float ab = 0.f;
+    float bb = 0.f;
+    float ax[4] = { };
+    float bx[4] = { };
+    for (int i = 0; i < BLOCK_PIXELS; i++) {
+        if ((mask & (1u << i)) == 0) { continue; }
+        float b = weights[indices[i]];
+        float a = 1.f - b;
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        for (int c = first; c < first + count; c++) {
+            ax[c] += a * block.channels[c][i];
+            bx[c] += b * block.channels[c][i];
+        }
+    }
+    float determinant = aa * bb - ab * ab;
+    // All pixels use the same index.
+    if (std::abs(determinant) < 1e-6f) { return false; }
+    for (int c = first; c < first + count; c++) {
+        endpoints.colors[0][c] = std::clamp((bb * ax[c] - ab * bx[c]) / determinant, 0.f, 255.f);
+        endpoints.colors[1][c] = std::clamp((aa * bx[c] - ab * ax[c]) / determinant, 0.f, 255.f);
+    }
+    return true;
+}
+
+int getRefinementCount(TextureCompressor::Quality quality) {
+    switch (quality) {
+        case TextureCompressor::Quality::FAST: { return 0; }
+        case TextureCompressor::Quality::NORMAL: { return 1; }
+        default: { return 3; }
+    }
+}
+
+void writeLittleEndian(byte* out, u64 value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out[i] = (byte)(value >> (i * 8));
+    }
+}
+
+u64 readLittleEndian(const byte* in, int bytes) {
+    u64 value = 0;
+    for (int i = 0; i < bytes; i++) {
+        value |= (u64)in[i] << (i * 8);
+    }
+    return value;
+}
+
+// BC1 color blocks, also used by BC2 and BC3.
+
+constexpr float FOUR_COLOR_WEIGHTS[4] = { 0.f, 1.f, 1.f / 3.f, 2.f / 3.f };
+constexpr float THREE_COLOR_WEIGHTS[3] = { 0.f, 1.f, 0.5f };
+
+u16 toRgb565(const float* color) {
+    int r = std::clamp((int)std::lround(color[0] * 31.f / 255.f), 0, 31);
+    int g = std::clamp((int)std::lround(color[1] * 63.f / 255.f), 0, 63);
+    int b = std::clamp((int)std::lround(color[2] * 31.f / 255.f), 0, 31);
+    return (u16)((r << 11) | (g << 5) | b);
+}
+
+void fromRgb565(u16 packed, int* color) {
+    int r = (packed >> 11) & 31;
+    int g = (packed >> 5) & 63;
+    int b = packed & 31;
+    color[0] = (r << 3) | (r >> 2);
+    color[1] = (g << 2) | (g >> 4);
+    color[2] = (b << 3) | (b >> 2);
+}
+
+// In BC1, the first endpoint being larger selects four colors, otherwise the third is halfway and the fourth is transparent black.
+// BC2 and BC3 always use four colors.
+Palette makeColorPalette(u16 first, u16 second, bool alwaysFourColors) {
+    int colors[2][3];
+    fromRgb565(first, colors[0]);
+    fromRgb565(second, colors[1]);
+    Palette palette;
+    palette.size = alwaysFourColors || first > second ? 4 : 3;
+    for (int c = 0; c < 3; c++) {
+        palette.colors[0][c] = (float)colors[0][c];
+        palette.colors[1][c] = (float)colors[1][c];
+        if (palette.size == 4) {
+            palette.colors[2][c] = (float)interpolate(colors[0][c], colors[1][c], 1, 3);
+            palette.colors[3][c] = (float)interpolate(colors[0][c], colors[1][c], 2, 3);
+        } else {
+            palette.colors[2][c] = (float)interpolate(colors[0][c], colors[1][c], 1, 2);
+        }
+    }
+    return palette;
+}
+
+struct ColorCandidate {
+    u16 endpoints[2];
+    byte indices[BLOCK_PIXELS];
+    float error;
+};
+
+ColorCandidate evaluateColor(const Block& block, u32 mask, const Endpoints& endpoints, bool threeColor) {
+    ColorCandidate candidate;
+    candidate.endpoints[0] = toRgb565(endpoints.colors[0]);
+    candidate.endpoints[1] = toRgb565(endpoints.colors[1]);
+    if (threeColor ? candidate.endpoints[0] > candidate.endpoints[1] : candidate.endpoints[0] < candidate.endpoints[1]) {
+        std::swap(candidate.endpoints[0], candidate.endpoints[1]);
+    }
+    candidate.error = findIndices(block, 0, 3, makeColorPalette(candidate.endpoints[0], candidate.endpoints[1], false), mask, candidate.indices);
+    return candidate;
+}
+
+ColorCandidate searchColor(const Block& block, u32 mask, const Endpoints& initial, bool threeColor, int refinements) {
+    ColorCandidate best = evaluateColor(block, mask, initial, threeColor);
+    for (int i = 0; i < refinements; i++) {
+        Endpoints endpoints;
+        int colors[2][3];
+        fromRgb565(best.endpoints[0], colors[0]);
+        fromRgb565(best.endpoints[1], colors[1]);
+        for (int c = 0; c < 3; c++) {
+            endpoints.colors[0][c] = (float)colors[0][c];
+            endpoints.colors[1][c] = (float)colors[1][c];
+        }
+        const float* weights = best.endpoints[0] > best.endpoints[1] ? FOUR_COLOR_WEIGHTS : THREE_COLOR_WEIGHTS;
+        if (!refineEndpoints(block, 0, 3, mask, best.indices, weights, endpoints)) { break; }
+        ColorCandidate candidate = evaluateColor(block, mask, endpoints, threeColor);
+        if (candidate.error >= best.error) { break; }
+        best = candidate;
+    }
+    return best;
+}
+
+void encodeColor(const Block& block, TextureCompressor::Quality quality, bool allowTransparent, byte* out) {
+    u32 transparent = 0;
+    if (allowTransparent) {
+        for (int i = 0; i < BLOCK_PIXELS; i++) {
+            if (block.channels[3][i] < 128.f) { transparent |= 1u << i; }
+        }
+    }
+    u32 opaque = ALL_PIXELS & ~transparent;
+    if (opaque == 0) {
+        writeLittleEndian(out, 0, 4);
+        writeLittleEndian(out + 4, 0xFFFFFFFF, 4);
+        return;
+    }
+
+    Endpoints initial = quality == TextureCompressor::Quality::FAST ? fitBoundingBox(block, 0, 3, opaque) : fitPrincipalAxis(block, 0, 3, opaque);
+    int refinements = getRefinementCount(quality);
+    ColorCandidate best = searchColor(block, opaque, initial, transparent != 0, refinements);
+    // The halfway color sometimes fits better than the thirds, only BC1 decoders honor the endpoint order though.
+    if (allowTransparent && transparent == 0 && quality == TextureCompressor::Quality::HIGH) {
+        ColorCandidate candidate = searchColor(block, opaque, initial, true, refinements);
+        if (candidate.error < best.error) { best = candidate; }
+    }
+
+    u32 indices = 0;
+    for (int i = 0; i < BLOCK_PIXELS; i++) {
+        u32 index = (transparent & (1u << i)) != 0 ? 3 : best.indices[i];
+        indices |= index << (i * 2);
+    }
+    writeLittleEndian(out, best.endpoints[0], 2);
+    writeLittleEndian(out + 2, best.endpoints[1], 2);
+    writeLittleEndian(out + 4, indices, 4);
+}
+
+void decodeColor(const byte* in, bool allowTransparent, int (*pixels)[4]) {
+    u16 first = (u16)readLittleEndian(in, 2);
+    u16 second = (u16)readLittleEndian(in + 2, 2);
+    u32 indices = (u32)readLittleEndian(in + 4, 4);
+    Palette palette = makeColorPalette(first, second, !allowTransparent);
+    for (int i = 0; i < BLOCK_PIXELS; i++) {
+        int index = (indices >> (i * 2)) & 3;
+        bool isTransparent = index == 3 && palette.size == 3;
+        for (int c = 0; c < 3; c++) {
+            pixels[i][c] = isTransparent ? 0 : (int)palette.colors[index][c];
+        }
+        pixels[i][3] = isTransparent ? 0 : 255;
+    }
+}
+
+// BC4 channels, also used by BC3 and BC5.
+
+Palette makeAlphaPalette(int first, int second, int channel) {
+    Palette palette;
+    palette.size = 8;
+    palette.colors[0][channel] = (float)first;
+    palette.colors[1][channel] = (float)second;
+    if (first > second) {
+        for (int i = 2; i < 8; i++) {
+            palette.colors[i][channel] = (float)interpolate(first, second, i - 1, 7);
+        }
+    } else {
+        for (int i = 2; i < 6; i++) {
+            palette.colors[i][channel] = (float)interpolate(first, second, i - 1, 5);
+        }
+        palette.colors[6][channel] = 0.f;
+        palette.colors[7][channel] = 255.f;
+    }
+    return palette;
+}
+
+constexpr float EIGHT_VALUE_WEIGHTS[8] = { 0.f, 1.f, 1.f / 7.f, 2.f / 7.f, 3.f / 7.f, 4.f / 7.f, 5.f / 7.f, 6.f / 7.f };
+
+struct AlphaCandidate {
+    int endpoints[2];
+    byte indices[BLOCK_PIXELS];
+    float error;
+};
+
+AlphaCandidate evaluateAlpha(const Block& block, int channel, int first, int second) {
+    AlphaCandidate candidate;
+    candidate.endpoints[0] = first;
+    candidate.endpoints[1] = second;
+    candidate.error = findIndices(block, channel, 1, makeAlphaPalette(first, second, channel), ALL_PIXELS, candidate.indices);
+    return candidate;
+}
+
+void encodeAlpha(const Block& block, int channel, TextureCompressor::Quality quality, byte* out) {
+    float low = 255.f;
+    float high = 0.f;
+    for (int i = 0; i < BLOCK_PIXELS; i++) {
+        low = std::min(low, block.channels[channel][i]);
+        high = std::max(high, block.channels[channel][i]);
+    }
+
+    // Eight values between the endpoints, equal endpoints are exact for uniform blocks.
+    AlphaCandidate best = evaluateAlpha(block, channel, roundToByte(high), roundToByte(low));
+    for (int i = 0; i < getRefinementCount(quality) && best.endpoints[0] > best.endpoints[1] && best.error > 0.f; i++) {
+        Endpoints endpoints;
+        endpoints.colors[0][channel] = (float)best.endpoints[0];
+        endpoints.colors[1][channel] = (float)best.endpoints[1];
+        if (!refineEndpoints(block, channel, 1, ALL_PIXELS, best.indices, EIGHT_VALUE_WEIGHTS, endpoints)) { break; }
+        int first = roundToByte(endpoints.colors[0][channel]);
+        int second = roundToByte(endpoints.colors[1][channel]);
+        if (first == second) { break; }
+        AlphaCandidate candidate = evaluateAlpha(block, channel, std::max(first, second), std::min(first, second));
+        if (candidate.error >= best.error) { break; }
+        best = candidate;
+    }
+
+    // Six values between the endpoints plus exact 0 and 255, for blocks mixing those with something in between.
+    if (quality == TextureCompressor::Quality::HIGH && best.error > 0.f) {
+        float innerLow = 255.f;
+        float innerHigh = 0.f;
+        for (int i = 0; i < BLOCK_PIXELS; i++) {
+            float value = block.channels[channel][i];
+            if (value <= 0.f || value >= 255.f) { continue; }
+            innerLow = std::min(innerLow, value);
+            innerHigh = std::max(innerHigh, value);
+        }
+        if (innerLow <= innerHigh) {
+            AlphaCandidate candidate = evaluateAlpha(block, channel, roundToByte(innerLow), roundToByte(innerHigh));
+            if (candidate.error < best.error) { best = candidate; }
+        }
+    }
+
+    u64 packed = (u64)best.endpoints[0] | ((u64)best.endpoints[1] << 8);
+    for (int i = 0; i < BLOCK_PIXELS; i++) {
+        packed |= (u64)best.indices[i] << (16 + i * 3);
+    }
+    writeLittleEndian(out, packed, 8);
+}
+
+void decodeAlpha(const byte* in, int channel, int (*pixels)[4]) {
+    u64 packed = readLittleEndian(in, 8);
+    Palette palette = makeAlphaPalette((int)(packed & 0xFF), (int)((packed >> 8) & 0xFF), channel);
+    for (int i = 0; i < BLOCK_PIXELS; i++) {
+        pixels[i][channel] = (int)palette.colors[(packed >> (16 + i * 3)) & 7][channel];
+    }
+}
+
+// BC2 alpha, four bits per pixel.
+
+void encodeExplicitAlpha(const Block& block, byte* out) {
+    u64 packed = 0;
+    for (int i = 0; i < BLOCK_PIXELS; i++) {
+        packed |= (u64)std::lround(block.channels[3][i] / 17.f) << (i * 4);
+    }
+    writeLittleEndian(out, packed, 8);
+}
+
+void decodeExplicitAlpha(const byte* in, int (*pixels)[4]) {
+    u64 packed = readLittleEndian(in, 8);
+    for (int i = 0; i < BLOCK_PIXELS; i++) {
+        pixels[i][3] = (int)((packed >> (i * 4)) & 15) * 17;
+    }
+}
+
+// BC7, mode 6 only: a single pair of RGBA endpoints with seven bits per channel and a shared lowest bit each,
+// and 16 palette entries.
+
+class BitWriter {
+    public:
+        BitWriter(byte* out, int bytes) : out(out) {
+            memset(out, 0, bytes);
+        }
+
+        void write(u32 value, int bits) {
+            for (int i = 0; i < bits; i++, position++) {
+                out[position / 8] |= (byte)(((value >> i) & 1) << (position % 8));
+            }
+        }
+
+    private:
+        byte* out;
+        int position = 0;
+};
+
+class BitReader {
+    public:
+        BitReader(const byte* in) : in(in) { }
+
+        u32 read(int bits) {
+            u32 value = 0;
+            for (int i = 0; i < bits; i++, position++) {
+                value |= (u32)((in[position / 8] >> (position % 8)) & 1) << i;
+            }
+            return value;
+        }
+
+    private:
+        const byte* in;
+        int position = 0;
+};
+
+constexpr int BC7_MODE = 6;
+
+int quantizeBc7(float value, int lowestBit) {
+    return std::clamp((int)std::lround((value - lowestBit) / 2.f), 0, 127) * 2 + lowestBit;
+}
+
+Palette makeBc7Palette(const int (*endpoints)[4]) {
+    Palette palette;
+    palette.size = 16;
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 4; c++) {
+            palette.colors[i][c] = (float)interpolate(endpoints[0][c], endpoints[1][c], BC7_WEIGHTS[i], 64);
+        }
+    }
+    return palette;
+}
+
+struct Bc7Candidate {
+    int endpoints[2][4];
+    byte indices[BLOCK_PIXELS];
+    float error;
+};
+
+Bc7Candidate evaluateBc7(const Block& block, const Endpoints& endpoints, const int* lowestBits) {
+    Bc7Candidate candidate;
+    for (int e = 0; e < 2; e++) {
+        for (int c = 0; c < 4; c++) {
+            candidate.endpoints[e][c] = quantizeBc7(endpoints.colors[e][c], lowestBits[e]);
+        }
+    }
+    candidate.error = findIndices(block, 0, 4, makeBc7Palette(candidate.endpoints), ALL_PIXELS, candidate.indices);
+    return candidate;
+}
+
+Bc7Candidate quantizeBc7Endpoints(const Block& block, const Endpoints& endpoints, TextureCompressor::Quality quality) {
+    if (quality == TextureCompressor::Quality::HIGH) {
+        Bc7Candidate best;
+        best.error = std::numeric_limits<float>::max();
+        for (int bits = 0; bits < 4; bits++) {
+            int lowestBits[2] = { bits & 1, bits >> 1 };
+            Bc7Candidate candidate = evaluateBc7(block, endpoints, lowestBits);
+            if (candidate.error < best.error) { best = candidate; }
+        }
+        return best;
+    }
+
+    // Picks each endpoint's lowest bit by how close it gets that endpoint alone.
+    int lowestBits[2];
+    for (int e = 0; e < 2; e++) {
+        float errors[2] = { };
+        for (int bit = 0; bit < 2; bit++) {
+            for (int c = 0; c < 4; c++) {
+                float diff = quantizeBc7(endpoints.colors[e][c], bit) - endpoints.colors[e][c];
+                errors[bit] += diff * diff;
+            }
+        }
+        lowestBits[e] = errors[1] < errors[0] ? 1 : 0;
+    }
+    return evaluateBc7(block, endpoints, lowestBits);
+}
+
+void encodeBc7(const Block& block, TextureCompressor::Quality quality, byte* out) {
+    Endpoints initial = quality == TextureCompressor::Quality::FAST ? fitBoundingBox(block, 0, 4, ALL_PIXELS) : fitPrincipalAxis(block, 0, 4, ALL_PIXELS);
+    Bc7Candidate best = quantizeBc7Endpoints(block, initial, quality);
+
+    float weights[16];
+    for (int i = 0; i < 16; i++) {
+        weights[i] = BC7_WEIGHTS[i] / 64.f;
+    }
+    for (int i = 0; i < getRefinementCount(quality) && best.error > 0.f; i++) {
+        Endpoints endpoints;
+        for (int e = 0; e < 2; e++) {
+            for (int c = 0; c < 4; c++) {
+                endpoints.colors[e][c] = (float)best.endpoints[e][c];
+            }
+        }
+        if (!refineEndpoints(block, 0, 4, ALL_PIXELS, best.indices, weights, endpoints)) { break; }
+        Bc7Candidate candidate = quantizeBc7Endpoints(block, endpoints, quality);
+        if (candidate.error >= best.error) { break; }
+        best = candidate;
+    }
+
+    // The first pixel's index is stored without its highest bit, which must therefore be 0.
+    if (best.indices[0] >= 8) {
+        for (int c = 0; c < 4; c++) {
+            std::swap(best.endpoints[0][c], best.endpoints[1][c]);
+        }
+        for (int i = 0; i < BLOCK_PIXELS; i++) {
+            best.indices[i] = (byte)(15 - best.indices[i]);
+        }
+    }
+
+    BitWriter writer(out, 16);
+    writer.write(1u << BC7_MODE, BC7_MODE + 1);
+    for (int c = 0; c < 4; c++) {
+        writer.write(best.endpoints[0][c] >> 1, 7);
+        writer.write(best.endpoints[1][c] >> 1, 7);
+    }
+    writer.write(best.endpoints[0][0] & 1, 1);
+    writer.write(best.endpoints[1][0] & 1, 1);
+    writer.write(best.indices[0], 3);
+    for (int i = 1; i < BLOCK_PIXELS; i++) {
+        writer.write(best.indices[i], 4);
+    }
+}
+
+// Only decodes what encodeBc7 produces.
+void decodeBc7(const byte* in, int (*pixels)[4]) {
+    BitReader reader(in);
+    reader.read(BC7_MODE + 1);
+    int endpoints[2][4];
+    for (int c = 0; c < 4; c++) {
+        endpoints[0][c] = (int)reader.read(7) << 1;
+        endpoints[1][c] = (int)reader.read(7) << 1;
+    }
+    for (int e = 0; e < 2; e++) {
+        int lowestBit = (int)reader.read(1);
+        for (int c = 0; c < 4; c++) {
+            endpoints[e][c] |= lowestBit;
+        }
+    }
+    Palette palette = makeBc7Palette(endpoints);
+    for (int i = 0; i < BLOCK_PIXELS; i++) {
+        u32 index = reader.read(i == 0 ? 3 : 4);
+        for (int c = 0; c < 4; c++) {
+            pixels[i][c] = (int)palette.colors[index][c];
+        }
+    }
+}
+
+// Channels kept by each format, starting at red.
+int getChannelCount(Texture::CompressedFormat fmt) {
+    switch (fmt) {
+        case Texture::CompressedFormat::BC4: { return 1; }
+        case Texture::CompressedFormat::BC5: { return 2; }
+        default: { return 4; }
+    }
+}
+
+void encodeBlock(const Block& block, Texture::CompressedFormat fmt, TextureCompressor::Quality quality, byte* out) {
+    switch (fmt) {
+        case Texture::CompressedFormat::BC1: {
+            encodeColor(block, quality, true, out);
+        } break;
+        case Texture::CompressedFormat::BC2: {
+            encodeExplicitAlpha(block, out);
+            encodeColor(block, quality, false, out + 8);
+        } break;
+        case Texture::CompressedFormat::BC3: {
+            encodeAlpha(block, 3, quality, out);
+            encodeColor(block, quality, false, out + 8);
+        } break;
+        case Texture::CompressedFormat::BC4: {
+            encodeAlpha(block, 0, quality, out);
+        } break;
+        case Texture::CompressedFormat::BC5: {
+            encodeAlpha(block, 0, quality, out);
+            encodeAlpha(block, 1, quality, out + 8);
+        } break;
+        case Texture::CompressedFormat::BC7: {
+            encodeBc7(block, quality, out);
+        } break;
+        default: {
+            throw PGE_CREATE_EX("Invalid compressed format");
+        }
+    }
+}
+
+void decodeBlock(const byte* in, Texture::CompressedFormat fmt, int (*pixels)[4]) {
+    switch (fmt) {
+        case Texture::CompressedFormat::BC1: {
+            decodeColor(in, true, pixels);
+        } break;
+        case Texture::CompressedFormat::BC2: {
+            decodeColor(in + 8, false, pixels);
+            decodeExplicitAlpha(in, pixels);
+        } break;
+        case Texture::CompressedFormat::BC3: {
+            decodeColor(in + 8, false, pixels);
+            decodeAlpha(in, 3, pixels);
+        } break;
+        case Texture::CompressedFormat::BC4: {
+            decodeAlpha(in, 0, pixels);
+        } break;
+        case Texture::CompressedFormat::BC5: {
+            decodeAlpha(in, 0, pixels);
+            decodeAlpha(in + 8, 1, pixels);
+        } break;
+        case Texture::CompressedFormat::BC7: {
+            decodeBc7(in, pixels);
+        } break;
+        default: {
+            throw PGE_CREATE_EX("Invalid compressed format");
+        }
+    }
+}
+
+// Of the pixels within the level, which excludes the padding of blocks along the edges.
+double computeSquaredError(const Block& block, const byte* encoded, Texture::CompressedFormat fmt, int width, int height) {
+    int pixels[BLOCK_PIXELS][4];
+    decodeBlock(encoded, fmt, pixels);
+    int channelCount = getChannelCount(fmt);
+    double error = 0.0;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int i = y * BLOCK_SIZE + x;
+            for (int c = 0; c < channelCount; c++) {
+                double diff = pixels[i][c] - block.channels[c][i];
+                error += diff * diff;
+            }
+        }
+    }
+    return error;
+}
+
+}
+
+TextureCompressor::CompressedTexture::CompressedTexture(Texture::CompressedFormat fmt) : format(fmt) { }
+
+Texture::CompressedFormat TextureCompressor::CompressedTexture::getFormat() const {
+    return format;
+}
+
+const std::vector<Texture::Mipmap>& TextureCompressor::CompressedTexture::getMipmaps() const {
+    return mipmaps;
+}
+
+const std::vector<byte>& TextureCompressor::CompressedTexture::getData() const {
+    return data;
+}
+
+const TextureCompressor::Report& TextureCompressor::CompressedTexture::getReport() const {
+    return report;
+}
+
+Texture* TextureCompressor::CompressedTexture::load(Graphics& gfx) const {
+    return Texture::loadCompressed(gfx, mipmaps, format);
+}
+
+const TextureCompressor::CompressedTexture TextureCompressor::compress(const std::vector<Texture::Mipmap>& levels, Texture::CompressedFormat fmt, const Options& options) {
+    PGE_ASSERT(!levels.empty(), "Tried to compress texture without any levels");
+    PGE_ASSERT(fmt != Texture::CompressedFormat::BC6, "BC6 requires HDR input, which can't be compressed");
+    for (int i = 0; i < (int)levels.size(); i++) {
+        const Texture::Mipmap& level = levels[i];
+        PGE_ASSERT(level.buffer != nullptr && level.width > 0 && level.height > 0, "Invalid level " + String::from(i));
+        PGE_ASSERT(level.size == (size_t)level.width * level.height * 4, "Buffer size of level " + String::from(i) + " doesn't match its dimensions");
+        if (i > 0) {
+            PGE_ASSERT(level.width == std::max(1, levels[i - 1].width / 2) && level.height == std::max(1, levels[i - 1].height / 2),
+                "Level " + String::from(i) + " isn't half the size of the previous one");
+        }
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    CompressedTexture result(fmt);
+    int blockBytes = Texture::getBytesPerBlock(fmt);
+    std::vector<size_t> offsets;
+    size_t totalSize = 0;
+    for (const Texture::Mipmap& level : levels) {
+        offsets.push_back(totalSize);
+        totalSize += (size_t)((level.width + 3) / 4) * ((level.height + 3) / 4) * blockBytes;
+        result.report.bytesBefore += level.size;
+    }
+    result.data.resize(totalSize);
+    result.report.bytesAfter = totalSize;
+    result.report.blockCount = totalSize / blockBytes;
+
+    auto forEachRow = [&](int rows, const std::function<void(int, int)>& func) {
+        if (options.allowParallel) {
+            Parallel::forRange(rows, 4, func);
+        } else {
+            func(0, rows);
+        }
+    };
+
+    for (int i = 0; i < (int)levels.size(); i++) {
+        const Texture::Mipmap& level = levels[i];
+        int blocksX = (level.width + 3) / 4;
+        byte* out = result.data.data() + offsets[i];
+        forEachRow((level.height + 3) / 4, [&](int begin, int end) {
+            for (int y = begin; y < end; y++) {
+                for (int x = 0; x < blocksX; x++) {
+                    encodeBlock(Block(level, x, y), fmt, options.quality, out + ((size_t)y * blocksX + x) * blockBytes);
+                }
+            }
+        });
+        size_t size = (i + 1 < (int)levels.size() ? offsets[i + 1] : totalSize) - offsets[i];
+        result.mipmaps.emplace_back(level.width, level.height, out, size);
+    }
+    // Measuring the PSNR decodes every block again, which isn't part of compressing.
+    result.report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double squaredError = 0.0;
+    u64 sampleCount = 0;
+    for (int i = 0; i < (int)levels.size(); i++) {
+        const Texture::Mipmap& level = levels[i];
+        int blocksX = (level.width + 3) / 4;
+        int blocksY = (level.height + 3) / 4;
+        const byte* encoded = result.data.data() + offsets[i];
+
+        // Summed per row afterwards, so the result doesn't depend on how the rows were split up.
+        std::vector<double> rowErrors(blocksY);
+        forEachRow(blocksY, [&](int begin, int end) {
+            for (int y = begin; y < end; y++) {
+                for (int x = 0; x < blocksX; x++) {
+                    rowErrors[y] += computeSquaredError(Block(level, x, y), encoded + ((size_t)y * blocksX + x) * blockBytes, fmt,
+                        std::min(BLOCK_SIZE, level.width - x * BLOCK_SIZE), std::min(BLOCK_SIZE, level.height - y * BLOCK_SIZE));
+                }
+            }
+        });
+
+        for (double error : rowErrors) {
+            squaredError += error;
+        }
+        sampleCount += (u64)level.width * level.height * getChannelCount(fmt);
+    }
+
+    double meanSquaredError = squaredError / sampleCount;
+    result.report.psnr = meanSquaredError > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / meanSquaredError) : std::numeric_limits<double>::infinity();
+
+    return result;
+}
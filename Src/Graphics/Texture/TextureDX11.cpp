@@ -45,6 +45,7 @@ static int getBitsPerBlockOnLine(Texture::CompressedFormat fmt) {
 }
 
 TextureDX11::TextureDX11(Graphics& gfx, int w, int h, Format fmt) : Texture(w, h, true, fmt), graphics((GraphicsDX11&)gfx) {
+    mipmaps = false;
     ID3D11Device* dxDevice = graphics.getDxDevice();
 
     DXGI_FORMAT dxFormat = getDXFormat(fmt);
@@ -61,6 +62,7 @@ TextureDX11::TextureDX11(Graphics& gfx, int w, int h, Format fmt) : Texture(w, h
 }
 
 TextureDX11::TextureDX11(Graphics& gfx, int w, int h, const byte* buffer, Format fmt, bool mipmaps) : Texture(w, h, false, fmt), graphics((GraphicsDX11&)gfx) {
+    this->mipmaps = mipmaps;
     ID3D11Device* dxDevice = graphics.getDxDevice();
     ID3D11DeviceContext* dxContext = graphics.getDxContext();
 
@@ -74,12 +76,13 @@ TextureDX11::TextureDX11(Graphics& gfx, int w, int h, const byte* buffer, Format
 }
 
 TextureDX11::TextureDX11(Graphics& gfx, const std::vector<Texture::Mipmap>& mipmaps, CompressedFormat fmt) : Texture(mipmaps[0].width, mipmaps[0].height, false, fmt), graphics((GraphicsDX11&)gfx) {
+    this->mipmaps = mipmaps.size() > 1;
     ID3D11Device* dxDevice = graphics.getDxDevice();
     ID3D11DeviceContext* dxContext = graphics.getDxContext();
 
     DXGI_FORMAT dxFormat = getDXFormat(fmt);
 
-    dxTexture = resourceManager.addNewResource<D3D11Texture2D>(dxDevice, D3D11Texture2D::Type::COMPRESSED, mipmaps[0].width, mipmaps[0].height, dxFormat);
+    dxTexture = resourceManager.addNewResource<D3D11Texture2D>(dxDevice, D3D11Texture2D::Type::COMPRESSED, mipmaps[0].width, mipmaps[0].height, dxFormat, (int)mipmaps.size());
     for (int i = 0; i < mipmaps.size(); i++) {
         dxContext->UpdateSubresource(dxTexture, D3D11CalcSubresource(i, 0, (UINT)mipmaps.size()), NULL, mipmaps[i].buffer, mipmaps[i].width * getBitsPerBlockOnLine(fmt), 0);
     }
@@ -87,6 +90,39 @@ TextureDX11::TextureDX11(Graphics& gfx, const std::vector<Texture::Mipmap>& mipm
     dxShaderResourceView = resourceManager.addNewResource<D3D11ShaderResourceView>(dxDevice, dxTexture, dxFormat, false);
 }
 
+TextureDX11::TextureDX11(Graphics& gfx, const std::vector<Texture::Mipmap>& mipmaps, Format fmt) : Texture(mipmaps[0].width, mipmaps[0].height, false, fmt), graphics((GraphicsDX11&)gfx) {
+    this->mipmaps = mipmaps.size() > 1;
+    ID3D11Device* dxDevice = graphics.getDxDevice();
+    ID3D11DeviceContext* dxContext = graphics.getDxContext();
+
+    DXGI_FORMAT dxFormat = getDXFormat(fmt);
+
+    dxTexture = resourceManager.addNewResource<D3D11Texture2D>(dxDevice, D3D11Texture2D::Type::PRESET_MIPMAPS, mipmaps[0].width, mipmaps[0].height, dxFormat, (int)mipmaps.size());
+    for (int i = 0; i < mipmaps.size(); i++) {
+        dxContext->UpdateSubresource(dxTexture, D3D11CalcSubresource(i, 0, (UINT)mipmaps.size()), NULL, mipmaps[i].buffer, mipmaps[i].width * getBytesPerPixel(fmt), 0);
+    }
+
+    dxShaderResourceView = resourceManager.addNewResource<D3D11ShaderResourceView>(dxDevice, dxTexture, dxFormat, false);
+}
+
+Texture* TextureDX11::createAsync(Graphics& gfx, const std::vector<Mipmap>& mipmaps, const AnyFormat& fmt) {
+    if (std::holds_alternative<CompressedFormat>(fmt)) {
+        return new TextureDX11(gfx, mipmaps, std::get<CompressedFormat>(fmt));
+    }
+    return new TextureDX11(gfx, mipmaps, std::get<Format>(fmt));
+}
+
+bool TextureDX11::reload(const std::vector<byte>& buffer) {
+    if (isRT || !std::holds_alternative<Format>(format)) { return false; }
+    Format fmt = std::get<Format>(format);
+    if (buffer.size() != (size_t)dimensions.x * dimensions.y * getBytesPerPixel(fmt)) { return false; }
+
+    ID3D11DeviceContext* dxContext = graphics.getDxContext();
+    dxContext->UpdateSubresource(dxTexture, 0, NULL, buffer.data(), dimensions.x * getBytesPerPixel(fmt), 0);
+    if (mipmaps) { dxContext->GenerateMips(dxShaderResourceView); }
+    return true;
+}
+
 void TextureDX11::useTexture(int index) {
     ID3D11DeviceContext* dxContext = graphics.getDxContext();
     ID3D11ShaderResourceView* srvArr[] { dxShaderResourceView };
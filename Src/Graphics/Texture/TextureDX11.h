@@ -18,8 +18,12 @@ class TextureDX11 : public Texture {
         TextureDX11(Graphics& gfx, int w, int h, Format fmt);
         // Loaded texture.
         TextureDX11(Graphics& gfx, int w, int h, const byte* buffer, Format fmt, bool mipmaps);
+        // Loaded texture with all levels provided.
+        TextureDX11(Graphics& gfx, const std::vector<Mipmap>& mipmaps, Format fmt);
         // Loaded, compressed texture.
         TextureDX11(Graphics& gfx, const std::vector<Mipmap>& mipmaps, CompressedFormat fmt);
+        // Loads synchronously, as there's no upload queue yet.
+        static Texture* createAsync(Graphics& gfx, const std::vector<Mipmap>& mipmaps, const AnyFormat& fmt);
 
         void useTexture(int index);
 
@@ -27,8 +31,13 @@ class TextureDX11 : public Texture {
         ID3D11DepthStencilView* getZBufferView() const;
         void* getNative() const override;
 
+        /// Replaces the contents of a loaded, uncompressed texture.
+        /// The buffer must match the texture's dimensions and format.
+        bool reload(const std::vector<byte>& buffer);
+
     private:
         GraphicsDX11& graphics;
+        bool mipmaps;
 
         D3D11Texture2D::View dxTexture;
         D3D11ShaderResourceView::View dxShaderResourceView;
@@ -0,0 +1,209 @@
+#include <PGE/Graphics/TextureFile.h>
+
+#include <algorithm>
+#include <optional>
+#include <string.h>
+
+#include <PGE/Exception/Exception.h>
+
+using namespace PGE;
+
+// Both containers are little endian, as are all supported platforms.
+template <typename T>
+static T read(const byte* data, size_t size, size_t offset) {
+    PGE_ASSERT(offset <= size && sizeof(T) <= size - offset, "Texture file is truncated");
+    T value;
+    memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+
+static constexpr u32 fourCC(const char (&code)[5]) {
+    return (u32)(byte)code[0] | ((u32)(byte)code[1] << 8) | ((u32)(byte)code[2] << 16) | ((u32)(byte)code[3] << 24);
+}
+
+static const byte KTX2_IDENTIFIER[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+TextureFile::TextureFile(const FilePath& path) : file(path) {
+    const byte* data = file.getData();
+    size_t size = file.getSize();
+    if (size >= 4 && read<u32>(data, size, 0) == fourCC("DDS ")) {
+        readDds(path);
+    } else if (size >= sizeof(KTX2_IDENTIFIER) && memcmp(data, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) == 0) {
+        readKtx2(path);
+    } else {
+        throw PGE_CREATE_EX("Not a DDS or KTX2 file (file: \"" + path.str() + "\")");
+    }
+}
+
+static std::optional<Texture::CompressedFormat> getDdsFourCCFormat(u32 code) {
+    switch (code) {
+        case fourCC("DXT1"): { return Texture::CompressedFormat::BC1; }
+        // Premultiplied alpha, which is stored the same way.
+        case fourCC("DXT2"):
+        case fourCC("DXT3"): { return Texture::CompressedFormat::BC2; }
+        case fourCC("DXT4"):
+        case fourCC("DXT5"): { return Texture::CompressedFormat::BC3; }
+        case fourCC("ATI1"):
+        case fourCC("BC4U"): { return Texture::CompressedFormat::BC4; }
+        case fourCC("ATI2"):
+        case fourCC("BC5U"): { return Texture::CompressedFormat::BC5; }
+        default: { return std::nullopt; }
+    }
+}
+
+// DXGI_FORMAT values, the typeless ones are taken to hold the same data as the others.
+static std::optional<Texture::CompressedFormat> getDxgiFormat(u32 dxgiFormat) {
+    switch (dxgiFormat) {
+        case 70: case 71: case 72: { return Texture::CompressedFormat::BC1; }
+        case 73: case 74: case 75: { return Texture::CompressedFormat::BC2; }
+        case 76: case 77: case 78: { return Texture::CompressedFormat::BC3; }
+        case 79: case 80: { return Texture::CompressedFormat::BC4; }
+        case 82: case 83: { return Texture::CompressedFormat::BC5; }
+        case 94: case 96: { return Texture::CompressedFormat::BC6; }
+        case 97: case 98: case 99: { return Texture::CompressedFormat::BC7; }
+        default: { return std::nullopt; }
+    }
+}
+
+// VkFormat values.
+static std::optional<Texture::CompressedFormat> getVkFormat(u32 vkFormat) {
+    switch (vkFormat) {
+        case 131: case 132: case 133: case 134: { return Texture::CompressedFormat::BC1; }
+        case 135: case 136: { return Texture::CompressedFormat::BC2; }
+        case 137: case 138: { return Texture::CompressedFormat::BC3; }
+        case 139: { return Texture::CompressedFormat::BC4; }
+        case 141: { return Texture::CompressedFormat::BC5; }
+        case 144: { return Texture::CompressedFormat::BC6; }
+        case 145: case 146: { return Texture::CompressedFormat::BC7; }
+        default: { return std::nullopt; }
+    }
+}
+
+static size_t getLevelSize(int width, int height, Texture::CompressedFormat fmt) {
+    return (size_t)((width + 3) / 4) * ((height + 3) / 4) * Texture::getBytesPerBlock(fmt);
+}
+
+void TextureFile::readDds(const FilePath& path) {
+    static constexpr size_t HEADER_OFFSET = 4;
+    static constexpr size_t PIXEL_FORMAT_OFFSET = HEADER_OFFSET + 72;
+    static constexpr size_t DX10_HEADER_OFFSET = HEADER_OFFSET + 124;
+
+    static constexpr u32 FLAG_MIPMAP_COUNT = 0x20000;
+    static constexpr u32 PIXEL_FORMAT_FLAG_FOURCC = 0x4;
+    static constexpr u32 CAPS2_CUBEMAP = 0x200;
+    static constexpr u32 CAPS2_VOLUME = 0x200000;
+    static constexpr u32 DX10_DIMENSION_TEXTURE2D = 3;
+    static constexpr u32 DX10_MISC_TEXTURECUBE = 0x4;
+
+    const byte* data = file.getData();
+    size_t size = file.getSize();
+
+    PGE_ASSERT(read<u32>(data, size, HEADER_OFFSET) == 124, "Invalid DDS header size (file: \"" + path.str() + "\")");
+    u32 flags = read<u32>(data, size, HEADER_OFFSET + 4);
+    int height = (int)read<u32>(data, size, HEADER_OFFSET + 8);
+    int width = (int)read<u32>(data, size, HEADER_OFFSET + 12);
+    u32 mipmapCount = (flags & FLAG_MIPMAP_COUNT) != 0 ? read<u32>(data, size, HEADER_OFFSET + 24) : 1;
+    u32 caps2 = read<u32>(data, size, HEADER_OFFSET + 108);
+    PGE_ASSERT((caps2 & (CAPS2_CUBEMAP | CAPS2_VOLUME)) == 0, "DDS cube maps and volumes are not supported (file: \"" + path.str() + "\")");
+
+    u32 pixelFormatFlags = read<u32>(data, size, PIXEL_FORMAT_OFFSET + 4);
+    PGE_ASSERT((pixelFormatFlags & PIXEL_FORMAT_FLAG_FOURCC) != 0, "DDS file is not block compressed (file: \"" + path.str() + "\")");
+    u32 code = read<u32>(data, size, PIXEL_FORMAT_OFFSET + 8);
+
+    std::optional<Texture::CompressedFormat> fmt;
+    size_t dataOffset;
+    if (code == fourCC("DX10")) {
+        u32 dxgiFormat = read<u32>(data, size, DX10_HEADER_OFFSET);
+        PGE_ASSERT(read<u32>(data, size, DX10_HEADER_OFFSET + 4) == DX10_DIMENSION_TEXTURE2D
+            && (read<u32>(data, size, DX10_HEADER_OFFSET + 8) & DX10_MISC_TEXTURECUBE) == 0
+            && read<u32>(data, size, DX10_HEADER_OFFSET + 12) <= 1,
+            "Only single 2D DDS textures are supported (file: \"" + path.str() + "\")");
+        fmt = getDxgiFormat(dxgiFormat);
+        PGE_ASSERT(fmt.has_value(), "Unsupported DXGI format (file: \"" + path.str() + "\"; format: " + String::from(dxgiFormat) + ")");
+        dataOffset = DX10_HEADER_OFFSET + 20;
+    } else {
+        fmt = getDdsFourCCFormat(code);
+        PGE_ASSERT(fmt.has_value(), "Unsupported DDS FourCC (file: \"" + path.str() + "\"; FourCC: " + String::from(code) + ")");
+        dataOffset = DX10_HEADER_OFFSET;
+    }
+    format = *fmt;
+
+    PGE_ASSERT(width > 0 && height > 0, "Invalid DDS dimensions (file: \"" + path.str() + "\")");
+    // Nothing is smaller than 1x1.
+    int maxLevels = 1;
+    while (std::max(width, height) >> maxLevels > 0) { maxLevels++; }
+    PGE_ASSERT(mipmapCount <= (u32)maxLevels, "DDS file has more levels than its dimensions allow (file: \"" + path.str() + "\")");
+
+    // The levels are stored back to back, largest first.
+    size_t offset = dataOffset;
+    for (int i = 0; i < (int)std::max(mipmapCount, 1u); i++) {
+        int levelWidth = std::max(1, width >> i);
+        int levelHeight = std::max(1, height >> i);
+        size_t levelSize = getLevelSize(levelWidth, levelHeight, format);
+        PGE_ASSERT(offset <= size && levelSize <= size - offset, "DDS file is truncated (file: \"" + path.str() + "\")");
+        mipmaps.emplace_back(levelWidth, levelHeight, data + offset, levelSize);
+        offset += levelSize;
+    }
+}
+
+void TextureFile::readKtx2(const FilePath& path) {
+    static constexpr size_t HEADER_OFFSET = sizeof(KTX2_IDENTIFIER);
+    static constexpr size_t LEVEL_INDEX_OFFSET = HEADER_OFFSET + 68;
+    static constexpr size_t LEVEL_INDEX_ENTRY_SIZE = 24;
+
+    const byte* data = file.getData();
+    size_t size = file.getSize();
+
+    u32 vkFormat = read<u32>(data, size, HEADER_OFFSET);
+    int width = (int)read<u32>(data, size, HEADER_OFFSET + 8);
+    int height = (int)read<u32>(data, size, HEADER_OFFSET + 12);
+    u32 depth = read<u32>(data, size, HEADER_OFFSET + 16);
+    u32 layerCount = read<u32>(data, size, HEADER_OFFSET + 20);
+    u32 faceCount = read<u32>(data, size, HEADER_OFFSET + 24);
+    // 0 asks for the levels to be generated, only the largest one is stored then.
+    u32 levelCount = std::max(read<u32>(data, size, HEADER_OFFSET + 28), 1u);
+    u32 supercompression = read<u32>(data, size, HEADER_OFFSET + 32);
+
+    PGE_ASSERT(depth == 0 && layerCount <= 1 && faceCount == 1, "Only single 2D KTX2 textures are supported (file: \"" + path.str() + "\")");
+    PGE_ASSERT(supercompression == 0, "Supercompressed KTX2 files are not supported (file: \"" + path.str() + "\")");
+    std::optional<Texture::CompressedFormat> fmt = getVkFormat(vkFormat);
+    PGE_ASSERT(fmt.has_value(), "Unsupported Vulkan format (file: \"" + path.str() + "\"; format: " + String::from(vkFormat) + ")");
+    format = *fmt;
+
+    PGE_ASSERT(width > 0 && height > 0, "Invalid KTX2 dimensions (file: \"" + path.str() + "\")");
+    int maxLevels = 1;
+    while (std::max(width, height) >> maxLevels > 0) { maxLevels++; }
+    PGE_ASSERT(levelCount <= (u32)maxLevels, "KTX2 file has more levels than its dimensions allow (file: \"" + path.str() + "\")");
+
+    // Unlike DDS, every level has its own offset, and they're usually stored smallest first.
+    for (int i = 0; i < (int)levelCount; i++) {
+        size_t entry = LEVEL_INDEX_OFFSET + i * LEVEL_INDEX_ENTRY_SIZE;
+        u64 offset = read<u64>(data, size, entry);
+        u64 length = read<u64>(data, size, entry + 8);
+        int levelWidth = std::max(1, width >> i);
+        int levelHeight = std::max(1, height >> i);
+        PGE_ASSERT(length == getLevelSize(levelWidth, levelHeight, format), "KTX2 level size doesn't match its dimensions (file: \"" + path.str() + "\"; level: " + String::from(i) + ")");
+        PGE_ASSERT(offset <= size && length <= size - offset, "KTX2 file is truncated (file: \"" + path.str() + "\")");
+        mipmaps.emplace_back(levelWidth, levelHeight, data + offset, (size_t)length);
+    }
+}
+
+Texture::CompressedFormat TextureFile::getFormat() const {
+    return format;
+}
+
+const std::vector<Texture::Mipmap>& TextureFile::getMipmaps() const {
+    return mipmaps;
+}
+
+int TextureFile::getWidth() const {
+    return mipmaps[0].width;
+}
+
+int TextureFile::getHeight() const {
+    return mipmaps[0].height;
+}
+
+Texture* TextureFile::load(Graphics& gfx) const {
+    return Texture::loadCompressed(gfx, mipmaps, format);
+}
@@ -1,5 +1,6 @@
 #include "../GraphicsOGL3.h"
 #include <stdlib.h>
+#include <string.h>
 
 using namespace PGE;
 
@@ -16,7 +17,8 @@ static int getCompressedFormat(Texture::CompressedFormat fmt) {
     }
 }
 
-static void textureImage(int width, int height, const byte* buffer, Texture::Format fmt) {
+// With a pixel unpack buffer bound, data is an offset into it.
+static void textureImage(int level, int width, int height, const void* data, Texture::Format fmt) {
     GLint glInternalFormat;
     GLenum glFormat;
     GLenum glPixelType;
@@ -46,7 +48,7 @@ static void textureImage(int width, int height, const byte* buffer, Texture::For
         }
     }
 
-    glTexImage2D(GL_TEXTURE_2D, 0, glInternalFormat, width, height, 0, glFormat, glPixelType, buffer);
+    glTexImage2D(GL_TEXTURE_2D, level, glInternalFormat, width, height, 0, glFormat, glPixelType, data);
     GLenum glError = glGetError();
     PGE_ASSERT(glError == GL_NO_ERROR, "Failed to create texture (" + String::from(width) + "x" + String::from(height) + "; GLERROR: " + String::from(glError) + ")");
 }
@@ -59,10 +61,11 @@ static void applyTextureParameters(bool rt) {
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY, rt ? 1.f : 4.f);
 }
 
-TextureOGL3::TextureOGL3(Graphics& gfx, int w, int h, Format fmt) : Texture(w, h, true, fmt), resourceManager(gfx) {
-    ((GraphicsOGL3&)gfx).takeGlContext();
-    glTexture = resourceManager.addNewResource<GLTexture>();
-    textureImage(w, h, nullptr, fmt);
+TextureOGL3::TextureOGL3(Graphics& gfx, int w, int h, Format fmt) : Texture(w, h, true, fmt), graphics((GraphicsOGL3&)gfx), resourceManager(gfx) {
+    graphics.takeGlContext();
+    mipmaps = false;
+    glTexture = resourceManager.addNewResource<GLTexture>(graphics.getGlState());
+    textureImage(0, w, h, nullptr, fmt);
     applyTextureParameters(true);
     /*glGenFramebuffers(1,&glFramebuffer);
     glBindFramebuffer(GL_FRAMEBUFFER,glFramebuffer);*/
@@ -70,17 +73,30 @@ TextureOGL3::TextureOGL3(Graphics& gfx, int w, int h, Format fmt) : Texture(w, h
     //glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, glDepthbuffer);
 }
 
-TextureOGL3::TextureOGL3(Graphics& gfx, int w, int h, const byte* buffer, Format fmt, bool mipmaps) : Texture(w, h, false, fmt), resourceManager(gfx) {
-    ((GraphicsOGL3&)gfx).takeGlContext();
-    glTexture = resourceManager.addNewResource<GLTexture>();
-    textureImage(w, h, buffer, fmt);
+TextureOGL3::TextureOGL3(Graphics& gfx, int w, int h, const byte* buffer, Format fmt, bool mipmaps) : Texture(w, h, false, fmt), graphics((GraphicsOGL3&)gfx), resourceManager(gfx) {
+    graphics.takeGlContext();
+    this->mipmaps = mipmaps;
+    glTexture = resourceManager.addNewResource<GLTexture>(graphics.getGlState());
+    textureImage(0, w, h, buffer, fmt);
     if (mipmaps) { glGenerateMipmap(GL_TEXTURE_2D); }
     applyTextureParameters(false);
 }
 
-TextureOGL3::TextureOGL3(Graphics& gfx, const std::vector<Mipmap>& mipmaps, CompressedFormat fmt) : Texture(mipmaps[0].width, mipmaps[0].height, false, fmt), resourceManager(gfx) {
-    ((GraphicsOGL3&)gfx).takeGlContext();
-    glTexture = resourceManager.addNewResource<GLTexture>();
+TextureOGL3::TextureOGL3(Graphics& gfx, const std::vector<Mipmap>& mipmaps, Format fmt) : Texture(mipmaps[0].width, mipmaps[0].height, false, fmt), graphics((GraphicsOGL3&)gfx), resourceManager(gfx) {
+    graphics.takeGlContext();
+    this->mipmaps = mipmaps.size() > 1;
+    glTexture = resourceManager.addNewResource<GLTexture>(graphics.getGlState());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)(mipmaps.size() - 1));
+    for (int i = 0; i < (int)mipmaps.size(); i++) {
+        textureImage(i, mipmaps[i].width, mipmaps[i].height, mipmaps[i].buffer, fmt);
+    }
+    applyTextureParameters(false);
+}
+
+TextureOGL3::TextureOGL3(Graphics& gfx, const std::vector<Mipmap>& mipmaps, CompressedFormat fmt) : Texture(mipmaps[0].width, mipmaps[0].height, false, fmt), graphics((GraphicsOGL3&)gfx), resourceManager(gfx) {
+    graphics.takeGlContext();
+    this->mipmaps = mipmaps.size() > 1;
+    glTexture = resourceManager.addNewResource<GLTexture>(graphics.getGlState());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)(mipmaps.size() - 1));
     for (int i = 0; i < mipmaps.size(); i++) {
         glCompressedTexImage2D(GL_TEXTURE_2D, i, getCompressedFormat(fmt),
@@ -89,6 +105,115 @@ TextureOGL3::TextureOGL3(Graphics& gfx, const std::vector<Mipmap>& mipmaps, Comp
     applyTextureParameters(false);
 }
 
+TextureOGL3::TextureOGL3(Graphics& gfx, const std::vector<Mipmap>& mipmaps, const AnyFormat& fmt) : Texture(mipmaps[0].width, mipmaps[0].height, false, fmt), graphics((GraphicsOGL3&)gfx), resourceManager(gfx) {
+    graphics.takeGlContext();
+    this->mipmaps = mipmaps.size() > 1;
+    glTexture = resourceManager.addNewResource<GLTexture>(graphics.getGlState());
+    applyTextureParameters(false);
+    // Past the last level, so the texture is incomplete until the first upload.
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, (GLint)mipmaps.size());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)(mipmaps.size() - 1));
+
+    asyncUpload = std::make_unique<AsyncUpload>();
+    size_t totalSize = 0;
+    for (const Mipmap& mipmap : mipmaps) {
+        asyncUpload->levels.push_back({ mipmap.width, mipmap.height, totalSize, mipmap.size });
+        // Offsets into an unpack buffer must be multiples of the pixel type's size, which is at most 4.
+        // Rows within a level are tightly packed, as the context's unpack alignment is 1.
+        totalSize += (mipmap.size + 3) & ~(size_t)3;
+    }
+    asyncUpload->nextLevel = (int)mipmaps.size() - 1;
+
+    GLStateOGL3& glState = graphics.getGlState();
+    asyncUpload->stagingBuffer = resourceManager.addNewResource<GLBuffer>(glState);
+    glState.bindBuffer(GL_PIXEL_UNPACK_BUFFER, asyncUpload->stagingBuffer);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)totalSize, nullptr, GL_STREAM_DRAW);
+    byte* staging = (byte*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)totalSize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    PGE_ASSERT(staging != nullptr, "Failed to map texture staging buffer (GLERROR: " + String::from(glGetError()) + ")");
+    for (int i = 0; i < (int)mipmaps.size(); i++) {
+        memcpy(staging + asyncUpload->levels[i].offset, mipmaps[i].buffer, mipmaps[i].size);
+    }
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    // Otherwise regular texture uploads would read from it.
+    glState.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    uploadStatus = UploadStatus::PENDING;
+    graphics.queueTextureUpload(*this);
+}
+
+TextureOGL3::~TextureOGL3() {
+    if (asyncUpload == nullptr) { return; }
+    graphics.cancelTextureUpload(*this);
+    if (asyncUpload->fence != nullptr) {
+        graphics.takeGlContext();
+        glDeleteSync(asyncUpload->fence);
+    }
+}
+
+Texture* TextureOGL3::createAsync(Graphics& gfx, const std::vector<Mipmap>& mipmaps, const AnyFormat& fmt) {
+    return new TextureOGL3(gfx, mipmaps, fmt);
+}
+
+Texture::UploadStatus TextureOGL3::getUploadStatus() const {
+    return uploadStatus;
+}
+
+bool TextureOGL3::hasLevelsToUpload() const {
+    return asyncUpload != nullptr && asyncUpload->nextLevel >= 0;
+}
+
+int TextureOGL3::uploadNextLevel() {
+    const StagedLevel& level = asyncUpload->levels[asyncUpload->nextLevel];
+
+    GLStateOGL3& glState = graphics.getGlState();
+    glState.bindTextureForEditing(glTexture);
+    glState.bindBuffer(GL_PIXEL_UNPACK_BUFFER, asyncUpload->stagingBuffer);
+    const void* data = (const void*)level.offset;
+    if (std::holds_alternative<CompressedFormat>(format)) {
+        glCompressedTexImage2D(GL_TEXTURE_2D, asyncUpload->nextLevel, getCompressedFormat(std::get<CompressedFormat>(format)),
+            level.width, level.height, 0, (GLsizei)level.size, data);
+    } else {
+        textureImage(asyncUpload->nextLevel, level.width, level.height, data, std::get<Format>(format));
+    }
+    glState.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    // Sampling stays limited to the levels uploaded so far.
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, asyncUpload->nextLevel);
+    uploadStatus = UploadStatus::PARTIAL;
+
+    if (asyncUpload->nextLevel == 0) {
+        asyncUpload->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    asyncUpload->nextLevel--;
+    return (int)level.size;
+}
+
+bool TextureOGL3::finishUpload() {
+    if (asyncUpload == nullptr) { return true; }
+    if (hasLevelsToUpload()) { return false; }
+
+    GLenum result = glClientWaitSync(asyncUpload->fence, 0, 0);
+    if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) { return false; }
+
+    glDeleteSync(asyncUpload->fence);
+    resourceManager.deleteResource(asyncUpload->stagingBuffer);
+    asyncUpload.reset();
+    uploadStatus = UploadStatus::COMPLETE;
+    return true;
+}
+
+bool TextureOGL3::reload(const std::vector<byte>& buffer) {
+    if (isRT || !std::holds_alternative<Format>(format) || asyncUpload != nullptr) { return false; }
+    Format fmt = std::get<Format>(format);
+    if (buffer.size() != (size_t)dimensions.x * dimensions.y * getBytesPerPixel(fmt)) { return false; }
+
+    graphics.takeGlContext();
+    graphics.getGlState().bindTextureForEditing(glTexture);
+    // Same name, so materials referencing this texture pick up the new contents.
+    textureImage(0, dimensions.x, dimensions.y, buffer.data(), fmt);
+    if (mipmaps) { glGenerateMipmap(GL_TEXTURE_2D); }
+    return true;
+}
+
 GLuint TextureOGL3::getGlTexture() const {
     return glTexture;
 }
@@ -3,31 +3,77 @@
 
 #include <PGE/Graphics/Texture.h>
 
+#include <memory>
+
 #include "../../ResourceManagement/OGL3.h"
 #include "../../ResourceManagement/ResourceManagerOGL3.h"
 
 namespace PGE {
 
+class GraphicsOGL3;
 class TextureOGL3 : public Texture {
     public:
         // Render target.
         TextureOGL3(Graphics& gfx, int w, int h, Format fmt);
         // Loaded texture.
         TextureOGL3(Graphics& gfx, int w, int h, const byte* buffer, Format fmt, bool mipmaps);
+        // Loaded texture with all levels provided.
+        TextureOGL3(Graphics& gfx, const std::vector<Mipmap>& mipmaps, Format fmt);
         // Loaded, compressed texture.
         TextureOGL3(Graphics& gfx, const std::vector<Mipmap>& mipmaps, CompressedFormat fmt);
+        ~TextureOGL3();
+
+        // Stages the levels for GraphicsOGL3 to upload over the following updates.
+        static Texture* createAsync(Graphics& gfx, const std::vector<Mipmap>& mipmaps, const AnyFormat& fmt);
 
         GLuint getGlTexture() const;
         //GLuint getGlFramebuffer() const;
         GLuint getGlDepthbuffer() const;
         void* getNative() const override;
 
+        /// Replaces the contents of a loaded, uncompressed texture.
+        /// The buffer must match the texture's dimensions and format, and no asynchronous upload may be in progress.
+        bool reload(const std::vector<byte>& buffer);
+
+        UploadStatus getUploadStatus() const override;
+        bool hasLevelsToUpload() const;
+        /// Uploads the smallest level that isn't uploaded yet from the staging buffer.
+        /// @returns The size of the level in bytes.
+        int uploadNextLevel();
+        /// Frees the staging buffer once the GPU is done copying from it.
+        /// @returns Whether the upload is complete.
+        bool finishUpload();
+
     private:
+        GraphicsOGL3& graphics;
+        bool mipmaps;
+
         GLTexture::View glTexture;
         //GLuint glFramebuffer;
         GLDepthBuffer::View glDepthbuffer;
 
         ResourceManagerOGL3 resourceManager;
+
+        TextureOGL3(Graphics& gfx, const std::vector<Mipmap>& mipmaps, const AnyFormat& fmt);
+
+        struct StagedLevel {
+            int width;
+            int height;
+            // Within the staging buffer.
+            size_t offset;
+            size_t size;
+        };
+        // Only exists while an asynchronous upload is in progress.
+        struct AsyncUpload {
+            GLBuffer::View stagingBuffer;
+            std::vector<StagedLevel> levels;
+            // Counts down, the smallest level is uploaded first.
+            int nextLevel;
+            // Inserted after the last level, signaled once the GPU copied everything.
+            GLsync fence = nullptr;
+        };
+        std::unique_ptr<AsyncUpload> asyncUpload;
+        UploadStatus uploadStatus = UploadStatus::COMPLETE;
 };
 
 }
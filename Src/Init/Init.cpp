@@ -18,9 +18,9 @@ using namespace PGE;
 
 #ifndef DEBUG
 static void showError(const String& exceptionType, const String& what) {
-    TextWriter writer = TextWriter(FilePath::fromStr("exception.txt"));
+    TextWriter writer(FilePath::fromStr("exception.txt"));
     writer.writeLine(Info::REPO_LINK);
-    writer.writeLine(Info::BRANCH + " - " + Info::COMMIT);
+    writer.writeLine(Info::BRANCH, " - ", Info::COMMIT);
     writer.writeLine(exceptionType);
     writer.writeLine(what);
     SDL_ShowSimpleMessageBox(SDL_MessageBoxFlags::SDL_MESSAGEBOX_ERROR, "Fatal Error",
@@ -0,0 +1,65 @@
+#include <PGE/Math/Frustum.h>
+
+#include <algorithm>
+
+#include "SIMD.h"
+#include "../Threading/Parallel.h"
+
+using namespace PGE;
+
+// Each thread gets at least this many words of 64 boxes, below that spinning up threads costs more than it saves.
+static constexpr int PARALLEL_RANGE_WORDS = 64;
+
+void Frustum::cull(const std::vector<AABBox>& boxes, std::vector<u64>& visible, bool allowParallel) const {
+    int count = (int)boxes.size();
+    int wordCount = (count + 63) / 64;
+    visible.assign(wordCount, 0);
+    if (wordCount == 0) { return; }
+
+    // Tested in center-extent form: a box is outside a plane if its center is further below it
+    // than the box extends towards the plane's normal.
+    SIMD::Float4 normals[PLANE_COUNT][3];
+    SIMD::Float4 absNormals[PLANE_COUNT][3];
+    SIMD::Float4 distances[PLANE_COUNT];
+    for (int p = 0; p < PLANE_COUNT; p++) {
+        const Vector3f& n = planes[p].normal;
+        normals[p][0] = SIMD::set(n.x); normals[p][1] = SIMD::set(n.y); normals[p][2] = SIMD::set(n.z);
+        absNormals[p][0] = SIMD::set(std::abs(n.x)); absNormals[p][1] = SIMD::set(std::abs(n.y)); absNormals[p][2] = SIMD::set(std::abs(n.z));
+        distances[p] = SIMD::set(planes[p].distanceFromOrigin);
+    }
+
+    // Threads are split by whole words, so that no two write to the same one.
+    Parallel::forRange(wordCount, allowParallel ? PARALLEL_RANGE_WORDS : wordCount, [&](int begin, int end) {
+        for (int w = begin; w < end; w++) {
+            int first = w * 64;
+            int last = std::min(first + 64, count);
+            u64 word = 0;
+            for (int i = first; i < last; i += 4) {
+                int lanes = std::min(4, last - i);
+                // Transposed to one array per component, the lanes past the last box repeat it.
+                float centers[3][4];
+                float halfDims[3][4];
+                for (int l = 0; l < 4; l++) {
+                    const AABBox& box = boxes[i + std::min(l, lanes - 1)];
+                    Vector3f center = box.getCenter();
+                    Vector3f halfDim = box.getDims() * 0.5f;
+                    centers[0][l] = center.x; centers[1][l] = center.y; centers[2][l] = center.z;
+                    halfDims[0][l] = halfDim.x; halfDims[1][l] = halfDim.y; halfDims[2][l] = halfDim.z;
+                }
+                SIMD::Float4 cx = SIMD::load(centers[0]), cy = SIMD::load(centers[1]), cz = SIMD::load(centers[2]);
+                SIMD::Float4 hx = SIMD::load(halfDims[0]), hy = SIMD::load(halfDims[1]), hz = SIMD::load(halfDims[2]);
+
+                int outside = 0;
+                for (int p = 0; p < PLANE_COUNT; p++) {
+                    SIMD::Float4 dot = SIMD::madd(normals[p][0], cx, SIMD::madd(normals[p][1], cy, SIMD::mul(normals[p][2], cz)));
+                    SIMD::Float4 extent = SIMD::madd(absNormals[p][0], hx, SIMD::madd(absNormals[p][1], hy, SIMD::mul(absNormals[p][2], hz)));
+                    // dot - distance < -extent
+                    outside |= SIMD::mask(SIMD::greater(distances[p], SIMD::add(dot, extent)));
+                }
+                u64 inside = (u64)(~outside & ((1 << lanes) - 1));
+                word |= inside << (i - first);
+            }
+            visible[w] = word;
+        }
+    });
+}
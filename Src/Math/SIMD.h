@@ -0,0 +1,81 @@
+#ifndef PGEINTERNAL_SIMD_H_INCLUDED
+#define PGEINTERNAL_SIMD_H_INCLUDED
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PGE_SIMD_SSE2
+#include <emmintrin.h>
+#else
+#include <cmath>
+#endif
+
+namespace PGE {
+
+// Thin wrapper around 4-wide float vectors.
+// Falls back to plain loops on platforms without SSE2, which compilers can usually still vectorize.
+namespace SIMD {
+#ifdef PGE_SIMD_SSE2
+    using Float4 = __m128;
+
+    inline Float4 load(const float* ptr) { return _mm_loadu_ps(ptr); }
+    inline void store(float* ptr, Float4 v) { _mm_storeu_ps(ptr, v); }
+    inline Float4 set(float f) { return _mm_set1_ps(f); }
+
+    inline Float4 add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+    inline Float4 sub(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+    inline Float4 mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+    inline Float4 div(Float4 a, Float4 b) { return _mm_div_ps(a, b); }
+    inline Float4 min(Float4 a, Float4 b) { return _mm_min_ps(a, b); }
+    inline Float4 max(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+    inline Float4 sqrt(Float4 a) { return _mm_sqrt_ps(a); }
+    // a * b + c
+    inline Float4 madd(Float4 a, Float4 b, Float4 c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    // Lanes where a > b are all ones.
+    inline Float4 greater(Float4 a, Float4 b) { return _mm_cmpgt_ps(a, b); }
+    // Picks a where the mask is set, b otherwise.
+    inline Float4 select(Float4 mask, Float4 a, Float4 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+    // One bit per lane.
+    inline int mask(Float4 a) { return _mm_movemask_ps(a); }
+#else
+    struct Float4 { float v[4]; };
+
+    inline Float4 load(const float* ptr) { return Float4{ { ptr[0], ptr[1], ptr[2], ptr[3] } }; }
+    inline void store(float* ptr, Float4 v) { for (int i = 0; i < 4; i++) { ptr[i] = v.v[i]; } }
+    inline Float4 set(float f) { return Float4{ { f, f, f, f } }; }
+
+#define PGE_SIMD_LANEWISE(EXPR) Float4 r; for (int i = 0; i < 4; i++) { r.v[i] = EXPR; } return r
+    inline Float4 add(Float4 a, Float4 b) { PGE_SIMD_LANEWISE(a.v[i] + b.v[i]); }
+    inline Float4 sub(Float4 a, Float4 b) { PGE_SIMD_LANEWISE(a.v[i] - b.v[i]); }
+    inline Float4 mul(Float4 a, Float4 b) { PGE_SIMD_LANEWISE(a.v[i] * b.v[i]); }
+    inline Float4 div(Float4 a, Float4 b) { PGE_SIMD_LANEWISE(a.v[i] / b.v[i]); }
+    inline Float4 min(Float4 a, Float4 b) { PGE_SIMD_LANEWISE(a.v[i] < b.v[i] ? a.v[i] : b.v[i]); }
+    inline Float4 max(Float4 a, Float4 b) { PGE_SIMD_LANEWISE(a.v[i] > b.v[i] ? a.v[i] : b.v[i]); }
+    inline Float4 sqrt(Float4 a) { PGE_SIMD_LANEWISE(std::sqrt(a.v[i])); }
+    inline Float4 madd(Float4 a, Float4 b, Float4 c) { PGE_SIMD_LANEWISE(a.v[i] * b.v[i] + c.v[i]); }
+    inline Float4 greater(Float4 a, Float4 b) { PGE_SIMD_LANEWISE(a.v[i] > b.v[i] ? 1.f : 0.f); }
+    inline Float4 select(Float4 mask, Float4 a, Float4 b) { PGE_SIMD_LANEWISE(mask.v[i] != 0.f ? a.v[i] : b.v[i]); }
+#undef PGE_SIMD_LANEWISE
+    inline int mask(Float4 a) {
+        int ret = 0;
+        for (int i = 0; i < 4; i++) { if (a.v[i] != 0.f) { ret |= 1 << i; } }
+        return ret;
+    }
+#endif
+
+    inline float horizontalMin(Float4 v) {
+        float f[4]; store(f, v);
+        float a = f[0] < f[1] ? f[0] : f[1];
+        float b = f[2] < f[3] ? f[2] : f[3];
+        return a < b ? a : b;
+    }
+
+    inline float horizontalMax(Float4 v) {
+        float f[4]; store(f, v);
+        float a = f[0] > f[1] ? f[0] : f[1];
+        float b = f[2] > f[3] ? f[2] : f[3];
+        return a > b ? a : b;
+    }
+}
+
+}
+
+#endif // PGEINTERNAL_SIMD_H_INCLUDED
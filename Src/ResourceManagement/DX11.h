@@ -105,15 +105,20 @@ class D3D11Texture2D : public DX11Resource<ID3D11Texture2D*> {
             NO_MIPMAPS,
             NORMAL,
             COMPRESSED,
+            // Uncompressed, with the levels provided up front.
+            PRESET_MIPMAPS,
         };
         
-        D3D11Texture2D(ID3D11Device* device, Type type, int width, int height, DXGI_FORMAT format) {
+        // A mipLevels of 0 allocates the full chain.
+        D3D11Texture2D(ID3D11Device* device, Type type, int width, int height, DXGI_FORMAT format, int mipLevels = 0) {
             D3D11_TEXTURE2D_DESC textureDesc;
             ZeroMemory(&textureDesc, sizeof(textureDesc));
             textureDesc.Width = (UINT)width;
             textureDesc.Height = (UINT)height;
             if (type == Type::DEPTH_STENCIL || type == Type::NO_MIPMAPS) {
                 textureDesc.MipLevels = 1;
+            } else {
+                textureDesc.MipLevels = (UINT)mipLevels;
             }
             textureDesc.ArraySize = 1;
             textureDesc.Format = format;
@@ -123,7 +128,7 @@ class D3D11Texture2D : public DX11Resource<ID3D11Texture2D*> {
                 textureDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
             } else {
                 textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-                if (type != Type::COMPRESSED) {
+                if (type != Type::COMPRESSED && type != Type::PRESET_MIPMAPS) {
                     textureDesc.BindFlags |= D3D11_BIND_RENDER_TARGET;
                 }
             }
@@ -8,6 +8,8 @@
 
 #include <PGE/ResourceManagement/ResourceManager.h>
 
+#include "../Graphics/GLStateOGL3.h"
+
 namespace PGE {
 
 class GLContext : public Resource<SDL_GLContext> {
@@ -24,50 +26,66 @@ class GLContext : public Resource<SDL_GLContext> {
 };
 
 class GLFramebuffer : public Resource<GLuint> {
+    private:
+        GLStateOGL3& glState;
+
     public:
-        GLFramebuffer() {
+        GLFramebuffer(GLStateOGL3& state) : glState(state) {
             glGenFramebuffers(1, &resource);
             GLenum glError = glGetError();
             PGE_ASSERT(glError == GL_NO_ERROR, "Failed to generate frame buffer (GLERROR: " + String::from(glError) + ")");
         }
         
         ~GLFramebuffer() {
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glState.bindFramebuffer(0);
+            glState.forgetFramebuffer(resource);
             glDeleteFramebuffers(1, &resource);
         }
 };
 
 class GLBuffer : public Resource<GLuint> {
+    private:
+        GLStateOGL3& glState;
+
     public:
-        GLBuffer() {
+        GLBuffer(GLStateOGL3& state) : glState(state) {
             glGenBuffers(1, &resource);
         }
 
         ~GLBuffer() {
+            glState.forgetBuffer(resource);
             glDeleteBuffers(1, &resource);
         }
 };
 
 class GLVertexArray : public Resource<GLuint> {
+    private:
+        GLStateOGL3& glState;
+
     public:
-        GLVertexArray() {
+        GLVertexArray(GLStateOGL3& state) : glState(state) {
             glGenVertexArrays(1, &resource);
         }
 
         ~GLVertexArray() {
+            glState.forgetVertexArray(resource);
             glDeleteVertexArrays(1, &resource);
         }
 };
 
 class GLTexture : public Resource<GLuint> {
+    private:
+        GLStateOGL3& glState;
+
     public:
-        GLTexture() {
+        // Leaves the texture bound to unit 0, for the caller to fill in.
+        GLTexture(GLStateOGL3& state) : glState(state) {
             glGenTextures(1, &resource);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, resource);
+            glState.bindTextureForEditing(resource);
         }
 
         ~GLTexture() {
+            glState.forgetTexture(resource);
             glDeleteTextures(1, &resource);
         }
 };
@@ -110,8 +128,11 @@ class GLShader : public Resource<GLuint> {
 };
 
 class GLProgram : public Resource<GLuint> {
+    private:
+        GLStateOGL3& glState;
+
     public:
-        GLProgram(const std::vector<GLuint>& shaders) {
+        GLProgram(GLStateOGL3& state, const std::vector<GLuint>& shaders) : glState(state) {
             resource = glCreateProgram();
             for (GLuint s : shaders) {
                 glAttachShader(resource, s);
@@ -123,6 +144,7 @@ class GLProgram : public Resource<GLuint> {
         }
 
         ~GLProgram() {
+            glState.forgetProgram(resource);
             glDeleteProgram(resource);
         }
 };
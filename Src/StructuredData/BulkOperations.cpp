@@ -0,0 +1,204 @@
+#include <PGE/StructuredData/StructuredData.h>
+
+#include <mutex>
+
+#include "../Math/SIMD.h"
+#include "../Threading/Parallel.h"
+
+using namespace PGE;
+
+// Elements per transposed block, must be a multiple of 4.
+static constexpr int BLOCK_SIZE = 256;
+// Below this, spinning up threads costs more than it saves.
+static constexpr int PARALLEL_RANGE_SIZE = 16 * 1024;
+
+template <int N>
+using Block = float[N][BLOCK_SIZE];
+
+static constexpr int roundUpToLanes(int count) {
+    return (count + 3) & ~3;
+}
+
+// Transposes count elements into one array per component.
+// The lanes past count are filled with the last element, so that they don't affect reductions.
+template <int N>
+static void gatherBlock(const byte* src, int stride, int count, Block<N>& block) {
+    for (int i = 0; i < count; i++) {
+        float v[N];
+        memcpy(v, src + (size_t)i * stride, sizeof(v));
+        for (int c = 0; c < N; c++) {
+            block[c][i] = v[c];
+        }
+    }
+    for (int i = count; i < roundUpToLanes(count); i++) {
+        for (int c = 0; c < N; c++) {
+            block[c][i] = block[c][count - 1];
+        }
+    }
+}
+
+template <int N>
+static void scatter(byte* dst, int stride, int count, const Block<N>& block) {
+    for (int i = 0; i < count; i++) {
+        float v[N];
+        for (int c = 0; c < N; c++) {
+            v[c] = block[c][i];
+        }
+        memcpy(dst + (size_t)i * stride, v, sizeof(v));
+    }
+}
+
+// Runs kernel(block, laneCount) over every block of a field, in place.
+template <int N, typename Kernel>
+static void forEachBlock(byte* first, int stride, int count, bool allowParallel, const Kernel& kernel) {
+    Parallel::forRange(count, allowParallel ? PARALLEL_RANGE_SIZE : count, [&](int begin, int end) {
+        Block<N> block;
+        for (int i = begin; i < end; i += BLOCK_SIZE) {
+            int blockCount = std::min(BLOCK_SIZE, end - i);
+            byte* blockStart = first + (size_t)i * stride;
+            gatherBlock<N>(blockStart, stride, blockCount, block);
+            kernel(block, roundUpToLanes(blockCount));
+            scatter<N>(blockStart, stride, blockCount, block);
+        }
+    });
+}
+
+static void transformBlock(Block<4>& block, int count, const Matrix4x4f& matrix, bool hasW, float w) {
+    SIMD::Float4 m[4][4];
+    for (int r = 0; r < 4; r++) {
+        for (int c = 0; c < 4; c++) {
+            m[r][c] = SIMD::set(matrix.elements[r][c]);
+        }
+    }
+
+    SIMD::Float4 constantW = SIMD::set(w);
+    int rows = hasW ? 4 : 3;
+    for (int i = 0; i < count; i += 4) {
+        SIMD::Float4 in[4] = {
+            SIMD::load(&block[0][i]),
+            SIMD::load(&block[1][i]),
+            SIMD::load(&block[2][i]),
+            hasW ? SIMD::load(&block[3][i]) : constantW,
+        };
+        for (int r = 0; r < rows; r++) {
+            SIMD::Float4 out = SIMD::mul(in[0], m[r][0]);
+            out = SIMD::madd(in[1], m[r][1], out);
+            out = SIMD::madd(in[2], m[r][2], out);
+            out = SIMD::madd(in[3], m[r][3], out);
+            SIMD::store(&block[r][i], out);
+        }
+    }
+}
+
+static void normalizeBlock(Block<4>& block, int count) {
+    SIMD::Float4 zero = SIMD::set(0.f);
+    for (int i = 0; i < count; i += 4) {
+        SIMD::Float4 x = SIMD::load(&block[0][i]);
+        SIMD::Float4 y = SIMD::load(&block[1][i]);
+        SIMD::Float4 z = SIMD::load(&block[2][i]);
+        SIMD::Float4 length = SIMD::sqrt(SIMD::madd(x, x, SIMD::madd(y, y, SIMD::mul(z, z))));
+        // Zero vectors are left alone.
+        SIMD::Float4 nonZero = SIMD::greater(length, zero);
+        SIMD::store(&block[0][i], SIMD::select(nonZero, SIMD::div(x, length), x));
+        SIMD::store(&block[1][i], SIMD::select(nonZero, SIMD::div(y, length), y));
+        SIMD::store(&block[2][i], SIMD::select(nonZero, SIMD::div(z, length), z));
+    }
+}
+
+void StructuredData::transform(const String::Key& entry, const Matrix4x4f& matrix, bool allowParallel) {
+    const ElemLayout::LocationAndSize& locAndSize = layout.getLocationAndSize(entry);
+    markDirty(0, size);
+    byte* first = data + locAndSize.location;
+    int stride = layout.getElementSize();
+    if (locAndSize.size == sizeof(Vector3f)) {
+        forEachBlock<3>(first, stride, getElementCount(), allowParallel, [&](Block<3>& block, int count) {
+            // The fourth row is computed into scratch space and discarded.
+            Block<4> full;
+            memcpy(full, block, sizeof(block));
+            transformBlock(full, count, matrix, false, 1.f);
+            memcpy(block, full, sizeof(block));
+        });
+    } else if (locAndSize.size == sizeof(Vector4f)) {
+        forEachBlock<4>(first, stride, getElementCount(), allowParallel, [&](Block<4>& block, int count) {
+            transformBlock(block, count, matrix, true, 0.f);
+        });
+    } else {
+        throw PGE_CREATE_EX("Entry \"" + String::hexFromInt(entry.hash) + "\" is neither a Vector3f nor a Vector4f (size " + String::from(locAndSize.size) + ")");
+    }
+}
+
+void StructuredData::transformNormals(const String::Key& entry, const Matrix4x4f& matrix, bool allowParallel) {
+    const ElemLayout::LocationAndSize& locAndSize = layout.getLocationAndSize(entry);
+    markDirty(0, size);
+    PGE_ASSERT(locAndSize.size == sizeof(Vector3f), "Entry \"" + String::hexFromInt(entry.hash) + "\" is not a Vector3f (size " + String::from(locAndSize.size) + ")");
+    forEachBlock<3>(data + locAndSize.location, layout.getElementSize(), getElementCount(), allowParallel, [&](Block<3>& block, int count) {
+        Block<4> full;
+        memcpy(full, block, sizeof(block));
+        transformBlock(full, count, matrix, false, 0.f);
+        normalizeBlock(full, count);
+        memcpy(block, full, sizeof(block));
+    });
+}
+
+void StructuredData::scaleAndOffset(const String::Key& entry, const Vector2f& scale, const Vector2f& offset, bool allowParallel) {
+    const ElemLayout::LocationAndSize& locAndSize = layout.getLocationAndSize(entry);
+    markDirty(0, size);
+    PGE_ASSERT(locAndSize.size == sizeof(Vector2f), "Entry \"" + String::hexFromInt(entry.hash) + "\" is not a Vector2f (size " + String::from(locAndSize.size) + ")");
+    forEachBlock<2>(data + locAndSize.location, layout.getElementSize(), getElementCount(), allowParallel, [&](Block<2>& block, int count) {
+        SIMD::Float4 scaleX = SIMD::set(scale.x);
+        SIMD::Float4 scaleY = SIMD::set(scale.y);
+        SIMD::Float4 offsetX = SIMD::set(offset.x);
+        SIMD::Float4 offsetY = SIMD::set(offset.y);
+        for (int i = 0; i < count; i += 4) {
+            SIMD::store(&block[0][i], SIMD::madd(SIMD::load(&block[0][i]), scaleX, offsetX));
+            SIMD::store(&block[1][i], SIMD::madd(SIMD::load(&block[1][i]), scaleY, offsetY));
+        }
+    });
+}
+
+const AABBox StructuredData::computeBounds(const String::Key& entry, bool allowParallel) const {
+    return computeBounds(entry, 0, getElementCount(), allowParallel);
+}
+
+const AABBox StructuredData::computeBounds(const String::Key& entry, int firstElem, int count, bool allowParallel) const {
+    const ElemLayout::LocationAndSize& locAndSize = layout.getLocationAndSize(entry);
+    PGE_ASSERT(locAndSize.size == sizeof(Vector3f) || locAndSize.size == sizeof(Vector4f),
+        "Entry \"" + String::hexFromInt(entry.hash) + "\" is neither a Vector3f nor a Vector4f (size " + String::from(locAndSize.size) + ")");
+    int stride = layout.getElementSize();
+    assertRange(firstElem, count, stride);
+
+    if (count == 0) { return AABBox(); }
+
+    const byte* first = data + (size_t)firstElem * stride + locAndSize.location;
+
+    Vector3f firstPoint;
+    memcpy(&firstPoint, first, sizeof(Vector3f));
+    AABBox bounds(firstPoint);
+    std::mutex boundsMutex;
+    Parallel::forRange(count, allowParallel ? PARALLEL_RANGE_SIZE : count, [&](int begin, int end) {
+        SIMD::Float4 min[3];
+        SIMD::Float4 max[3];
+        for (int c = 0; c < 3; c++) {
+            min[c] = SIMD::set(((const float*)&firstPoint)[c]);
+            max[c] = min[c];
+        }
+
+        Block<3> block;
+        for (int i = begin; i < end; i += BLOCK_SIZE) {
+            int blockCount = std::min(BLOCK_SIZE, end - i);
+            gatherBlock<3>(first + (size_t)i * stride, stride, blockCount, block);
+            for (int j = 0; j < roundUpToLanes(blockCount); j += 4) {
+                for (int c = 0; c < 3; c++) {
+                    SIMD::Float4 v = SIMD::load(&block[c][j]);
+                    min[c] = SIMD::min(min[c], v);
+                    max[c] = SIMD::max(max[c], v);
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(boundsMutex);
+        bounds.addPoint(Vector3f(SIMD::horizontalMin(min[0]), SIMD::horizontalMin(min[1]), SIMD::horizontalMin(min[2])));
+        bounds.addPoint(Vector3f(SIMD::horizontalMax(max[0]), SIMD::horizontalMax(max[1]), SIMD::horizontalMax(max[2])));
+    });
+    return bounds;
+}
@@ -1,26 +1,148 @@
 #include <PGE/StructuredData/StructuredData.h>
 
+#include <PGE/File/BinaryReader.h>
+#include <PGE/File/BinaryWriter.h>
+#include <PGE/File/MemoryMappedFile.h>
+
+#include <algorithm>
+#include <mutex>
+
 using namespace PGE;
 
-StructuredData::ElemLayout::Entry::Entry(const String& nm, int sz) {
-    name = nm; size = sz;
+// "PGSD"
+static constexpr u32 FILE_MAGIC = 0x44534750;
+static constexpr u32 FILE_VERSION = 2;
+// The data block starts at a multiple of this, relative to the start of the header.
+static constexpr int DATA_ALIGNMENT = 16;
+
+StructuredData::ElemLayout::Entry::Entry(const String& nm, int sz, int arrSz) {
+    name = nm; size = sz; arraySize = arrSz;
 }
 
-StructuredData::ElemLayout::LocationAndSize::LocationAndSize(int loc, int sz) {
-    location = loc; size = sz;
+StructuredData::ElemLayout::LocationAndSize::LocationAndSize(int loc, int sz, int arrStride, int arrSz) {
+    location = loc; size = sz; arrayStride = arrStride; arraySize = arrSz;
 }
 
 bool StructuredData::ElemLayout::LocationAndSize::operator==(const ElemLayout::LocationAndSize& other) const {
-    return location == other.location && size == other.size;
+    return location == other.location && size == other.size && arrayStride == other.arrayStride && arraySize == other.arraySize;
+}
+
+static int roundUp(int value, int alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// The alignment GLSL's block layouts require for a value of the given size.
+// Sizes are all we know about the entries, but they're unambiguous for the types shaders use:
+// scalars, vectors and 4-component column matrices.
+static int getBaseAlignment(int size) {
+    if (size <= 4) { return 4; }
+    if (size <= 8) { return 8; }
+    return 16;
 }
 
-StructuredData::ElemLayout::ElemLayout(const std::vector<Entry>& entrs) {
+// Boost's hash_combine.
+static void combineHash(size_t& seed, size_t value) {
+    seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+bool StructuredData::ElemLayout::Interned::isStructurallyEqual(const Interned& other) const {
+    if (packing != other.packing || orderedEntries.size() != other.orderedEntries.size()) { return false; }
+    for (int i = 0; i < (int)orderedEntries.size(); i++) {
+        const Entry& a = orderedEntries[i];
+        const Entry& b = other.orderedEntries[i];
+        if (a.size != b.size || a.arraySize != b.arraySize || !a.name.equals(b.name)) { return false; }
+    }
+    return true;
+}
+
+std::shared_ptr<const StructuredData::ElemLayout::Interned> StructuredData::ElemLayout::intern(std::unique_ptr<Interned>&& candidate) {
+    // Local, so that layouts can be constructed during static initialization.
+    // Hashes are bucketed, as unrelated layouts may collide.
+    // Entries are weak, so that layouts are freed once nothing uses them anymore.
+    static std::mutex registryMutex;
+    static std::unordered_map<size_t, std::vector<std::weak_ptr<const Interned>>> registry;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::vector<std::weak_ptr<const Interned>>& bucket = registry[candidate->hash];
+    for (auto it = bucket.begin(); it != bucket.end();) {
+        std::shared_ptr<const Interned> existing = it->lock();
+        if (existing == nullptr) {
+            it = bucket.erase(it);
+        } else if (existing->isStructurallyEqual(*candidate)) {
+            return existing;
+        } else {
+            it++;
+        }
+    }
+    std::shared_ptr<const Interned> ret = std::move(candidate);
+    bucket.emplace_back(ret);
+    return ret;
+}
+
+StructuredData::ElemLayout::ElemLayout() {
+    // Shared by all empty layouts, never freed.
+    static const ElemLayout empty(std::vector<Entry>(), Packing::TIGHT);
+    interned = empty.interned;
+}
+
+StructuredData::ElemLayout::ElemLayout(const std::vector<Entry>& entrs, Packing pck) {
+    std::unique_ptr<Interned> candidate = std::make_unique<Interned>();
+    candidate->packing = pck;
+    candidate->hash = std::hash<int>()((int)pck);
     int currLocation = 0;
+    int maxAlignment = 1;
     for (int i = 0; i < entrs.size(); i++) {
-        entries.emplace(entrs[i].name, LocationAndSize(currLocation, entrs[i].size));
-        currLocation += entrs[i].size;
+        const Entry& entry = entrs[i];
+        PGE_ASSERT(entry.arraySize > 0, "Entry \"" + entry.name + "\" has an invalid array size (" + String::from(entry.arraySize) + ")");
+        PGE_ASSERT(pck == Packing::TIGHT || entry.size % 4 == 0,
+            "Entry \"" + entry.name + "\" size must be a multiple of 4 (" + String::from(entry.size) + ")");
+
+        int alignment;
+        int arrayStride;
+        switch (pck) {
+            case Packing::TIGHT: {
+                alignment = 1;
+                arrayStride = entry.size;
+            } break;
+            case Packing::STD140: {
+                alignment = entry.arraySize > 1 ? 16 : getBaseAlignment(entry.size);
+                arrayStride = roundUp(entry.size, 16);
+            } break;
+            case Packing::STD430: {
+                alignment = getBaseAlignment(entry.size);
+                arrayStride = roundUp(entry.size, alignment);
+            } break;
+            case Packing::VERTEX: {
+                alignment = 4;
+                arrayStride = entry.size;
+            } break;
+        }
+
+        currLocation = roundUp(currLocation, alignment);
+        maxAlignment = std::max(maxAlignment, alignment);
+        candidate->entries.emplace(entry.name, LocationAndSize(currLocation, entry.size, arrayStride, entry.arraySize));
+        // Arrays occupy their whole stride, while the padding behind a single value may be used by the next entry.
+        currLocation += entry.arraySize > 1 ? arrayStride * entry.arraySize : entry.size;
+
+        combineHash(candidate->hash, entry.name.getHashCode());
+        combineHash(candidate->hash, (size_t)entry.size);
+        combineHash(candidate->hash, (size_t)entry.arraySize);
     }
-    elementSize = currLocation;
+    if (pck == Packing::STD140) {
+        maxAlignment = 16;
+    }
+    candidate->orderedEntries = entrs;
+    candidate->elementSize = roundUp(currLocation, maxAlignment);
+
+    interned = intern(std::move(candidate));
+}
+
+const std::vector<StructuredData::ElemLayout::Entry>& StructuredData::ElemLayout::getEntries() const {
+    return interned->orderedEntries;
+}
+
+bool StructuredData::ElemLayout::hasEntry(const String::Key& key) const {
+    return interned->entries.find(key) != interned->entries.end();
 }
 
 const StructuredData::ElemLayout::LocationAndSize& StructuredData::ElemLayout::getLocationAndSize(const String& name) const {
@@ -28,52 +150,225 @@ const StructuredData::ElemLayout::LocationAndSize& StructuredData::ElemLayout::g
 }
 
 const StructuredData::ElemLayout::LocationAndSize& StructuredData::ElemLayout::getLocationAndSize(const String::Key& key) const {
-    auto iter = entries.find(key);
-    PGE_ASSERT(iter != entries.end(), "No entry with key \"" + String::hexFromInt(key.hash) + "\"");
+    auto iter = interned->entries.find(key);
+    PGE_ASSERT(iter != interned->entries.end(), "No entry with key \"" + String::hexFromInt(key.hash) + "\"");
     return iter->second;
 }
 
 int StructuredData::ElemLayout::getElementSize() const {
-    return elementSize;
+    return interned->elementSize;
+}
+
+StructuredData::ElemLayout::Packing StructuredData::ElemLayout::getPacking() const {
+    return interned->packing;
+}
+
+size_t StructuredData::ElemLayout::getHash() const {
+    return interned->hash;
 }
 
 bool StructuredData::ElemLayout::operator==(const StructuredData::ElemLayout& other) const {
-    if (this == &other) { return true; }
-    if (elementSize != other.elementSize) { return false; }
-    return entries == other.entries;
+    return interned == other.interned;
+}
+
+bool StructuredData::ElemLayout::operator!=(const StructuredData::ElemLayout& other) const {
+    return interned != other.interned;
+}
+
+const StructuredData::ElemLayout StructuredData::reflectLayout(const std::vector<ReflectedField>& fields, int structSize) {
+    std::vector<ElemLayout::Entry> entries;
+    entries.reserve(fields.size());
+    for (const ReflectedField& field : fields) {
+        entries.emplace_back(field.name, field.size);
+    }
+    ElemLayout ret(entries, ElemLayout::Packing::TIGHT);
+
+    for (const ReflectedField& field : fields) {
+        PGE_ASSERT(ret.getLocationAndSize(String(field.name)).location == field.offset,
+            "Reflected field \"" + String(field.name) + "\" is out of order or preceded by padding (offset: " + String::from(field.offset) + ")");
+    }
+    PGE_ASSERT(ret.getElementSize() == structSize,
+        "Reflected struct has trailing padding or undeclared fields (size: " + String::from(structSize) + "; declared: " + String::from(ret.getElementSize()) + ")");
+    return ret;
 }
 
 StructuredData::StructuredData(const ElemLayout& ly, int elemCount) {
     layout = ly;
     size = (size_t)layout.getElementSize() * elemCount;
-    data = std::make_unique<byte[]>(size);
+    capacity = size;
+    ownedData = std::make_unique<byte[]>(size);
+    data = ownedData.get();
+    markDirty(0, size);
 }
 
 StructuredData::StructuredData(StructuredData&& other) noexcept {
     layout = other.layout;
     size = other.size;
-    data = std::move(other.data);
+    capacity = other.capacity;
+    dirtyBegin = other.dirtyBegin;
+    dirtyEnd = other.dirtyEnd;
+    data = other.data;
+    ownedData = std::move(other.ownedData);
+    externalStorage = std::move(other.externalStorage);
+    other.data = nullptr;
+    other.size = 0;
+    other.capacity = 0;
 }
 
 void StructuredData::operator=(StructuredData&& other) noexcept {
     layout = other.layout;
     size = other.size;
-    data = std::move(other.data);
+    capacity = other.capacity;
+    dirtyBegin = other.dirtyBegin;
+    dirtyEnd = other.dirtyEnd;
+    data = other.data;
+    ownedData = std::move(other.ownedData);
+    externalStorage = std::move(other.externalStorage);
+    other.data = nullptr;
+    other.size = 0;
+    other.capacity = 0;
 }
 
 StructuredData StructuredData::copy() const {
     StructuredData ret;
     ret.layout = layout;
     ret.size = size;
+    ret.capacity = size;
+    ret.markDirty(0, size);
     if (size > 0) {
-        ret.data = std::make_unique<byte[]>(size);
-        memcpy(ret.data.get(), data.get(), size);
+        ret.ownedData = std::make_unique<byte[]>(size);
+        ret.data = ret.ownedData.get();
+        memcpy(ret.data, data, size);
     }
     return ret;
 }
 
+void StructuredData::save(BinaryWriter& writer) const {
+    const std::vector<ElemLayout::Entry>& entries = layout.getEntries();
+
+    int headerSize = sizeof(u32) * 5;
+    for (const ElemLayout::Entry& entry : entries) {
+        headerSize += entry.name.byteLength() + 1 + sizeof(u32) * 2;
+    }
+    int padding = (DATA_ALIGNMENT - headerSize % DATA_ALIGNMENT) % DATA_ALIGNMENT;
+
+    writer.write<u32>(FILE_MAGIC);
+    writer.write<u32>(FILE_VERSION);
+    writer.write<u32>((u32)layout.getPacking());
+    writer.write<u32>((u32)entries.size());
+    for (const ElemLayout::Entry& entry : entries) {
+        writer.write<String>(entry.name);
+        writer.write<u32>((u32)entry.size);
+        writer.write<u32>((u32)entry.arraySize);
+    }
+    writer.write<u32>((u32)getElementCount());
+
+    const byte zeroes[DATA_ALIGNMENT] = { };
+    writer.writeBytes(zeroes, padding);
+    writer.writeBytes(data, size);
+}
+
+void StructuredData::save(const FilePath& file) const {
+    BinaryWriter writer(file);
+    save(writer);
+}
+
+int StructuredData::readHeader(BinaryReader& reader, ElemLayout& layout, int& elemCount) {
+    PGE_ASSERT(reader.read<u32>() == FILE_MAGIC, "Not a StructuredData file");
+    u32 version = reader.read<u32>();
+    // Version 1 predates packing and arrays.
+    PGE_ASSERT(version == 1 || version == FILE_VERSION, "Unsupported StructuredData version (" + String::from(version) + ")");
+
+    int headerSize = sizeof(u32) * 4;
+    ElemLayout::Packing packing = ElemLayout::Packing::TIGHT;
+    if (version >= 2) {
+        u32 packingValue = reader.read<u32>();
+        PGE_ASSERT(packingValue <= (u32)ElemLayout::Packing::VERTEX, "Invalid StructuredData packing (" + String::from(packingValue) + ")");
+        packing = (ElemLayout::Packing)packingValue;
+        headerSize += sizeof(u32);
+    }
+
+    u32 entryCount = reader.read<u32>();
+    std::vector<ElemLayout::Entry> entries;
+    entries.reserve(entryCount);
+    for (u32 i = 0; i < entryCount; i++) {
+        String name = reader.read<String>();
+        u32 entrySize = reader.read<u32>();
+        u32 arraySize = 1;
+        headerSize += name.byteLength() + 1 + sizeof(u32);
+        if (version >= 2) {
+            arraySize = reader.read<u32>();
+            headerSize += sizeof(u32);
+        }
+        entries.emplace_back(name, (int)entrySize, (int)arraySize);
+    }
+    layout = ElemLayout(entries, packing);
+
+    u32 count = reader.read<u32>();
+    PGE_ASSERT((u64)count * layout.getElementSize() <= (u64)std::numeric_limits<int>::max(), "StructuredData is too large");
+    elemCount = (int)count;
+
+    int padding = (DATA_ALIGNMENT - headerSize % DATA_ALIGNMENT) % DATA_ALIGNMENT;
+    reader.skip(padding);
+    return headerSize + padding;
+}
+
+StructuredData StructuredData::load(BinaryReader& reader, const ElemLayout* expectedLayout) {
+    StructuredData ret;
+    int elemCount;
+    readHeader(reader, ret.layout, elemCount);
+    PGE_ASSERT(expectedLayout == nullptr || ret.layout == *expectedLayout, "StructuredData layout doesn't match the expected layout");
+
+    ret.size = ret.layout.getElementSize() * elemCount;
+    ret.capacity = ret.size;
+    ret.markDirty(0, ret.size);
+    ret.ownedData = std::make_unique<byte[]>(ret.size);
+    ret.data = ret.ownedData.get();
+    PGE_ASSERT(reader.tryReadBytes(ret.size, ret.data), "StructuredData is truncated");
+    return ret;
+}
+
+StructuredData StructuredData::load(const FilePath& file, const ElemLayout* expectedLayout, LoadMode mode) {
+    if (mode == LoadMode::READ) {
+        BinaryReader reader(file);
+        return load(reader, expectedLayout);
+    }
+
+    std::shared_ptr<MemoryMappedFile> mapping = std::make_shared<MemoryMappedFile>(file, MemoryMappedFile::Access::COPY_ON_WRITE);
+    BinaryReader reader(mapping->getData(), mapping->getSize());
+
+    StructuredData ret;
+    int elemCount;
+    int headerSize = readHeader(reader, ret.layout, elemCount);
+    PGE_ASSERT(expectedLayout == nullptr || ret.layout == *expectedLayout, "StructuredData layout doesn't match the expected layout (file: " + file.str() + ")");
+
+    ret.size = ret.layout.getElementSize() * elemCount;
+    PGE_ASSERT((size_t)headerSize + ret.size <= mapping->getSize(), "StructuredData is truncated (file: " + file.str() + ")");
+    ret.capacity = ret.size;
+    ret.markDirty(0, ret.size);
+    ret.data = mapping->getWritableData() + headerSize;
+    ret.externalStorage = std::move(mapping);
+    return ret;
+}
+
+StructuredData StructuredData::load(BinaryReader& reader) {
+    return load(reader, nullptr);
+}
+
+StructuredData StructuredData::load(BinaryReader& reader, const ElemLayout& expectedLayout) {
+    return load(reader, &expectedLayout);
+}
+
+StructuredData StructuredData::load(const FilePath& file, LoadMode mode) {
+    return load(file, nullptr, mode);
+}
+
+StructuredData StructuredData::load(const FilePath& file, const ElemLayout& expectedLayout, LoadMode mode) {
+    return load(file, &expectedLayout, mode);
+}
+
 const byte* StructuredData::getData() const {
-    return data.get();
+    return data;
 }
 
 int StructuredData::getDataSize() const {
@@ -89,48 +384,158 @@ const StructuredData::ElemLayout& StructuredData::getLayout() const {
     return layout;
 }
 
+int StructuredData::getCapacity() const {
+    if (layout.getElementSize() <= 0) { return 0; }
+    return capacity / layout.getElementSize();
+}
+
+void StructuredData::reallocate(int newCapacity) {
+    std::unique_ptr<byte[]> newData = std::make_unique<byte[]>(newCapacity);
+    if (size > 0) {
+        memcpy(newData.get(), data, size);
+    }
+    ownedData = std::move(newData);
+    data = ownedData.get();
+    // Everything lives in owned memory now.
+    externalStorage.reset();
+    capacity = newCapacity;
+}
+
+void StructuredData::reserve(int elemCount) {
+    PGE_ASSERT(elemCount >= 0, "Requested a negative element count (" + String::from(elemCount) + ")");
+    PGE_ASSERT((u64)elemCount * layout.getElementSize() <= (u64)std::numeric_limits<int>::max(), "StructuredData is too large");
+    int required = elemCount * layout.getElementSize();
+    if (required <= capacity) { return; }
+    // Geometric growth, so that appending one element at a time is amortized O(1).
+    u64 grown = (u64)capacity * 2;
+    reallocate(grown > (u64)required && grown <= (u64)std::numeric_limits<int>::max() ? (int)grown : required);
+}
+
+void StructuredData::resize(int elemCount) {
+    reserve(elemCount);
+    int newSize = elemCount * layout.getElementSize();
+    if (newSize > size) {
+        memset(data + size, 0, newSize - size);
+        markDirty(size, newSize);
+    }
+    size = newSize;
+}
+
+int StructuredData::append(int count) {
+    PGE_ASSERT(count >= 0, "Requested a negative element count (" + String::from(count) + ")");
+    int first = getElementCount();
+    resize(first + count);
+    return first;
+}
+
+void StructuredData::append(const StructuredData& other) {
+    PGE_ASSERT(layout == other.layout, "Tried appending StructuredData with a different layout");
+    // other may be this.
+    int otherSize = other.size;
+    int first = append(other.getElementCount());
+    memcpy(data + first * layout.getElementSize(), other.data, otherSize);
+}
+
+void StructuredData::replace(int firstElem, const StructuredData& other) {
+    PGE_ASSERT(layout == other.layout, "Tried replacing StructuredData with a different layout");
+    PGE_ASSERT(firstElem >= 0 && firstElem <= getElementCount(),
+        "Element index out of bounds (" + String::from(firstElem) + " > " + String::from(getElementCount()) + ")");
+    if (&other == this) {
+        PGE_ASSERT(firstElem == 0, "Tried replacing StructuredData with an overlapping copy of itself");
+        return;
+    }
+    if (firstElem + other.getElementCount() > getElementCount()) {
+        resize(firstElem + other.getElementCount());
+    }
+    int begin = firstElem * layout.getElementSize();
+    memcpy(data + begin, other.data, other.size);
+    markDirty(begin, begin + other.size);
+}
+
+StructuredData StructuredData::gather(const std::vector<int>& elemIndices) const {
+    StructuredData ret(layout, (int)elemIndices.size());
+    int elemSize = layout.getElementSize();
+    for (int i = 0; i < (int)elemIndices.size(); i++) {
+        int index = elemIndices[i];
+        PGE_ASSERT(index >= 0 && index < getElementCount(),
+            "Element index out of bounds (" + String::from(index) + " >= " + String::from(getElementCount()) + ")");
+        memcpy(ret.data + (size_t)i * elemSize, data + (size_t)index * elemSize, elemSize);
+    }
+    return ret;
+}
+
+void StructuredData::clear() {
+    size = 0;
+}
+
+void StructuredData::erase(int firstElem, int count) {
+    PGE_ASSERT(firstElem >= 0 && count >= 0 && firstElem + count <= getElementCount(),
+        "Element range out of bounds (" + String::from(firstElem) + " + " + String::from(count) + " > " + String::from(getElementCount()) + ")");
+    if (count == 0) { return; }
+    int begin = firstElem * layout.getElementSize();
+    int end = (firstElem + count) * layout.getElementSize();
+    memmove(data + begin, data + end, size - end);
+    markDirty(begin, size - (end - begin));
+    size -= end - begin;
+}
+
+const StructuredData::ByteRange StructuredData::getDirtyRange() const {
+    int end = std::min(dirtyEnd, size);
+    if (dirtyBegin >= end) { return ByteRange(0, 0); }
+    return ByteRange(dirtyBegin, end - dirtyBegin);
+}
+
+bool StructuredData::isDirty() const {
+    return getDirtyRange().size > 0;
+}
+
+void StructuredData::clearDirtyRange() {
+    dirtyBegin = std::numeric_limits<int>::max();
+    dirtyEnd = 0;
+}
+
 void StructuredData::setValue(int elemIndex, const String::Key& entry, float f) {
-    memcpy(data.get() + getDataIndex(elemIndex, entry, sizeof(float)), &f, sizeof(float));
+    memcpy(data + getDataIndex(elemIndex, entry, sizeof(float)), &f, sizeof(float));
 }
 
 void StructuredData::setValue(int elemIndex, const String::Key& entry, u32 u) {
-    memcpy(data.get() + getDataIndex(elemIndex, entry, sizeof(u32)), &u, sizeof(u32));
+    memcpy(data + getDataIndex(elemIndex, entry, sizeof(u32)), &u, sizeof(u32));
 }
 
 void StructuredData::setValue(int elemIndex, const String::Key& entry, const Vector2f& v2f) {
     int dataIndex = getDataIndex(elemIndex, entry, sizeof(float) * 2);
-    memcpy(data.get() + dataIndex, &v2f.x, sizeof(float));
-    memcpy(data.get() + dataIndex + sizeof(float), &v2f.y, sizeof(float));
+    memcpy(data + dataIndex, &v2f.x, sizeof(float));
+    memcpy(data + dataIndex + sizeof(float), &v2f.y, sizeof(float));
 }
 
 void StructuredData::setValue(int elemIndex, const String::Key& entry, const Vector3f& v3f) {
     int dataIndex = getDataIndex(elemIndex, entry, sizeof(float) * 3);
-    memcpy(data.get() + dataIndex, &v3f.x, sizeof(float));
-    memcpy(data.get() + dataIndex + sizeof(float), &v3f.y, sizeof(float));
-    memcpy(data.get() + dataIndex + (sizeof(float) * 2), &v3f.z, sizeof(float));
+    memcpy(data + dataIndex, &v3f.x, sizeof(float));
+    memcpy(data + dataIndex + sizeof(float), &v3f.y, sizeof(float));
+    memcpy(data + dataIndex + (sizeof(float) * 2), &v3f.z, sizeof(float));
 }
 
 void StructuredData::setValue(int elemIndex, const String::Key& entry, const Vector4f& v4f) {
     int dataIndex = getDataIndex(elemIndex, entry, sizeof(float) * 4);
-    memcpy(data.get() + dataIndex, &v4f.x, sizeof(float));
-    memcpy(data.get() + dataIndex + sizeof(float), &v4f.y, sizeof(float));
-    memcpy(data.get() + dataIndex + (sizeof(float) * 2), &v4f.z, sizeof(float));
-    memcpy(data.get() + dataIndex + (sizeof(float) * 3), &v4f.w, sizeof(float));
+    memcpy(data + dataIndex, &v4f.x, sizeof(float));
+    memcpy(data + dataIndex + sizeof(float), &v4f.y, sizeof(float));
+    memcpy(data + dataIndex + (sizeof(float) * 2), &v4f.z, sizeof(float));
+    memcpy(data + dataIndex + (sizeof(float) * 3), &v4f.w, sizeof(float));
 }
 
 void StructuredData::setValue(int elemIndex, const String::Key& entry, const Matrix4x4f& m) {
-    memcpy(data.get() + getDataIndex(elemIndex, entry, sizeof(float) * 4 * 4), m.elements, sizeof(float) * 4 * 4);
+    memcpy(data + getDataIndex(elemIndex, entry, sizeof(float) * 4 * 4), m.elements, sizeof(float) * 4 * 4);
 }
 
 void StructuredData::setValue(int elemIndex, const String::Key& entry, const Color& c) {
     int dataIndex = getDataIndex(elemIndex, entry, sizeof(float) * 4);
-    memcpy(data.get() + dataIndex, &c.red, sizeof(float));
-    memcpy(data.get() + dataIndex + sizeof(float), &c.green, sizeof(float));
-    memcpy(data.get() + dataIndex + (sizeof(float) * 2), &c.blue, sizeof(float));
-    memcpy(data.get() + dataIndex + (sizeof(float) * 3), &c.alpha, sizeof(float));
+    memcpy(data + dataIndex, &c.red, sizeof(float));
+    memcpy(data + dataIndex + sizeof(float), &c.green, sizeof(float));
+    memcpy(data + dataIndex + (sizeof(float) * 2), &c.blue, sizeof(float));
+    memcpy(data + dataIndex + (sizeof(float) * 3), &c.alpha, sizeof(float));
 }
 
-int StructuredData::getDataIndex(int elemIndex, const String::Key& entry, int expectedSize) const {
+int StructuredData::getDataIndex(int elemIndex, const String::Key& entry, int expectedSize) {
     PGE_ASSERT(elemIndex >= 0, "Requested a negative element index (" + String::from(elemIndex) + ")");
 
     int elemOffset = elemIndex * layout.getElementSize();
@@ -143,6 +548,13 @@ int StructuredData::getDataIndex(int elemIndex, const String::Key& entry, int ex
         "Entry \"" + String::hexFromInt(entry.hash) + "\" size mismatch (expected " + String::from(locAndSize.size)
         + ", got " + String::from(expectedSize) + ")");
 
+    markDirty(elemOffset + locAndSize.location, elemOffset + locAndSize.location + expectedSize);
     return elemOffset + locAndSize.location;
 }
 
+
+void StructuredData::assertRange(int firstElem, int count, int stride) const {
+    PGE_ASSERT(stride == layout.getElementSize(), "Accessor belongs to a different layout");
+    PGE_ASSERT(firstElem >= 0 && count >= 0 && firstElem + count <= getElementCount(),
+        "Element range out of bounds (" + String::from(firstElem) + " + " + String::from(count) + " > " + String::from(getElementCount()) + ")");
+}
@@ -0,0 +1,51 @@
+#include "Parallel.h"
+
+#include <thread>
+#include <vector>
+#include <exception>
+#include <mutex>
+#include <algorithm>
+
+using namespace PGE;
+
+int Parallel::getThreadCount() {
+    static const int threadCount = std::max(1, (int)std::thread::hardware_concurrency());
+    return threadCount;
+}
+
+void Parallel::forRange(int count, int minRangeSize, const std::function<void(int begin, int end)>& func) {
+    if (count <= 0) { return; }
+
+    int rangeCount = std::min(getThreadCount(), std::max(1, count / std::max(1, minRangeSize)));
+    if (rangeCount == 1) {
+        func(0, count);
+        return;
+    }
+
+    std::exception_ptr exception;
+    std::mutex exceptionMutex;
+    auto runRange = [&](int index) {
+        int begin = (int)((long long)count * index / rangeCount);
+        int end = (int)((long long)count * (index + 1) / rangeCount);
+        try {
+            func(begin, end);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(exceptionMutex);
+            if (!exception) { exception = std::current_exception(); }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(rangeCount - 1);
+    for (int i = 1; i < rangeCount; i++) {
+        threads.emplace_back(runRange, i);
+    }
+    runRange(0);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
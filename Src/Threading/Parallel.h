@@ -0,0 +1,21 @@
+#ifndef PGEINTERNAL_PARALLEL_H_INCLUDED
+#define PGEINTERNAL_PARALLEL_H_INCLUDED
+
+#include <functional>
+
+namespace PGE {
+
+namespace Parallel {
+    /// Splits [0, count) into contiguous ranges and processes them on multiple threads, the calling thread included.
+    /// Ranges are never smaller than minRangeSize, so small workloads stay on the calling thread.
+    /// 
+    /// Blocks until all ranges have been processed. The first exception thrown by any range is rethrown.
+    void forRange(int count, int minRangeSize, const std::function<void(int begin, int end)>& func);
+
+    /// The amount of threads #forRange distributes work across at most.
+    int getThreadCount();
+}
+
+}
+
+#endif // PGEINTERNAL_PARALLEL_H_INCLUDED
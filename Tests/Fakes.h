@@ -0,0 +1,53 @@
+#ifndef PGETEST_FAKES_H_INCLUDED
+#define PGETEST_FAKES_H_INCLUDED
+
+#include <PGE/Graphics/Graphics.h>
+#include <PGE/Graphics/Mesh.h>
+#include <PGE/Graphics/Shader.h>
+
+// Stand-ins for the renderer specific classes, so tests need neither a window nor a GPU.
+
+namespace PGETest {
+
+// Only enough to create materials.
+class FakeGraphics : public PGE::Graphics {
+    public:
+        FakeGraphics() : Graphics("Test", 1, 1, WindowMode::Windowed) { }
+
+        void swap() override { }
+        void clear(const PGE::Color&) override { }
+        void setRenderTarget(PGE::Texture&) override { }
+        void setRenderTargets(const PGE::ReferenceVector<PGE::Texture>&) override { }
+        void resetRenderTarget() override { }
+        void setViewport(const PGE::Rectanglei&) override { }
+        PGE::String getInfo() const override { return "Fake"; }
+};
+
+class FakeShader : public PGE::Shader {
+    public:
+        FakeShader(const PGE::StructuredData::ElemLayout& layout) : Shader(PGE::FilePath()) {
+            vertexLayout = layout;
+        }
+
+        Constant& getVertexShaderConstant(const PGE::String&) override { throw PGE_CREATE_EX("Fake shaders have no constants"); }
+        Constant& getFragmentShaderConstant(const PGE::String&) override { throw PGE_CREATE_EX("Fake shaders have no constants"); }
+};
+
+// Counts uploads instead of making them, and exposes the CPU copy.
+class FakeMesh : public PGE::Mesh {
+    public:
+        int uploads = 0;
+
+        const PGE::StructuredData& getVertices() const { return vertices; }
+        const std::vector<PGE::u32>& getIndices() const { return indices; }
+
+    private:
+        void uploadInternalData() override { uploads++; }
+        void updateInternalData(const std::optional<PGE::StructuredData::ByteRange>&, const std::optional<IndexRange>&) override { }
+        void renderInternal(RenderState&) override { }
+        void renderInstancedInternal(RenderState&, int, const PGE::StructuredData&) override { }
+};
+
+}
+
+#endif // PGETEST_FAKES_H_INCLUDED
@@ -0,0 +1,122 @@
+#include "Test.h"
+#include "Fakes.h"
+
+#include <algorithm>
+#include <random>
+
+#include <PGE/Graphics/MeshOptimizer.h>
+
+using namespace PGE;
+using namespace PGETest;
+
+namespace {
+
+constexpr int GRID_SIZE = 100;
+
+const StructuredData::ElemLayout& getLayout() {
+    static const StructuredData::ElemLayout layout({ { "position", (int)sizeof(Vector3f) } });
+    return layout;
+}
+
+// A regular grid of quads, each split into two triangles, in row order.
+// Unwelded grids give every quad its own four vertices.
+void createGrid(bool welded, StructuredData& vertices, std::vector<u32>& indices) {
+    std::vector<Vector3f> positions;
+    indices.clear();
+    auto addVertex = [&](int x, int y) {
+        if (welded) { return (u32)(y * (GRID_SIZE + 1) + x); }
+        positions.push_back(Vector3f((float)x, (float)y, 0.f));
+        return (u32)positions.size() - 1;
+    };
+    if (welded) {
+        for (int y = 0; y <= GRID_SIZE; y++) {
+            for (int x = 0; x <= GRID_SIZE; x++) {
+                positions.push_back(Vector3f((float)x, (float)y, 0.f));
+            }
+        }
+    }
+    for (int y = 0; y < GRID_SIZE; y++) {
+        for (int x = 0; x < GRID_SIZE; x++) {
+            u32 a = addVertex(x, y); u32 b = addVertex(x + 1, y);
+            u32 c = addVertex(x, y + 1); u32 d = addVertex(x + 1, y + 1);
+            indices.insert(indices.end(), { a, b, c, b, d, c });
+        }
+    }
+    vertices = StructuredData(getLayout(), (int)positions.size());
+    for (int i = 0; i < (int)positions.size(); i++) {
+        vertices.setValue(i, "position", positions[i]);
+    }
+}
+
+void shuffleTriangles(std::vector<u32>& indices) {
+    std::vector<int> order(indices.size() / 3);
+    for (int i = 0; i < (int)order.size(); i++) { order[i] = i; }
+    std::shuffle(order.begin(), order.end(), std::mt19937(1234));
+    std::vector<u32> shuffled;
+    for (int triangle : order) {
+        shuffled.insert(shuffled.end(), indices.begin() + triangle * 3, indices.begin() + triangle * 3 + 3);
+    }
+    indices = std::move(shuffled);
+}
+
+// The triangles by position, each rotated to start at its smallest corner so the winding is kept, sorted.
+std::vector<std::array<float, 9>> getTriangles(const StructuredData& vertices, const std::vector<u32>& indices) {
+    StructuredData::ElemLayout::Accessor<Vector3f> position = getLayout().getAccessor<Vector3f>(String::Key("position"));
+    std::vector<std::array<float, 9>> triangles;
+    for (int i = 0; i < (int)indices.size(); i += 3) {
+        std::array<Vector3f, 3> corners;
+        for (int j = 0; j < 3; j++) { corners[j] = vertices.getValue(indices[i + j], position); }
+        auto less = [](const Vector3f& a, const Vector3f& b) { return a.x < b.x || a.x == b.x && a.y < b.y; };
+        std::rotate(corners.begin(), std::min_element(corners.begin(), corners.end(), less), corners.end());
+        triangles.push_back({ corners[0].x, corners[0].y, corners[0].z, corners[1].x, corners[1].y, corners[1].z, corners[2].x, corners[2].y, corners[2].z });
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+void testGrid(bool welded, bool shuffled) {
+    StructuredData vertices;
+    std::vector<u32> indices;
+    createGrid(welded, vertices, indices);
+    if (shuffled) { shuffleTriangles(indices); }
+    std::vector<std::array<float, 9>> trianglesBefore = getTriangles(vertices, indices);
+    float acmrBefore = MeshOptimizer::computeACMR(indices);
+
+    MeshOptimizer::Report report = MeshOptimizer::optimize(vertices, indices, Mesh::PrimitiveType::TRIANGLE);
+    PGE_CHECK(report.acmrBefore == acmrBefore);
+    PGE_CHECK(report.acmrAfter == MeshOptimizer::computeACMR(indices));
+    PGE_CHECK(report.acmrAfter < report.acmrBefore);
+    // Row order already reuses most vertices, the optimized order must still beat it clearly.
+    PGE_CHECK(report.acmrAfter < 0.8f);
+    PGE_CHECK(report.verticesAfter == (GRID_SIZE + 1) * (GRID_SIZE + 1));
+    PGE_CHECK(report.bytesAfter <= report.bytesBefore);
+    PGE_CHECK(getTriangles(vertices, indices) == trianglesBefore);
+}
+
+void testMeshOption() {
+    StructuredData vertices;
+    std::vector<u32> indices;
+    createGrid(false, vertices, indices);
+    StructuredData expectedVertices;
+    std::vector<u32> expectedIndices;
+    createGrid(false, expectedVertices, expectedIndices);
+    MeshOptimizer::Report expectedReport = MeshOptimizer::optimize(expectedVertices, expectedIndices, Mesh::PrimitiveType::TRIANGLE);
+
+    FakeMesh mesh;
+    MeshOptimizer::Report report = mesh.setOptimizedGeometry(std::move(vertices), Mesh::PrimitiveType::TRIANGLE, std::move(indices), MeshOptimizer::Options());
+    PGE_CHECK(report.acmrAfter == expectedReport.acmrAfter);
+    PGE_CHECK(mesh.getIndices() == expectedIndices);
+    PGE_CHECK(mesh.getVertices().getElementCount() == expectedVertices.getElementCount());
+}
+
+}
+
+int main() {
+    testGrid(true, false);
+    testGrid(true, true);
+    testGrid(false, false);
+    testGrid(false, true);
+    testMeshOption();
+
+    return PGE_TEST_RESULT;
+}
@@ -0,0 +1,101 @@
+#include "Test.h"
+#include "Fakes.h"
+
+#include <string.h>
+
+#include <PGE/Graphics/Material.h>
+
+using namespace PGE;
+using namespace PGETest;
+
+namespace {
+
+const StructuredData::ElemLayout& getLayout() {
+    static const StructuredData::ElemLayout layout({ { "position", (int)sizeof(Vector3f) }, { "uv", (int)sizeof(Vector2f) } });
+    return layout;
+}
+
+StructuredData createVertices(int count) {
+    StructuredData vertices(getLayout(), count);
+    for (int i = 0; i < count; i++) {
+        vertices.setValue(i, "position", Vector3f((float)(i % 7), (float)(i / 7), 0.f));
+        vertices.setValue(i, "uv", Vector2f((float)(i % 7) / 7.f, 0.5f));
+    }
+    return vertices;
+}
+
+std::vector<u32> createIndices(int vertexCount) {
+    std::vector<u32> indices;
+    for (int i = 0; i + 2 < vertexCount; i++) {
+        indices.insert(indices.end(), { (u32)i, (u32)i + 1, (u32)i + 2 });
+    }
+    return indices;
+}
+
+void setUpMesh(FakeMesh& mesh, Material& material, int vertexCount) {
+    mesh.setMaterial(&material);
+    mesh.setGeometry(createVertices(vertexCount), Mesh::PrimitiveType::TRIANGLE, createIndices(vertexCount));
+}
+
+void testCompressedRoundTrip(Material& material) {
+    FakeMesh mesh;
+    setUpMesh(mesh, material, 100);
+    mesh.setRetention(Mesh::Retention::COMPRESSED);
+    mesh.render();
+    PGE_CHECK(mesh.uploads == 1);
+    PGE_CHECK(mesh.getVertices().getElementCount() == 0);
+
+    mesh.invalidateGpuData();
+    StructuredData expected = createVertices(100);
+    PGE_CHECK(mesh.getVertices().getDataSize() == expected.getDataSize());
+    PGE_CHECK(memcmp(mesh.getVertices().getData(), expected.getData(), expected.getDataSize()) == 0);
+    PGE_CHECK(mesh.getIndices() == createIndices(100));
+    mesh.render();
+    PGE_CHECK(mesh.uploads == 2);
+}
+
+void testDiscardedStaysDiscarded(Material& material) {
+    FakeMesh mesh;
+    setUpMesh(mesh, material, 100);
+    mesh.setRetention(Mesh::Retention::DISCARD);
+    mesh.render();
+    PGE_CHECK(mesh.getVertices().getElementCount() == 0);
+
+    // There's nothing left to compress or keep.
+    PGE_CHECK_THROWS(mesh.setRetention(Mesh::Retention::COMPRESSED));
+    PGE_CHECK_THROWS(mesh.setRetention(Mesh::Retention::KEEP));
+    PGE_CHECK(mesh.getRetention() == Mesh::Retention::DISCARD);
+    PGE_CHECK_THROWS(mesh.invalidateGpuData());
+    PGE_CHECK(mesh.uploads == 1);
+
+    // New geometry can be kept again.
+    mesh.setGeometry(createVertices(10), Mesh::PrimitiveType::TRIANGLE, createIndices(10));
+    mesh.setRetention(Mesh::Retention::COMPRESSED);
+    mesh.render();
+    mesh.invalidateGpuData();
+    PGE_CHECK(mesh.getIndices() == createIndices(10));
+}
+
+void testSwitchingBeforeUpload(Material& material) {
+    FakeMesh mesh;
+    setUpMesh(mesh, material, 100);
+    mesh.setRetention(Mesh::Retention::DISCARD);
+    mesh.setRetention(Mesh::Retention::COMPRESSED);
+    mesh.render();
+    mesh.invalidateGpuData();
+    PGE_CHECK(mesh.getVertices().getElementCount() == 100);
+}
+
+}
+
+int main() {
+    FakeGraphics gfx;
+    FakeShader shader(getLayout());
+    Material material(gfx, shader, { }, Material::Opaque::YES);
+
+    testCompressedRoundTrip(material);
+    testDiscardedStaysDiscarded(material);
+    testSwitchingBeforeUpload(material);
+
+    return PGE_TEST_RESULT;
+}
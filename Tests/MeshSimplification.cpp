@@ -0,0 +1,120 @@
+#include "Test.h"
+
+#include <algorithm>
+#include <math.h>
+
+#include <PGE/Graphics/MeshOptimizer.h>
+
+using namespace PGE;
+using namespace PGETest;
+
+namespace {
+
+constexpr int GRID_SIZE = 60;
+
+const StructuredData::ElemLayout& getLayout() {
+    static const StructuredData::ElemLayout layout({ { "position", (int)sizeof(Vector3f) } });
+    return layout;
+}
+
+// A welded grid of hills, so that every collapse moves the surface a little.
+void createTerrain(StructuredData& vertices, std::vector<u32>& indices) {
+    vertices = StructuredData(getLayout(), (GRID_SIZE + 1) * (GRID_SIZE + 1));
+    for (int y = 0; y <= GRID_SIZE; y++) {
+        for (int x = 0; x <= GRID_SIZE; x++) {
+            float height = 3.f * sinf(x * 0.23f) * cosf(y * 0.17f) + 0.5f * sinf(x * 1.3f + y * 0.7f);
+            vertices.setValue(y * (GRID_SIZE + 1) + x, "position", Vector3f((float)x, (float)y, height));
+        }
+    }
+    indices.clear();
+    for (int y = 0; y < GRID_SIZE; y++) {
+        for (int x = 0; x < GRID_SIZE; x++) {
+            u32 a = y * (GRID_SIZE + 1) + x;
+            u32 c = a + GRID_SIZE + 1;
+            indices.insert(indices.end(), { a, a + 1, c, a + 1, c + 1, c });
+        }
+    }
+}
+
+// Every original triangle's plane is part of the quadric of the vertex its corners were collapsed into,
+// so the reported error is at least the distance of that vertex to the plane.
+float computePlaneError(const StructuredData& vertices, const std::vector<u32>& indices, const std::vector<u32>& remap) {
+    StructuredData::ElemLayout::Accessor<Vector3f> position = getLayout().getAccessor<Vector3f>(String::Key("position"));
+    AABBox bounds = vertices.computeBounds(String::Key("position"));
+    float radius = bounds.getDims().length() * 0.5f;
+    auto getPosition = [&](u32 v) { return (vertices.getValue(v, position) - bounds.getCenter()) / radius; };
+
+    float error = 0.f;
+    for (int i = 0; i < (int)indices.size(); i += 3) {
+        Vector3f a = getPosition(indices[i]);
+        Vector3f normal = (getPosition(indices[i + 1]) - a).crossProduct(getPosition(indices[i + 2]) - a);
+        normal = normal / normal.length();
+        for (int k = 0; k < 3; k++) {
+            error = std::max(error, fabsf(normal.dotProduct(getPosition(remap[indices[i + k]]) - a)));
+        }
+    }
+    return error;
+}
+
+void testErrorBounds() {
+    StructuredData vertices;
+    std::vector<u32> original;
+    createTerrain(vertices, original);
+
+    float previousError = 0.f;
+    for (int target = (int)original.size() / 2; target >= 300; target /= 2) {
+        std::vector<u32> indices = original;
+        std::vector<u32> remap;
+        float error = MeshOptimizer::simplify(vertices, indices, target, MeshOptimizer::SimplifyOptions(), &remap);
+        PGE_CHECK((int)indices.size() <= target);
+        PGE_CHECK(error >= previousError);
+        PGE_CHECK(computePlaneError(vertices, original, remap) <= error + 1e-4f);
+        for (u32 index : indices) {
+            PGE_CHECK(remap[index] == index);
+        }
+        previousError = error;
+    }
+    PGE_CHECK(previousError > 0.f);
+}
+
+void testLodErrors() {
+    StructuredData vertices;
+    std::vector<u32> indices;
+    createTerrain(vertices, indices);
+
+    std::vector<Mesh::Lod> lods = MeshOptimizer::generateLods(vertices, indices, 6);
+    PGE_CHECK(lods.size() == 6);
+    int previousCount = (int)indices.size();
+    float previousError = 0.f;
+    for (const Mesh::Lod& lod : lods) {
+        PGE_CHECK((int)lod.indices.size() < previousCount);
+        PGE_CHECK(lod.error >= previousError);
+        previousCount = (int)lod.indices.size();
+        previousError = lod.error;
+    }
+}
+
+void testMaxError() {
+    StructuredData vertices;
+    std::vector<u32> indices;
+    createTerrain(vertices, indices);
+
+    MeshOptimizer::SimplifyOptions options;
+    options.maxError = 0.01f;
+    std::vector<u32> original = indices;
+    std::vector<u32> remap;
+    float error = MeshOptimizer::simplify(vertices, indices, 0, options, &remap);
+    PGE_CHECK(error <= options.maxError);
+    PGE_CHECK(!indices.empty());
+    PGE_CHECK(computePlaneError(vertices, original, remap) <= error + 1e-4f);
+}
+
+}
+
+int main() {
+    testErrorBounds();
+    testLodErrors();
+    testMaxError();
+
+    return PGE_TEST_RESULT;
+}
@@ -0,0 +1,88 @@
+#include "Test.h"
+
+#include <random>
+
+#include <PGE/Graphics/OcclusionCuller.h>
+#include <PGE/Math/Math.h>
+
+using namespace PGE;
+using namespace PGETest;
+
+namespace {
+
+// Looking down +z from the origin.
+const Matrix4x4f getViewProjection() {
+    return Matrix4x4f::constructPerspectiveMat(Math::degToRad(90.f), 2.f, 0.1f, 100.f)
+        * Matrix4x4f::constructViewMat(Vectors::ZERO3F, Vector3f(0.f, 0.f, 1.f), Vector3f(0.f, 1.f, 0.f));
+}
+
+const AABBox createBox(const Vector3f& center, float halfSize) {
+    AABBox box(center - Vector3f(halfSize, halfSize, halfSize));
+    box.addPoint(center + Vector3f(halfSize, halfSize, halfSize));
+    return box;
+}
+
+// A quad facing the camera at depth z.
+void addQuad(OcclusionCuller& culler, float halfWidth, float halfHeight, float z) {
+    std::vector<Vector3f> positions = {
+        Vector3f(-halfWidth, -halfHeight, z), Vector3f(halfWidth, -halfHeight, z),
+        Vector3f(-halfWidth, halfHeight, z), Vector3f(halfWidth, halfHeight, z),
+    };
+    culler.addOccluder(positions, { 0, 1, 2, 1, 3, 2 }, Matrices::IDENTITY);
+}
+
+void testBehindAndInFront(bool allowParallel) {
+    OcclusionCuller culler;
+    culler.beginFrame(getViewProjection());
+    addQuad(culler, 50.f, 50.f, 10.f);
+    culler.rasterize(allowParallel);
+    PGE_CHECK(culler.getTriangleCount() == 2);
+
+    PGE_CHECK(!culler.isVisible(createBox(Vector3f(0.f, 0.f, 20.f), 1.f)));
+    PGE_CHECK(!culler.isVisible(createBox(Vector3f(3.f, -2.f, 40.f), 5.f)));
+    PGE_CHECK(culler.isVisible(createBox(Vector3f(0.f, 0.f, 5.f), 1.f)));
+    // Reaching through the occluder.
+    PGE_CHECK(culler.isVisible(createBox(Vector3f(0.f, 0.f, 10.f), 1.f)));
+}
+
+void testBatchMatchesSingle(bool allowParallel) {
+    OcclusionCuller culler;
+    culler.beginFrame(getViewProjection());
+    // Small enough that boxes behind it may still be seen around it.
+    addQuad(culler, 4.f, 2.f, 10.f);
+    culler.rasterize(allowParallel);
+
+    // Enough boxes to be split across threads.
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> lateral(-15.f, 15.f);
+    std::uniform_real_distribution<float> depth(2.f, 30.f);
+    std::vector<AABBox> boxes;
+    for (int i = 0; i < 4000; i++) {
+        boxes.push_back(createBox(Vector3f(lateral(random), lateral(random) * 0.5f, depth(random)), 0.5f));
+    }
+
+    std::vector<u64> visible;
+    culler.test(boxes, visible, allowParallel);
+    PGE_CHECK(visible.size() == (boxes.size() + 63) / 64);
+    int visibleCount = 0;
+    int mismatches = 0;
+    for (int i = 0; i < (int)boxes.size(); i++) {
+        bool bit = (visible[i / 64] >> (i % 64) & 1) != 0;
+        if (bit != culler.isVisible(boxes[i])) { mismatches++; }
+        if (bit) { visibleCount++; }
+    }
+    PGE_CHECK(mismatches == 0);
+    // Otherwise the comparison proves little.
+    PGE_CHECK(visibleCount > 0 && visibleCount < (int)boxes.size());
+}
+
+}
+
+int main() {
+    for (bool allowParallel : { false, true }) {
+        testBehindAndInFront(allowParallel);
+        testBatchMatchesSingle(allowParallel);
+    }
+
+    return PGE_TEST_RESULT;
+}
@@ -0,0 +1,25 @@
+#ifndef PGETEST_TEST_H_INCLUDED
+#define PGETEST_TEST_H_INCLUDED
+
+#include <stdio.h>
+
+#include <PGE/Exception/Exception.h>
+
+// Each test is an executable, which reports every failed check and returns PGE_TEST_RESULT from main.
+
+namespace PGETest {
+    inline int failedChecks = 0;
+}
+
+#define PGE_CHECK(COND) \
+    if (!(COND)) { printf("%s:%d: Check failed: %s\n", __FILE__, __LINE__, #COND); PGETest::failedChecks++; }
+
+#define PGE_CHECK_THROWS(EXPR) { \
+        bool thrown = false; \
+        try { EXPR; } catch (const PGE::Exception&) { thrown = true; } \
+        if (!thrown) { printf("%s:%d: Expected an exception from: %s\n", __FILE__, __LINE__, #EXPR); PGETest::failedChecks++; } \
+    }
+
+#define PGE_TEST_RESULT (PGETest::failedChecks == 0 ? 0 : 1)
+
+#endif // PGETEST_TEST_H_INCLUDED
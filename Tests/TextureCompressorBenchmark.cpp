@@ -0,0 +1,79 @@
+#include "Test.h"
+
+#include <algorithm>
+#include <math.h>
+
+#include <PGE/Graphics/TextureCompressor.h>
+
+using namespace PGE;
+using namespace PGETest;
+
+// Prints the PSNR and throughput of every preset on a fixed synthetic texture.
+// Throughput depends on the machine, so only the quality and the report's bookkeeping are checked.
+
+namespace {
+
+constexpr int SIZE = 512;
+// The best of these runs is reported, to filter out noise from the rest of the system.
+constexpr int RUNS = 3;
+
+// Smooth gradients with sharp edges and some noise, opaque.
+std::vector<byte> createTexture() {
+    std::vector<byte> pixels((size_t)SIZE * SIZE * 4);
+    u32 noise = 12345;
+    for (int y = 0; y < SIZE; y++) {
+        for (int x = 0; x < SIZE; x++) {
+            noise = noise * 1664525u + 1013904223u;
+            float wave = sinf(x * 0.05f) * cosf(y * 0.03f);
+            bool stripe = (x / 37 + y / 23) % 2 == 0;
+            byte* pixel = &pixels[((size_t)y * SIZE + x) * 4];
+            pixel[0] = (byte)std::clamp((int)(x * 255 / SIZE + wave * 40.f) + (int)(noise >> 29), 0, 255);
+            pixel[1] = (byte)std::clamp((int)(y * 255 / SIZE) + (stripe ? 60 : 0) - (int)(noise >> 30), 0, 255);
+            pixel[2] = (byte)std::clamp((int)(128.f + wave * 100.f), 0, 255);
+            pixel[3] = 255;
+        }
+    }
+    return pixels;
+}
+
+void benchmark(const std::vector<Texture::Mipmap>& levels, Texture::CompressedFormat fmt, const char* name) {
+    static const char* presets[] = { "FAST", "NORMAL", "HIGH" };
+    double previousPsnr = 0.0;
+    for (int i = 0; i < 3; i++) {
+        TextureCompressor::Options options;
+        options.quality = (TextureCompressor::Quality)i;
+        options.allowParallel = false;
+
+        double seconds = INFINITY;
+        TextureCompressor::Report report;
+        for (int run = 0; run < RUNS; run++) {
+            report = TextureCompressor::compress(levels, fmt, options).getReport();
+            seconds = std::min(seconds, report.seconds);
+        }
+        printf("%s %-6s %5.1f dB %10.0f blocks/s %6.1f Mpix/s\n", name, presets[i], report.psnr,
+            report.blockCount / seconds, report.blockCount * 16 / seconds / 1e6);
+
+        PGE_CHECK(report.blockCount == (u64)(SIZE / 4) * (SIZE / 4));
+        PGE_CHECK(report.bytesAfter == report.blockCount * Texture::getBytesPerBlock(fmt));
+        PGE_CHECK(seconds > 0.0);
+        // Slower presets may not lose quality, give or take rounding.
+        PGE_CHECK(report.psnr >= previousPsnr - 0.05);
+        previousPsnr = report.psnr;
+    }
+    PGE_CHECK(previousPsnr > 30.0);
+}
+
+}
+
+int main() {
+    std::vector<byte> pixels = createTexture();
+    std::vector<Texture::Mipmap> levels = { Texture::Mipmap(SIZE, SIZE, pixels.data(), pixels.size()) };
+
+    benchmark(levels, Texture::CompressedFormat::BC1, "BC1");
+    benchmark(levels, Texture::CompressedFormat::BC3, "BC3");
+    benchmark(levels, Texture::CompressedFormat::BC4, "BC4");
+    benchmark(levels, Texture::CompressedFormat::BC5, "BC5");
+    benchmark(levels, Texture::CompressedFormat::BC7, "BC7");
+
+    return PGE_TEST_RESULT;
+}